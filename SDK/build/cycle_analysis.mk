@@ -2,7 +2,9 @@ EXENAME = cycle_analysis
 
 SOURCES = \
 	../src/cycle_analysis.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/correction_factors.cpp \
+	../src/database.cpp
 
 include common.mk
 
@@ -2,7 +2,8 @@ EXENAME = cycle_analysis_2
 
 SOURCES = \
 	../src/cycle_analysis_2.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp
 
 include common.mk
 
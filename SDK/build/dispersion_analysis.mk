@@ -0,0 +1,11 @@
+EXENAME = dispersion_analysis
+
+SOURCES = \
+	../src/dispersion_analysis.cpp \
+	../src/monte_carlo.cpp \
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/performance_cache.cpp \
+	../src/sweep.cpp
+
+include common.mk
@@ -0,0 +1,13 @@
+EXENAME = engine_deck_generator
+
+SOURCES = \
+	../src/engine_deck_generator.cpp \
+	../src/engine_deck.cpp \
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/flow_separation.cpp \
+	../src/performance_curve.cpp \
+	../src/performance_cache.cpp \
+	../src/sweep.cpp
+
+include common.mk
@@ -2,7 +2,8 @@ EXENAME = example1
 
 SOURCES = \
 	../src/example1.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp
 
 include common.mk
 
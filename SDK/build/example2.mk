@@ -2,7 +2,8 @@ EXENAME = example2
 
 SOURCES = \
 	../src/example2.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp
 
 include common.mk
 
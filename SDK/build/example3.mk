@@ -2,7 +2,9 @@ EXENAME = example3
 
 SOURCES = \
 	../src/example3.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/flow_separation.cpp
 
 include common.mk
 
@@ -2,7 +2,10 @@ EXENAME = example4
 
 SOURCES = \
 	../src/example4.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/flow_separation.cpp \
+	../src/performance_curve.cpp
 
 include common.mk
 
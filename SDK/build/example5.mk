@@ -2,7 +2,9 @@ EXENAME = example5
 
 SOURCES = \
 	../src/example5.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/flow_separation.cpp
 
 include common.mk
 
@@ -2,7 +2,11 @@ EXENAME = example6
 
 SOURCES = \
 	../src/example6.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/correction_factors.cpp \
+	../src/database.cpp \
+	../src/performance_cache.cpp \
+	../src/throttle_schedule.cpp
 
 include common.mk
 
@@ -2,7 +2,9 @@ EXENAME = chamber
 
 SOURCES = \
 	../src/chamber.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/nozzle_contour.cpp
 
 include common.mk
 
@@ -2,7 +2,10 @@ EXENAME = performance1
 
 SOURCES = \
 	../src/performance1.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/mixture_ratio.cpp \
+	../src/performance_cache.cpp
 
 include common.mk
 
@@ -2,7 +2,8 @@ EXENAME = performance2
 
 SOURCES = \
 	../src/performance2.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp
 
 include common.mk
 
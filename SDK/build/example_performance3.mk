@@ -2,7 +2,9 @@ EXENAME = performance3
 
 SOURCES = \
 	../src/performance3.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/correction_factors.cpp \
+	../src/database.cpp
 
 include common.mk
 
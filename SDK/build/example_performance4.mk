@@ -2,7 +2,8 @@ EXENAME = performance4
 
 SOURCES = \
 	../src/performance4.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/database.cpp
 
 include common.mk
 
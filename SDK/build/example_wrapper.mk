@@ -2,7 +2,26 @@ LIBNAME = wrapper
 
 LIBSOURCES = \
 	../src/wrapper.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/correction_factors.cpp \
+	../src/database.cpp \
+	../src/design_optimizer.cpp \
+	../src/engine_deck.cpp \
+	../src/engine_pipeline.cpp \
+	../src/performance_cache.cpp \
+	../src/flow_separation.cpp \
+	../src/freezing_point.cpp \
+	../src/moc_design.cpp \
+	../src/monte_carlo.cpp \
+	../src/nozzle_contour.cpp \
+	../src/nozzle_optimizer.cpp \
+	../src/performance_curve.cpp \
+	../src/sensitivity.cpp \
+	../src/station_table.cpp \
+	../src/surrogate.cpp \
+	../src/thermo_table.cpp \
+	../src/throttle_schedule.cpp \
+	../src/sweep.cpp
 
 EXENAME = wrapper_client
 
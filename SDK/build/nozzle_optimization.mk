@@ -0,0 +1,10 @@
+EXENAME = nozzle_optimization
+
+SOURCES = \
+	../src/nozzle_optimization.cpp \
+	../src/nozzle_optimizer.cpp \
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/performance_cache.cpp
+
+include common.mk
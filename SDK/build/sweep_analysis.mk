@@ -0,0 +1,13 @@
+EXENAME = sweep_analysis
+
+SOURCES = \
+	../src/sweep_analysis.cpp \
+	../src/sweep.cpp \
+	../src/common.cpp \
+	../src/database.cpp \
+	../src/design_optimizer.cpp \
+	../src/performance_cache.cpp \
+	../src/sensitivity.cpp \
+	../src/surrogate.cpp
+
+include common.mk
@@ -2,7 +2,11 @@ EXENAME = thermal_analysis
 
 SOURCES = \
 	../src/thermal_analysis.cpp \
-	../src/common.cpp
+	../src/common.cpp \
+	../src/correction_factors.cpp \
+	../src/engine_pipeline.cpp \
+	../src/database.cpp \
+	../src/performance_cache.cpp
 
 include common.mk
 
@@ -32,6 +32,7 @@
 #include "nozzle/digitized/NozzleContour.hpp"
 
 #include "common.hpp"
+#include "nozzle_contour.hpp"
 
 /**
  * This example calculated geometry of combustion chamber and nozzle.
@@ -78,58 +79,17 @@ int main(int argc, char* argv[]) {
 		performance->solve();
 	}
 
-	if (data->getEngineSize().isThrustSet() || data->getEngineSize().isMdotSet() || data->getEngineSize().isThroatDSet()) {
+	performance::efficiency::CorrectionFactors* correctionFactors = NULL;
 
-		// Design parameters of combustion chamber
-		double b = data->getEngineSize().getChamberGeometry().getContractionAngle() * M_PI / 180.;
-		double R1 = data->getEngineSize().getChamberGeometry().getR1ToRtRatio();
-		double R2 = data->getEngineSize().getChamberGeometry().getR2ToR2maxRatio();
-		double Rn = data->getEngineSize().getChamberGeometry().getRnToRtRatio();
-		double Lstar = data->getEngineSize().getChamberGeometry().getChamberLength();
-		bool isLstar = data->getEngineSize().getChamberGeometry().isCharacteristicLength();
-
-		// Alternatively define parameters directly
-//		double b = 30 * M_PI / 180.;
-//		double R1 = 0.5;
-//		double R2 = 0.5;
-//		double Rn = 0.2;
-//		double Lstar = 1.2;
-//		bool isLstar = true;
-
-
-		bool parabolicNozzle = !data->getEngineSize().getChamberGeometry().isTOC();
-
-		performance::efficiency::CorrectionFactors* correctionFactors = NULL;
-
-		if (applyCorrectionFactor) {
-			// Get performance correction factor
-			correctionFactors = new performance::efficiency::CorrectionFactors(performance);
-		}
+	if (applyCorrectionFactor) {
+		// Get performance correction factor
+		correctionFactors = new performance::efficiency::CorrectionFactors(performance);
+	}
 
+	// Chamber sized and shaped by the configuration, or NULL if the engine size is not defined
+	design::Chamber* chamber = createChamber(performance, correctionFactors);
 
-		design::Chamber* chamber = new design::Chamber(performance, correctionFactors);
-		design::Nozzle* nozzle = NULL;
-
-		if (data->getEngineSize().isThrustSet()) {
-			chamber->setThrust(data->getEngineSize().getThrust(true) / (double)data->getEngineSize().getChambersNo(), data->getEngineSize().getAmbientPressure(true));
-		} else
-		if (data->getEngineSize().isMdotSet()) {
-			chamber->setMdot(data->getEngineSize().getMdot(true) / (double)data->getEngineSize().getChambersNo());
-		} else
-		if (data->getEngineSize().isThroatDSet()) {
-			chamber->setDt(data->getEngineSize().getThroatD(true));
-		}
-
-		chamber->setB(b);
-		chamber->setR1toRt(R1);
-		chamber->setR2toR2max(R2);
-		if (isLstar) {
-			chamber->setLstar(Lstar);
-		} else {
-			// Lstar is actually L'
-			chamber->setLc(Lstar);
-		}
-		chamber->calcGeometry();
+	if (chamber) {
 
 		// Calculate thrust and mass flow rate
 		performance::equilibrium::NozzleSectionConditions* exitSection = dynamic_cast<performance::equilibrium::NozzleSectionConditions*>(performance->getExitSection());
@@ -171,110 +131,30 @@ int main(int argc, char* argv[]) {
 		printf("Dt = %7.2f mm\n", chamber->getDt()*1000.);
 
 
-		if (data->getNozzleFlowOptions().isEfficiencyFactorsSet() && data->getNozzleFlowOptions().getEfficiencyFactors().isConeHalfAngleSet()) {
-			double te = !data->getNozzleFlowOptions().getEfficiencyFactors().isConeHalfAngleSet()?7.5:data->getNozzleFlowOptions().getEfficiencyFactors().getConeHalfAngle();
-
-			nozzle = new design::ConicalNozzle(chamber);
-			static_cast<design::ConicalNozzle*>(nozzle)->calcGeometry(te, Rn);
-
-			printf("Rn = %7.2f mm, Te = %7.2f deg\n", static_cast<design::ConicalNozzle*>(nozzle)->getRn()*1000., te);
-			printf("Le = %7.2f mm", static_cast<design::ConicalNozzle*>(nozzle)->getL()*1000.);
-
-		} else if (data->getEngineSize().getChamberGeometry().isTOC()) {
-			// MOC TIC
-
-			nozzle = new design::MocNozzle(chamber);
-
-			double Tw_bar = data->getEngineSize().getChamberGeometry().isTw_to_T0()?data->getEngineSize().getChamberGeometry().getTwToT0():0.3;
-
-			// TODO: configuration file does not provide this parameter
-			bool fixedAreaAnaLength = true;
-
-			if (data->getEngineSize().getChamberGeometry().isTOC_L()) {
-				double Le_bar = data->getEngineSize().getChamberGeometry().getLe();
-
-				if (fixedAreaAnaLength) {
-					double Fr = chamber->getFre();
-					static_cast<design::MocNozzle*>(nozzle)->calcGeometryAtFixedAreaAndLength(Fr, Le_bar, R1, Rn);
-				} else {
-					static_cast<design::MocNozzle*>(nozzle)->calcGeometryAtFixedLength(Le_bar, R1, Rn, Tw_bar);
-				}
-
-			} else {
-				double Fr = chamber->getFre();
-				static_cast<design::MocNozzle*>(nozzle)->calcGeometryAtFixedArea(Fr, R1, Rn, Tw_bar);
-			}
-
-			double Tn_max = 0;
-			double dt = 0.005;
-			for (double t=0; t<=1.0; t+=dt) {
-				if ((t+dt)>1.0) {
-					t = 1.0;
-				}
-
-				design::moc::Point* p = static_cast<design::MocNozzle*>(nozzle)->getPoint(t);
-				double Tn_t = p->theta();
-				delete p;
-
-				if (Tn_t<Tn_max) {
-					break;
-				}
-				Tn_max = Tn_t;
-			}
-
-			printf("Rn = %7.2f mm, Tn (max) = %7.2f deg\n", Rn*chamber->getDt()*1000., Tn_max*180./M_PI);
-			printf("Le = %7.2f mm, Te = %7.2f deg\n", static_cast<design::MocNozzle*>(nozzle)->getLe()*1000., static_cast<design::MocNozzle*>(nozzle)->getTe());
-
-		} else {
-			// Parabolic nozzle
-
-			reaction::Derivatives *throatDerivatives = performance->getChamber()->getDerivatives(performance::equilibrium::Chamber::THROAT);
-
-			performance::equilibrium::NozzleSectionConditions *exitSection = dynamic_cast<performance::equilibrium::NozzleSectionConditions*>(performance->getExitSection());
-			double Me = exitSection->getMach();
-			double rho_e = exitSection->getRho();
-			double w_e = exitSection->getW();
-			double p_e = exitSection->getP();
-			double k_e = exitSection->getK();
-
-			// Ambient pressure
-			double p_a = 0;
-
-			double mu_e = asin(1./Me);
-
-			// Nozzle initial angle (degrees)
-			double tn = 0.;
-			if (data->getEngineSize().getChamberGeometry().isParabolicInitialAngle()) {
-				tn = data->getEngineSize().getChamberGeometry().getParabolicInitialAngle();
-			} else {
-				// Estimate
-				// Vasiljev, p.352 (10.63)
-				double k = throatDerivatives->getK();
-				double K = sqrt((k+1.)/(k-1.));
-				tn = 60.*( K*atan(sqrt(Me*Me-1.)/K) - atan(Me*Me-1.) ) / M_PI;
-			}
-
-			// Nozzle exit angle (degrees)
-			double te = 0.;
-			if (data->getEngineSize().getChamberGeometry().isParabolicExitAngle()) {
-				te = data->getEngineSize().getChamberGeometry().getParabolicExitAngle();
-			} else {
-				// Estimate
-				// Dobrovolsky p.50 (2.23); Dorofeev, p.343 (28.1)
-				te = 90.*asin(2.*(p_e-p_a)/(rho_e*w_e*w_e*tan(mu_e)))/M_PI;
-				if (te<8.) {
-					te = 8.;
-				}
-			}
-			if (te>tn) {
-				te = 0.9*tn;
-			}
-
-			nozzle = new design::ParabolicNozzle(chamber);
-			static_cast<design::ParabolicNozzle*>(nozzle)->calcGeometry2(tn, te, R1, Rn);
-
-			printf("Rn = %7.2f mm, Tn = %7.2f deg\n", static_cast<design::ParabolicNozzle*>(nozzle)->getRn()*1000., tn);
-			printf("Le = %7.2f mm, Te = %7.2f deg\n", static_cast<design::ParabolicNozzle*>(nozzle)->getL()*1000., te);
+		// Nozzle of the type selected by the configuration: conical, MOC TIC or parabolic
+		design::Nozzle* nozzle = createNozzle(chamber);
+
+		if (design::ConicalNozzle* conicalNozzle = dynamic_cast<design::ConicalNozzle*>(nozzle)) {
+			double te = data->getNozzleFlowOptions().getEfficiencyFactors().getConeHalfAngle();
+
+			printf("Rn = %7.2f mm, Te = %7.2f deg\n", conicalNozzle->getRn()*1000., te);
+			printf("Le = %7.2f mm", conicalNozzle->getL()*1000.);
+
+		} else if (design::MocNozzle* mocNozzle = dynamic_cast<design::MocNozzle*>(nozzle)) {
+			double Rn = data->getEngineSize().getChamberGeometry().getRnToRtRatio();
+
+			NozzleContourSummary contour;
+			getMocNozzleSummary(mocNozzle, contour);
+
+			printf("Rn = %7.2f mm, Tn (max) = %7.2f deg\n", Rn*chamber->getDt()*1000., contour.Tn_max*180./M_PI);
+			printf("Le = %7.2f mm, Te = %7.2f deg\n", contour.Le*1000., contour.Te*180./M_PI);
+
+		} else if (design::ParabolicNozzle* parabolicNozzle = dynamic_cast<design::ParabolicNozzle*>(nozzle)) {
+			double tn, te;
+			getParabolicNozzleAngles(performance, tn, te);
+
+			printf("Rn = %7.2f mm, Tn = %7.2f deg\n", parabolicNozzle->getRn()*1000., tn);
+			printf("Le = %7.2f mm, Te = %7.2f deg\n", parabolicNozzle->getL()*1000., te);
 
 		}
 
@@ -282,12 +162,13 @@ int main(int argc, char* argv[]) {
 
 		delete nozzle;
 		delete chamber;
-		delete correctionFactors;
 
 	} else {
 		printf("Engine size design parameters not defined!\n");
 	}
 
+	delete correctionFactors;
+
 	delete performance;
 	delete data;
 
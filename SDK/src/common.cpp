@@ -20,12 +20,26 @@
  * if you need additional information or have any questions.
  */
 
+#include <cmath>
+
 #include "utils/Util.hpp"
 #include "thermodynamics/input/Input.hpp"
 #include "thermodynamics/thermo/Thermodynamics.hpp"
 #include "thermodynamics/dll/Export.hpp"
 
-void initThermoDatabase() {
+#include "nozzle/ConicalNozzle.hpp"
+#include "nozzle/ParabolicNozzle.hpp"
+#include "nozzle/MocNozzle.hpp"
+
+#include "common.hpp"
+#include "database.hpp"
+
+void initThermoDatabase(unsigned int options) {
+	// Load only the index of species, species themselves are loaded by loadThermoSpecies()
+	if ((options & THERMO_DATABASE_OPTION_LAZY) && initThermoDatabaseIndex()) {
+		return;
+	}
+
 	try {
 		loadThermodynamicsDatabase("resources/thermo.inp", true);
 	} catch (const std::exception& ex) {
@@ -57,5 +71,196 @@ void initThermoDatabase() {
 	}
 }
 
+void loadThermoSpecies(thermo::input::ConfigFile* data) {
+	if (!isThermoDatabaseLazy()) {
+		return;
+	}
+
+	std::vector<std::string> names;
+
+	thermo::input::Propellant& propellant = data->getPropellant();
+	for (int i=0, size=propellant.getOxidizerListSize(); i<size; ++i) {
+		names.push_back(propellant.getOxidizer(i).getName());
+	}
+	for (int i=0, size=propellant.getFuelListSize(); i<size; ++i) {
+		names.push_back(propellant.getFuel(i).getName());
+	}
+	for (int i=0, size=propellant.getSpeciesListSize(); i<size; ++i) {
+		names.push_back(propellant.getSpecies(i).getName());
+	}
+
+	if (data->isChamberCooling()) {
+		for (int i=0, size=data->getChamberCooling().getSectionListSize(); i<size; ++i) {
+			thermo::input::ConvectiveCooling* s = dynamic_cast<thermo::input::ConvectiveCooling*>(&data->getChamberCooling().getSection(i));
+			if (s) {
+				for (int j=0, size2=s->getCoolantListSize(); j<size2; ++j) {
+					names.push_back(s->getCoolant(j).getName());
+				}
+			}
+		}
+		for (int i=0, size=data->getChamberCooling().getFilmSlotsListSize(); i<size; ++i) {
+			for (int j=0, size2=data->getChamberCooling().getFilmSlot(i).getCoolantListSize(); j<size2; ++j) {
+				names.push_back(data->getChamberCooling().getFilmSlot(i).getCoolant(j).getName());
+			}
+		}
+	}
+
+	if (!loadThermoSpecies(names, data->getGeneralOptions().isIons(), data->getGeneralOptions().isMultiphase())) {
+		// Component is defined elsewhere (e.g. in properties.inp), or its elements can't be told apart: load everything
+		util::Log::warnf("THERMO", "Could not select reaction products of the propellant, loading complete database%s", CR);
+		loadAllThermoSpecies();
+	}
+}
+
+void WorkerConfigs::prepare(int threads) {
+	loadThermoSpecies(data);
+
+	if (configs.size()<(size_t)threads) {
+		configs.resize(threads, NULL);
+	}
+}
+
+thermo::input::ConfigFile* WorkerConfigs::get(int worker) {
+	thermo::input::ConfigFile*& config = configs[worker];
+	if (!config) {
+		config = new thermo::input::ConfigFile(*data);
+	}
+	return config;
+}
+
+void WorkerConfigs::clear() {
+	for (size_t i=0; i<configs.size(); ++i) {
+		delete configs[i];
+	}
+	configs.clear();
+}
+
+double getEngineMdot(performance::TheoreticalPerformance* performance, bool applyCorrectionFactors) {
+	performance::efficiency::CorrectionFactors* correctionFactors = NULL;
+	if (applyCorrectionFactors) {
+		correctionFactors = new performance::efficiency::CorrectionFactors(performance);
+	}
 
+	double mdot = 0;
 
+	design::Chamber* chamber = createChamber(performance, correctionFactors);
+	if (chamber) {
+		mdot = chamber->getMdot() * (double)performance->getData()->getEngineSize().getChambersNo();
+	}
+
+	delete chamber;
+	delete correctionFactors;
+
+	return mdot;
+}
+
+design::Chamber* createChamber(performance::TheoreticalPerformance* performance, performance::efficiency::CorrectionFactors* correctionFactors) {
+	thermo::input::ConfigFile* data = performance->getData();
+	if (!data->getEngineSize().isThrustSet() && !data->getEngineSize().isMdotSet() && !data->getEngineSize().isThroatDSet()) {
+		return NULL;
+	}
+
+	design::Chamber* chamber = new design::Chamber(performance, correctionFactors);
+	if (data->getEngineSize().isThrustSet()) {
+		chamber->setThrust(data->getEngineSize().getThrust(true) / (double)data->getEngineSize().getChambersNo(), data->getEngineSize().getAmbientPressure(true));
+	} else
+	if (data->getEngineSize().isMdotSet()) {
+		chamber->setMdot(data->getEngineSize().getMdot(true) / (double)data->getEngineSize().getChambersNo());
+	} else
+	if (data->getEngineSize().isThroatDSet()) {
+		chamber->setDt(data->getEngineSize().getThroatD(true));
+	}
+
+	chamber->setB(data->getEngineSize().getChamberGeometry().getContractionAngle() * M_PI / 180.);
+	chamber->setR1toRt(data->getEngineSize().getChamberGeometry().getR1ToRtRatio());
+	chamber->setR2toR2max(data->getEngineSize().getChamberGeometry().getR2ToR2maxRatio());
+	if (data->getEngineSize().getChamberGeometry().isCharacteristicLength()) {
+		chamber->setLstar(data->getEngineSize().getChamberGeometry().getChamberLength());
+	} else {
+		// Lstar is actually L'
+		chamber->setLc(data->getEngineSize().getChamberGeometry().getChamberLength());
+	}
+	chamber->calcGeometry();
+
+	return chamber;
+}
+
+void getParabolicNozzleAngles(performance::TheoreticalPerformance* performance, double& tn, double& te) {
+	thermo::input::ConfigFile* data = performance->getData();
+
+	reaction::Derivatives* throatDerivatives = performance->getChamber()->getDerivatives(performance::equilibrium::Chamber::THROAT);
+
+	performance::equilibrium::NozzleSectionConditions* exitSection = dynamic_cast<performance::equilibrium::NozzleSectionConditions*>(performance->getExitSection());
+	double Me = exitSection->getMach();
+	double rho_e = exitSection->getRho();
+	double w_e = exitSection->getW();
+	double p_e = exitSection->getP();
+
+	// Ambient pressure
+	double p_a = 0;
+
+	double mu_e = asin(1./Me);
+
+	// Nozzle initial angle (degrees)
+	if (data->getEngineSize().getChamberGeometry().isParabolicInitialAngle()) {
+		tn = data->getEngineSize().getChamberGeometry().getParabolicInitialAngle();
+	} else {
+		// Vasiljev, p.352 (10.63)
+		double k = throatDerivatives->getK();
+		double K = sqrt((k+1.)/(k-1.));
+		tn = 60.*( K*atan(sqrt(Me*Me-1.)/K) - atan(Me*Me-1.) ) / M_PI;
+	}
+
+	// Nozzle exit angle (degrees)
+	if (data->getEngineSize().getChamberGeometry().isParabolicExitAngle()) {
+		te = data->getEngineSize().getChamberGeometry().getParabolicExitAngle();
+	} else {
+		// Dobrovolsky p.50 (2.23); Dorofeev, p.343 (28.1)
+		te = 90.*asin(2.*(p_e-p_a)/(rho_e*w_e*w_e*tan(mu_e)))/M_PI;
+		if (te<8.) {
+			te = 8.;
+		}
+	}
+	if (te>tn) {
+		te = 0.9*tn;
+	}
+}
+
+design::Nozzle* createNozzle(design::Chamber* chamber) {
+	performance::TheoreticalPerformance* performance = chamber->getPerformance();
+	thermo::input::ConfigFile* data = performance->getData();
+
+	double R1 = data->getEngineSize().getChamberGeometry().getR1ToRtRatio();
+	double Rn = data->getEngineSize().getChamberGeometry().getRnToRtRatio();
+
+	if (data->getNozzleFlowOptions().isEfficiencyFactorsSet() && data->getNozzleFlowOptions().getEfficiencyFactors().isConeHalfAngleSet()) {
+		double te = data->getNozzleFlowOptions().getEfficiencyFactors().getConeHalfAngle();
+
+		design::ConicalNozzle* nozzle = new design::ConicalNozzle(chamber);
+		nozzle->calcGeometry(te, Rn);
+		return nozzle;
+	}
+
+	if (data->getEngineSize().getChamberGeometry().isTOC()) {
+		// MOC TIC
+		design::MocNozzle* nozzle = new design::MocNozzle(chamber);
+
+		double Tw_bar = data->getEngineSize().getChamberGeometry().isTw_to_T0()?data->getEngineSize().getChamberGeometry().getTwToT0():0.3;
+		double Fr = chamber->getFre();
+
+		if (data->getEngineSize().getChamberGeometry().isTOC_L()) {
+			nozzle->calcGeometryAtFixedAreaAndLength(Fr, data->getEngineSize().getChamberGeometry().getLe(), R1, Rn);
+		} else {
+			nozzle->calcGeometryAtFixedArea(Fr, R1, Rn, Tw_bar);
+		}
+		return nozzle;
+	}
+
+	// Parabolic nozzle
+	double tn, te;
+	getParabolicNozzleAngles(performance, tn, te);
+
+	design::ParabolicNozzle* nozzle = new design::ParabolicNozzle(chamber);
+	nozzle->calcGeometry2(tn, te, R1, Rn);
+	return nozzle;
+}
@@ -23,6 +23,101 @@
 #ifndef EXAMPLES_COMMON_HPP_
 #define EXAMPLES_COMMON_HPP_
 
-extern void initThermoDatabase();
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "database.hpp"
+
+/**
+ * Loads thermodynamics database.
+ *
+ * @param options combination of ThermoDatabaseOption flags (see database.hpp)
+ */
+extern void initThermoDatabase(unsigned int options = 0);
+
+/**
+ * Loads the species used by given configuration (propellant components and coolants), and all the possible
+ * reaction products, if the database has been initialized with option THERMO_DATABASE_OPTION_LAZY.
+ * If any of the components is not found in thermo.inp, or reaction products could not be selected, the complete
+ * database is loaded.
+ * Has to be called after the configuration is read, and before the analysis is started;
+ * it must not be called while performance is being solved on other threads.
+ */
+extern void loadThermoSpecies(thermo::input::ConfigFile* data);
+
+/**
+ * Copies of the configuration, one per worker thread of ThreadPool, so that the workers can modify and solve them
+ * without locking. Copies are created on the first use by the worker, and deleted by clear() or the destructor.
+ */
+class WorkerConfigs {
+private:
+	thermo::input::ConfigFile* data;
+	std::vector<thermo::input::ConfigFile*> configs;
+
+	WorkerConfigs(const WorkerConfigs&);
+	WorkerConfigs& operator=(const WorkerConfigs&);
+
+public:
+	/**
+	 * @param data configuration to copy; must exist as long as this object is used
+	 */
+	explicit WorkerConfigs(thermo::input::ConfigFile* data) :
+		data(data) {
+	}
+
+	~WorkerConfigs() {
+		clear();
+	}
+
+	/**
+	 * Loads the species used by the configuration (see loadThermoSpecies()), which has to be done before the solvers
+	 * are started in parallel, and reserves the copies for given number of workers.
+	 * Must be called before ThreadPool::run().
+	 */
+	void prepare(int threads);
+
+	/**
+	 * Returns the copy of the worker; the copy is created on the first call.
+	 */
+	thermo::input::ConfigFile* get(int worker);
+
+	/**
+	 * Deletes the copies, so that the next get() copies the current state of the configuration.
+	 */
+	void clear();
+};
+
+/**
+ * Returns the mass flow rate (kg/s) of all the chambers of the engine sized by the configuration
+ * (thrust, mass flow rate or throat diameter), or 0 if the size is not defined.
+ *
+ * @param applyCorrectionFactors if true, size the chamber with the performance correction factors
+ */
+extern double getEngineMdot(performance::TheoreticalPerformance* performance, bool applyCorrectionFactors);
+
+/**
+ * Creates the chamber sized by the configuration, with the geometry of the configuration (contraction angle,
+ * R1, R2 and characteristic or cylinder length), or returns NULL if the size is not defined.
+ *
+ * @param correctionFactors performance correction factors, or NULL; must exist as long as the chamber is used
+ */
+extern design::Chamber* createChamber(performance::TheoreticalPerformance* performance, performance::efficiency::CorrectionFactors* correctionFactors);
+
+/**
+ * Returns the initial and exit angles (degrees) of the parabolic nozzle: the angles of the configuration if set,
+ * otherwise the estimates from the throat and exit conditions. The exit angle is limited to 0.9 of the initial one.
+ */
+extern void getParabolicNozzleAngles(performance::TheoreticalPerformance* performance, double& tn, double& te);
+
+/**
+ * Creates the nozzle of the type and geometry given by the configuration: conical if the cone half angle is set,
+ * MOC if the truncated ideal contour is selected, and parabolic otherwise.
+ *
+ * @return nozzle, which must be deleted by the caller
+ */
+extern design::Nozzle* createNozzle(design::Chamber* chamber);
 
 #endif /* EXAMPLES_COMMON_HPP_ */
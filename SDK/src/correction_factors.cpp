@@ -0,0 +1,115 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "correction_factors.hpp"
+#include "database.hpp"
+
+static uint64_t hashValue(double value, uint64_t checksum) {
+	// +0 and -0 are the same input
+	if (0==value) {
+		value = 0;
+	}
+	return fnv1a(&value, sizeof(value), checksum);
+}
+
+static uint64_t hashFlag(bool value, uint64_t checksum) {
+	unsigned char b = value ? 1 : 0;
+	return fnv1a(&b, sizeof(b), checksum);
+}
+
+uint64_t getEfficiencyFactorsKey(thermo::input::ConfigFile* data) {
+	uint64_t checksum = fnv1a(NULL, 0);
+
+	thermo::input::NozzleFlowOptions& flowOptions = data->getNozzleFlowOptions();
+	checksum = hashFlag(flowOptions.isEfficiencyFactorsSet(), checksum);
+	if (flowOptions.isEfficiencyFactorsSet()) {
+		thermo::input::EfficiencyFactors& factors = flowOptions.getEfficiencyFactors();
+		checksum = hashFlag(factors.isApplyEfficiencyFactors(), checksum);
+		checksum = hashFlag(factors.isReactionEfficiencySet(), checksum);
+		checksum = hashValue(factors.isReactionEfficiencySet() ? factors.getReactionEfficiency() : 0, checksum);
+		checksum = hashFlag(factors.isNozzleEfficiencySet(), checksum);
+		checksum = hashValue(factors.isNozzleEfficiencySet() ? factors.getNozzleEfficiency() : 0, checksum);
+		checksum = hashFlag(factors.isCycleEfficiencySet(), checksum);
+		checksum = hashValue(factors.isCycleEfficiencySet() ? factors.getCycleEfficiency() : 0, checksum);
+		checksum = hashFlag(factors.isNozzleLengthSet(), checksum);
+		checksum = hashValue(factors.isNozzleLengthSet() ? factors.getNozzleLength() : 0, checksum);
+		checksum = hashFlag(factors.isConeHalfAngleSet(), checksum);
+		checksum = hashValue(factors.isConeHalfAngleSet() ? factors.getConeHalfAngle() : 0, checksum);
+	}
+
+	return checksum;
+}
+
+CorrectionFactorsCache::CorrectionFactorsCache(performance::TheoreticalPerformance* performance) :
+	performance(performance), correctionFactors(NULL), throttle(1.0), phi(1.0), factorsKey(0), evaluations(0) {
+}
+
+CorrectionFactorsCache::~CorrectionFactorsCache() {
+	delete correctionFactors;
+}
+
+void CorrectionFactorsCache::attach(performance::TheoreticalPerformance* performance) {
+	if (performance!=this->performance) {
+		invalidate();
+		this->performance = performance;
+	}
+}
+
+void CorrectionFactorsCache::update(double throttle) {
+	if (throttle!=this->throttle) {
+		invalidate();
+		this->throttle = throttle;
+	}
+}
+
+void CorrectionFactorsCache::invalidate() {
+	delete correctionFactors;
+	correctionFactors = NULL;
+}
+
+void CorrectionFactorsCache::calculate() {
+	if (correctionFactors && getEfficiencyFactorsKey(performance->getData())!=factorsKey) {
+		// Efficiency factors of the configuration have been changed
+		invalidate();
+	}
+	if (!correctionFactors && performance) {
+		factorsKey = getEfficiencyFactorsKey(performance->getData());
+		correctionFactors = new performance::efficiency::CorrectionFactors(performance);
+		phi = correctionFactors->getOverallEfficiency();
+		++evaluations;
+	}
+}
+
+performance::efficiency::CorrectionFactors* CorrectionFactorsCache::getCorrectionFactors() {
+	calculate();
+	return correctionFactors;
+}
+
+double CorrectionFactorsCache::getOverallEfficiency() {
+	calculate();
+	return correctionFactors ? phi : 1.0;
+}
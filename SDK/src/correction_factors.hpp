@@ -0,0 +1,108 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_CORRECTION_FACTORS_HPP_
+#define EXAMPLES_CORRECTION_FACTORS_HPP_
+
+#include <stdint.h>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+/**
+ * Returns the fingerprint of the efficiency factors of the configuration (reaction, nozzle and cycle efficiency,
+ * nozzle length and cone half angle), i.e. of the inputs of CorrectionFactors other than the solved problem.
+ */
+extern uint64_t getEfficiencyFactorsKey(thermo::input::ConfigFile* data);
+
+/**
+ * Performance correction factors bound to one performance object.
+ *
+ * CorrectionFactors is created on the first query, and again only after the solution it has been calculated for
+ * has changed: after attach() to other object, update() with other throttle value, or invalidate(); or after the
+ * efficiency factors of the configuration have been changed (see getEfficiencyFactorsKey()). Other queries
+ * return the stored values. The factors don't depend on ambient pressure, so the queries at different ambient
+ * pressures share one calculation.
+ */
+class CorrectionFactorsCache {
+private:
+	performance::TheoreticalPerformance* performance;
+	performance::efficiency::CorrectionFactors* correctionFactors;
+
+	double throttle;				// throttle value the factors have been calculated for
+	double phi;
+	uint64_t factorsKey;			// efficiency factors the factors have been calculated for
+	int evaluations;
+
+	void calculate();
+
+	CorrectionFactorsCache(const CorrectionFactorsCache&);
+	CorrectionFactorsCache& operator=(const CorrectionFactorsCache&);
+
+public:
+	/**
+	 * @param performance solved problem, or NULL to attach it later
+	 */
+	explicit CorrectionFactorsCache(performance::TheoreticalPerformance* performance = NULL);
+
+	~CorrectionFactorsCache();
+
+	/**
+	 * Binds to the performance object. The factors are kept if it's the same object.
+	 */
+	void attach(performance::TheoreticalPerformance* performance);
+
+	/**
+	 * Must be called after the bound problem has been throttled (see ThrottlingPerformance::throttle());
+	 * the factors are recalculated on the next query only if the value has changed.
+	 */
+	void update(double throttle);
+
+	/**
+	 * Must be called after the bound problem has been re-solved in any other way.
+	 */
+	void invalidate();
+
+	performance::TheoreticalPerformance* getPerformance() const {
+		return performance;
+	}
+
+	/**
+	 * Returns the correction factors of the current solution (NULL if not attached); owned by this object,
+	 * valid until the solution changes.
+	 */
+	performance::efficiency::CorrectionFactors* getCorrectionFactors();
+
+	/**
+	 * Returns overall performance correction factor of the current solution (1 if not attached).
+	 */
+	double getOverallEfficiency();
+
+	/**
+	 * Returns the number of CorrectionFactors objects calculated so far.
+	 */
+	int getEvaluationsNo() const {
+		return evaluations;
+	}
+};
+
+#endif /* EXAMPLES_CORRECTION_FACTORS_HPP_ */
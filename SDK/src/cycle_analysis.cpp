@@ -54,6 +54,7 @@
 
 
 #include "common.hpp"
+#include "correction_factors.hpp"
 
 struct ChamberMassFlowRate {
 	double mdot;
@@ -142,7 +143,8 @@ struct RPAData {
 	thermo::input::ConfigFile* data;
 	performance::TheoreticalPerformance* performance;
 	performance::ThrottlingPerformance* throttlingPerformance;
-	performance::efficiency::CorrectionFactors* correctionFactors;
+	CorrectionFactorsCache efficiency;
+	performance::efficiency::CorrectionFactors* correctionFactors;		// owned by efficiency
 	design::Chamber* chamber;
 	design::Nozzle* nozzle;
 	ChamberMassFlowRate* chamberMassFlowRate;
@@ -162,6 +164,9 @@ struct RPAData {
 
 		// Read configuration file
 		data->read();
+
+		// Load species of the propellant and reaction products
+		loadThermoSpecies(data);
 	}
 
 	~RPAData() {
@@ -171,7 +176,6 @@ struct RPAData {
 		delete chamberMassFlowRate;
 		delete nozzle;
 		delete chamber;
-		delete correctionFactors;
 		delete throttlingPerformance;
 		delete performance;
 		delete data;
@@ -183,6 +187,8 @@ struct RPAData {
 
 		// Initialize performance solver
 		performance = new performance::TheoreticalPerformance(data, false);
+		efficiency.attach(performance);
+		efficiency.invalidate();
 
 
 		if (optimizePropellant && thermo::input::Ratio::fractions!=data->getPropellant().getRatioType()) {
@@ -202,56 +208,13 @@ struct RPAData {
 		chamber = 0;
 		nozzle = 0;
 
-		if (data->getEngineSize().isThrustSet() || data->getEngineSize().isMdotSet() || data->getEngineSize().isThroatDSet()) {
-
-			// Design parameters of combustion chamber
-			double b = data->getEngineSize().getChamberGeometry().getContractionAngle() * M_PI / 180.;
-			double R1 = data->getEngineSize().getChamberGeometry().getR1ToRtRatio();
-			double R2 = data->getEngineSize().getChamberGeometry().getR2ToR2maxRatio();
-			double Rn = data->getEngineSize().getChamberGeometry().getRnToRtRatio();
-			double Lstar = data->getEngineSize().getChamberGeometry().getChamberLength();
-			bool isLstar = data->getEngineSize().getChamberGeometry().isCharacteristicLength();
-
-
-			bool parabolicNozzle = !data->getEngineSize().getChamberGeometry().isTOC();
-
-			if (!correctionFactors && applyCorrectionFactor) {
-				// Get performance correction factor
-				correctionFactors = new performance::efficiency::CorrectionFactors(performance);
-			}
-
-			chamber = new design::Chamber(performance, correctionFactors);
-
-			if (data->getEngineSize().isThrustSet()) {
-				chamber->setThrust(data->getEngineSize().getThrust(true) / (double)data->getEngineSize().getChambersNo(), data->getEngineSize().getAmbientPressure(true));
-			} else
-			if (data->getEngineSize().isMdotSet()) {
-				chamber->setMdot(data->getEngineSize().getMdot(true) / (double)data->getEngineSize().getChambersNo());
-			} else
-			if (data->getEngineSize().isThroatDSet()) {
-				chamber->setDt(data->getEngineSize().getThroatD(true));
-			}
-
-			chamber->setB(b);
-			chamber->setR1toRt(R1);
-			chamber->setR2toR2max(R2);
-			if (isLstar) {
-				chamber->setLstar(Lstar);
-			} else {
-				// Lstar is actually L'
-				chamber->setLc(Lstar);
-			}
-			chamber->calcGeometry();
-
-			// Calculate thrust and mass flow rate
-			performance::equilibrium::NozzleSectionConditions* exitSection = dynamic_cast<performance::equilibrium::NozzleSectionConditions*>(performance->getExitSection());
+		// Get performance correction factor
+		correctionFactors = applyCorrectionFactor ? efficiency.getCorrectionFactors() : 0;
 
-			double Is_v = exitSection->getIs_v();
-			if (correctionFactors) {
-				Is_v *= correctionFactors->getOverallEfficiency();
-			}
-			double Is_opt = Is_v - exitSection->getF()*exitSection->getP();
+		// Chamber sized and shaped by the configuration, or NULL if the engine size is not defined
+		chamber = createChamber(performance, correctionFactors);
 
+		if (chamber) {
 			delete chamberMassFlowRate;
 			chamberMassFlowRate = new ChamberMassFlowRate();
 
@@ -259,86 +222,8 @@ struct RPAData {
 			chamberMassFlowRate->mdot_ox = chamber->getMdotOx();
 			chamberMassFlowRate->mdot_f = chamber->getMdotF();
 
-			double F_opt = Is_opt*chamberMassFlowRate->mdot;
-			double F_v = Is_v*chamberMassFlowRate->mdot;
-
-			if (data->getNozzleFlowOptions().isEfficiencyFactorsSet() && data->getNozzleFlowOptions().getEfficiencyFactors().isConeHalfAngleSet()) {
-				double te = !data->getNozzleFlowOptions().getEfficiencyFactors().isConeHalfAngleSet()?7.5:data->getNozzleFlowOptions().getEfficiencyFactors().getConeHalfAngle();
-
-				nozzle = new design::ConicalNozzle(chamber);
-				static_cast<design::ConicalNozzle*>(nozzle)->calcGeometry(te, Rn);
-
-			} else if (data->getEngineSize().getChamberGeometry().isTOC()) {
-				// MOC TIC
-
-				nozzle = new design::MocNozzle(chamber);
-
-				double Tw_bar = data->getEngineSize().getChamberGeometry().isTw_to_T0()?data->getEngineSize().getChamberGeometry().getTwToT0():0.3;
-
-				// TODO: configuration file does not provide this parameter
-				bool fixedAreaAnaLength = true;
-
-				if (data->getEngineSize().getChamberGeometry().isTOC_L()) {
-					double Le_bar = data->getEngineSize().getChamberGeometry().getLe();
-
-					if (fixedAreaAnaLength) {
-						double Fr = chamber->getFre();
-						static_cast<design::MocNozzle*>(nozzle)->calcGeometryAtFixedAreaAndLength(Fr, Le_bar, R1, Rn);
-					} else {
-						static_cast<design::MocNozzle*>(nozzle)->calcGeometryAtFixedLength(Le_bar, R1, Rn, Tw_bar);
-					}
-
-				} else {
-					double Fr = chamber->getFre();
-					static_cast<design::MocNozzle*>(nozzle)->calcGeometryAtFixedArea(Fr, R1, Rn, Tw_bar);
-				}
-
-			} else {
-				// Parabolic nozzle
-
-				reaction::Derivatives *throatDerivatives = performance->getChamber()->getDerivatives(performance::equilibrium::Chamber::THROAT);
-
-				performance::equilibrium::NozzleSectionConditions *exitSection = dynamic_cast<performance::equilibrium::NozzleSectionConditions*>(performance->getExitSection());
-				double Me = exitSection->getMach();
-				double rho_e = exitSection->getRho();
-				double w_e = exitSection->getW();
-				double p_e = exitSection->getP();
-				double k_e = exitSection->getK();
-
-				// Ambient pressure
-				double p_a = 0;
-
-				double mu_e = asin(1./Me);
-
-				// Nozzle initial angle (degrees)
-				double tn = 0.;
-				if (data->getEngineSize().getChamberGeometry().isParabolicInitialAngle()) {
-					tn = data->getEngineSize().getChamberGeometry().getParabolicInitialAngle();
-				} else {
-					double k = throatDerivatives->getK();
-					double K = sqrt((k+1.)/(k-1.));
-					tn = 60.*( K*atan(sqrt(Me*Me-1.)/K) - atan(Me*Me-1.) ) / M_PI;
-				}
-
-				// Nozzle exit angle (degrees)
-				double te = 0.;
-				if (data->getEngineSize().getChamberGeometry().isParabolicExitAngle()) {
-					te = data->getEngineSize().getChamberGeometry().getParabolicExitAngle();
-				} else {
-					te = 90.*asin(2.*(p_e-p_a)/(rho_e*w_e*w_e*tan(mu_e)))/M_PI;
-					if (te<8.) {
-						te = 8.;
-					}
-				}
-				if (te>tn) {
-					te = 0.9*tn;
-				}
-
-				nozzle = new design::ParabolicNozzle(chamber);
-				static_cast<design::ParabolicNozzle*>(nozzle)->calcGeometry2(tn, te, R1, Rn);
-
-			}
-
+			// Nozzle of the type selected by the configuration: conical, MOC TIC or parabolic
+			nozzle = createNozzle(chamber);
 		}
 
 	}
@@ -938,12 +823,8 @@ struct RPAData {
 
 		performance::equilibrium::NozzleSectionConditions *overexpExitSection = performance->getOverExpansionSection();
 
-		double phi =  1.0;
-		performance::efficiency::CorrectionFactors* correctionFactors = getCorrectionFactors(performance);
-		if (correctionFactors) {
-			phi = correctionFactors->getOverallEfficiency();
-			delete correctionFactors;
-		}
+		// Calculated once per solution of the chamber
+		double phi = efficiency.getOverallEfficiency();
 
 		cyclePerformance->Is_c_v = exitSection->getIs_v() * phi;
 		cyclePerformance->Is_c_opt = cyclePerformance->Is_c_v - exitSection->getF()*exitSection->getP();
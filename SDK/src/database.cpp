@@ -0,0 +1,916 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "database.hpp"
+
+/**
+ * Source databases, in the order they have to be loaded.
+ */
+static const struct {
+	const char* name;
+	ThermoDatabaseType type;
+} thermoDatabaseSources[] = {
+	{"thermo.inp", THERMO_DATABASE_THERMO},
+	{"usr_thermo.inp", THERMO_DATABASE_USR_THERMO},
+	{"properties.inp", THERMO_DATABASE_PROPERTIES},
+	{"usr_properties.inp", THERMO_DATABASE_PROPERTIES},
+	{"trans.inp", THERMO_DATABASE_TRANSPORT}
+};
+
+static const unsigned int thermoDatabaseSourcesNo = sizeof(thermoDatabaseSources)/sizeof(thermoDatabaseSources[0]);
+
+//*****************************************************************************
+
+MappedFile::MappedFile() :
+	data(NULL), size(0),
+#ifdef _WIN32
+	hFile(INVALID_HANDLE_VALUE), hMapping(NULL)
+#else
+	fd(-1)
+#endif
+	{
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const char* path) {
+	close();
+
+#ifdef _WIN32
+	hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE==hFile) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || 0==fileSize.QuadPart) {
+		close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+
+	hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hMapping) {
+		close();
+		return false;
+	}
+
+	data = (const char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		close();
+		return false;
+	}
+#else
+	fd = ::open(path, O_RDONLY);
+	if (fd<0) {
+		return false;
+	}
+
+	struct stat st;
+	if (0!=fstat(fd, &st) || 0==st.st_size) {
+		close();
+		return false;
+	}
+	size = (size_t)st.st_size;
+
+	void* p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (MAP_FAILED==p) {
+		close();
+		return false;
+	}
+	data = (const char*)p;
+#endif
+
+	return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (hMapping) {
+		CloseHandle(hMapping);
+	}
+	if (INVALID_HANDLE_VALUE!=hFile) {
+		CloseHandle(hFile);
+	}
+	hMapping = NULL;
+	hFile = INVALID_HANDLE_VALUE;
+#else
+	if (data) {
+		munmap((void*)data, size);
+	}
+	if (fd>=0) {
+		::close(fd);
+	}
+	fd = -1;
+#endif
+	data = NULL;
+	size = 0;
+}
+
+//*****************************************************************************
+
+uint64_t fnv1a(const void* buffer, size_t size, uint64_t checksum) {
+	const unsigned char* p = (const unsigned char*)buffer;
+	for (size_t i=0; i<size; ++i) {
+		checksum ^= p[i];
+		checksum *= 1099511628211ULL;
+	}
+	return checksum;
+}
+
+static bool getFileStat(const std::string& path, uint64_t& size, int64_t& mtime) {
+	struct stat st;
+	if (0!=stat(path.c_str(), &st)) {
+		return false;
+	}
+	size = (uint64_t)st.st_size;
+	mtime = (int64_t)st.st_mtime;
+	return true;
+}
+
+bool makeDirectory(const char* path) {
+	struct stat st;
+	if (0==stat(path, &st)) {
+		return 0!=(st.st_mode & S_IFDIR);
+	}
+#ifdef _WIN32
+	return 0==_mkdir(path);
+#else
+	return 0==mkdir(path, 0755);
+#endif
+}
+
+/**
+ * Loads one database file using the loader of the thermodynamics library.
+ * Throws an exception if the file could not be loaded.
+ */
+static void loadThermoDatabaseFile(ThermoDatabaseType type, const char* path) {
+	switch (type) {
+	case THERMO_DATABASE_THERMO:
+		loadThermodynamicsDatabase(path, true);
+		break;
+	case THERMO_DATABASE_USR_THERMO:
+		loadThermodynamicsDatabase(path, false);
+		break;
+	case THERMO_DATABASE_PROPERTIES:
+		loadPropertiesDatabase(path);
+		break;
+	case THERMO_DATABASE_TRANSPORT:
+		loadTransportPropertiesDatabase(path);
+		break;
+	}
+}
+
+//*****************************************************************************
+
+/**
+ * Record of thermo.inp or trans.inp, located in the memory-mapped database.
+ */
+struct ThermoDatabaseRecord {
+	std::string name;
+	std::string name2;					// second species of the binary interaction (trans.inp only)
+	std::vector<std::string> elements;
+	bool reactant;						// record is located after "END PRODUCTS"
+	bool condensed;
+	bool ion;
+	size_t offset;
+	size_t length;
+	bool loaded;
+	ThermoElementMask mask;
+};
+
+/**
+ * Index of the memory-mapped database.
+ */
+struct ThermoDatabaseIndex {
+	MappedFile file;
+	const char* data;					// text of the database (mapped file)
+	size_t size;
+	std::string header;					// lines preceding the first record
+	std::string footer;					// lines following the last record (trans.inp only)
+	std::vector<ThermoDatabaseRecord> records;
+	bool exists;
+
+	std::map<std::string, size_t> names;							// record by species name
+	std::map<ThermoElementMask, std::vector<size_t> > products;	// reaction products by element set
+
+	ThermoDatabaseIndex() : data(NULL), size(0), exists(false) {
+	}
+};
+
+static bool thermoDatabaseLazy = false;
+
+// All the species have been loaded by loadAllThermoSpecies()
+static bool thermoDatabaseComplete = false;
+
+// thermo.inp, usr_thermo.inp
+static ThermoDatabaseIndex thermoIndex[2];
+
+// trans.inp
+static ThermoDatabaseIndex transportIndex;
+
+static std::mutex thermoIndexMutex;
+
+// Element symbols, in the order of bits of ThermoElementMask
+static std::vector<std::string> thermoElements;
+
+// Cached results of the candidates lookup: index of database and of record
+typedef std::vector<std::pair<int, size_t> > ThermoCandidates;
+static std::map<std::pair<ThermoElementMask, int>, ThermoCandidates> thermoCandidatesCache;
+
+bool isThermoDatabaseLazy() {
+	std::lock_guard<std::mutex> lock(thermoIndexMutex);
+	return thermoDatabaseLazy;
+}
+
+/**
+ * Returns next line [begin, end) of the buffer, including the end-of-line character(s).
+ */
+static bool nextLine(const char* data, size_t size, size_t& pos, size_t& begin, size_t& end) {
+	if (pos>=size) {
+		return false;
+	}
+	begin = pos;
+	while (pos<size && '\n'!=data[pos]) {
+		++pos;
+	}
+	if (pos<size) {
+		++pos;
+	}
+	end = pos;
+	return true;
+}
+
+static std::string trim(const char* p, size_t length) {
+	size_t b = 0;
+	while (b<length && isspace((unsigned char)p[b])) {
+		++b;
+	}
+	size_t e = length;
+	while (e>b && isspace((unsigned char)p[e-1])) {
+		--e;
+	}
+	return std::string(p+b, e-b);
+}
+
+static bool startsWith(const char* p, size_t length, const char* prefix) {
+	size_t n = strlen(prefix);
+	if (length<n) {
+		return false;
+	}
+	for (size_t i=0; i<n; ++i) {
+		if (toupper((unsigned char)p[i])!=toupper((unsigned char)prefix[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Indexes thermo.inp style database.
+ *
+ * Record consists of the name line, the line with number of temperature intervals, elements and phase,
+ * and 3 lines per temperature interval (or 1 line for the reactant defined without intervals).
+ */
+static bool indexThermoDatabase(ThermoDatabaseIndex& index, const char* path) {
+	index.records.clear();
+	index.header.clear();
+	index.exists = false;
+
+	if (!index.file.open(path)) {
+		return false;
+	}
+	index.exists = true;
+
+	const char* data = index.data = index.file.getData();
+	size_t size = index.size = index.file.getSize();
+
+	size_t pos = 0, begin = 0, end = 0;
+	bool reactant = false;
+	int headerLines = 0;
+
+	while (nextLine(data, size, pos, begin, end)) {
+		const char* line = data + begin;
+		size_t length = end - begin;
+
+		if ('!'==line[0] || trim(line, length).empty()) {
+			continue;
+		}
+
+		if (0==index.records.size() && !reactant) {
+			// Header: "thermo" keyword followed by the line with common temperature intervals
+			if (0==headerLines && startsWith(line, length, "thermo")) {
+				index.header.append(line, length);
+				headerLines = 1;
+				continue;
+			}
+			if (1==headerLines) {
+				index.header.append(line, length);
+				headerLines = 2;
+				continue;
+			}
+		}
+
+		if (startsWith(line, length, "END PRODUCTS")) {
+			reactant = true;
+			continue;
+		}
+		if (startsWith(line, length, "END REACTANTS")) {
+			break;
+		}
+
+		ThermoDatabaseRecord record;
+		record.offset = begin;
+		record.reactant = reactant;
+		record.condensed = false;
+		record.ion = false;
+		record.loaded = false;
+
+		size_t nameLength = 0;
+		while (nameLength<length && !isspace((unsigned char)line[nameLength])) {
+			++nameLength;
+		}
+		record.name.assign(line, nameLength);
+
+		if (!nextLine(data, size, pos, begin, end)) {
+			return false;
+		}
+		line = data + begin;
+		length = end - begin;
+
+		if (length<52 || !isdigit((unsigned char)line[1])) {
+			util::Log::warnf("THERMO", "Unexpected format of %s record in %s%s", record.name.c_str(), path, CR);
+			return false;
+		}
+
+		int intervals = atoi(std::string(line, 2).c_str());
+
+		// Formula: 5 pairs of 2-character element symbol and 6-character number of atoms, starting at column 11
+		for (int i=0; i<5; ++i) {
+			std::string element = trim(line + 10 + i*8, 2);
+			double n = atof(std::string(line + 12 + i*8, 6).c_str());
+			if (element.empty() || 0==n) {
+				continue;
+			}
+			for (size_t j=0; j<element.size(); ++j) {
+				element[j] = toupper((unsigned char)element[j]);
+			}
+			if ("E"==element) {
+				record.ion = true;
+			}
+			record.elements.push_back(element);
+		}
+
+		record.condensed = ' '!=line[51] && '0'!=line[51];
+
+		int lines = intervals>0 ? 3*intervals : 1;
+		for (int i=0; i<lines; ++i) {
+			if (!nextLine(data, size, pos, begin, end)) {
+				util::Log::warnf("THERMO", "Unexpected end of %s record in %s%s", record.name.c_str(), path, CR);
+				return false;
+			}
+		}
+
+		record.length = end - record.offset;
+		index.records.push_back(record);
+	}
+
+	return !index.records.empty();
+}
+
+/**
+ * Indexes trans.inp style database.
+ *
+ * Record consists of the line with one or two species names followed by "VnCm" specification,
+ * and n+m lines with coefficients of viscosity and thermal conductivity.
+ */
+static bool indexTransportDatabase(ThermoDatabaseIndex& index, const char* path) {
+	index.records.clear();
+	index.header.clear();
+	index.footer.clear();
+	index.exists = false;
+
+	if (!index.file.open(path)) {
+		return false;
+	}
+	index.exists = true;
+
+	const char* data = index.data = index.file.getData();
+	size_t size = index.size = index.file.getSize();
+
+	size_t pos = 0, begin = 0, end = 0;
+
+	while (nextLine(data, size, pos, begin, end)) {
+		const char* line = data + begin;
+		size_t length = end - begin;
+
+		if (startsWith(line, length, "end")) {
+			index.footer.assign(line, size - begin);
+			break;
+		}
+
+		// Look for "VnCm" specification following the species names
+		int v = -1, c = -1;
+		for (size_t i=30; i+3<length; ++i) {
+			if ('V'==line[i] && isdigit((unsigned char)line[i+1]) && 'C'==line[i+2] && isdigit((unsigned char)line[i+3])) {
+				v = line[i+1] - '0';
+				c = line[i+3] - '0';
+				break;
+			}
+		}
+
+		if (v<0 || isspace((unsigned char)line[0])) {
+			if (index.records.empty()) {
+				index.header.append(line, length);
+				continue;
+			}
+			util::Log::warnf("THERMO", "Unexpected format of %s%s", path, CR);
+			return false;
+		}
+
+		ThermoDatabaseRecord record;
+		record.offset = begin;
+		record.reactant = false;
+		record.condensed = false;
+		record.ion = false;
+		record.loaded = false;
+		record.name = trim(line, 15);
+		record.name2 = trim(line + 15, 15);
+
+		for (int i=0; i<v+c; ++i) {
+			if (!nextLine(data, size, pos, begin, end)) {
+				util::Log::warnf("THERMO", "Unexpected end of %s record in %s%s", record.name.c_str(), path, CR);
+				return false;
+			}
+		}
+
+		record.length = end - record.offset;
+		index.records.push_back(record);
+	}
+
+	return !index.records.empty();
+}
+
+FILE* createTemporaryFile(const char* name, std::string& path) {
+#ifdef _WIN32
+	char dir[MAX_PATH];
+	if (!GetTempPathA(MAX_PATH, dir)) {
+		strcpy(dir, ".\\");
+	}
+	// The file is created by GetTempFileName, so that its name is not taken by anyone else
+	char buffer[MAX_PATH];
+	if (!GetTempFileNameA(dir, "rpa", 0, buffer)) {
+		return NULL;
+	}
+	path = buffer;
+	FILE* f = fopen(buffer, "wb");
+	if (!f) {
+		remove(buffer);
+	}
+	return f;
+#else
+	const char* dir = getenv("TMPDIR");
+	std::string pattern = std::string(dir && dir[0] ? dir : "/tmp") + "/rpa_" + name + "_XXXXXX";
+
+	// mkstemp creates the file exclusively (O_CREAT | O_EXCL), so an existing file or symbolic link is never followed
+	std::vector<char> buffer(pattern.begin(), pattern.end());
+	buffer.push_back(0);
+	int fd = mkstemp(&buffer[0]);
+	if (fd<0) {
+		return NULL;
+	}
+	path = &buffer[0];
+	FILE* f = fdopen(fd, "wb");
+	if (!f) {
+		::close(fd);
+		remove(path.c_str());
+	}
+	return f;
+#endif
+}
+
+/**
+ * Writes all loaded records of the index into the temporary file, and passes it to the library loader.
+ */
+static void loadThermoDatabaseRecords(ThermoDatabaseIndex& index, ThermoDatabaseType type, const char* name) {
+	std::string path;
+	FILE* out = createTemporaryFile(name, path);
+	if (!out) {
+		util::Log::errorf("THERMO", "Could not create temporary file for %s%s", name, CR);
+		return;
+	}
+
+	const char* data = index.data;
+
+	fwrite(index.header.data(), 1, index.header.size(), out);
+
+	if (THERMO_DATABASE_TRANSPORT==type) {
+		for (size_t i=0; i<index.records.size(); ++i) {
+			if (index.records[i].loaded) {
+				fwrite(data + index.records[i].offset, 1, index.records[i].length, out);
+			}
+		}
+		fwrite(index.footer.data(), 1, index.footer.size(), out);
+	} else {
+		for (int reactants=0; reactants<2; ++reactants) {
+			for (size_t i=0; i<index.records.size(); ++i) {
+				if (index.records[i].loaded && (0!=reactants)==index.records[i].reactant) {
+					fwrite(data + index.records[i].offset, 1, index.records[i].length, out);
+				}
+			}
+			fputs(reactants ? "END REACTANTS\n" : "END PRODUCTS\n", out);
+		}
+	}
+
+	if (0!=fclose(out)) {
+		util::Log::errorf("THERMO", "Could not write %s%s", path.c_str(), CR);
+		remove(path.c_str());
+		return;
+	}
+
+	try {
+		loadThermoDatabaseFile(type, path.c_str());
+	} catch (const std::exception& ex) {
+		util::Log::warnf("THERMO", "Could not load thermodynamics data for species from %s\n", name);
+	}
+
+	remove(path.c_str());
+}
+
+/**
+ * Returns the bit of the element in ThermoElementMask, adding the element if necessary.
+ * All the elements beyond the capacity of the mask share the last bit.
+ */
+static int getThermoElementId(const std::string& element) {
+	std::vector<std::string>::iterator it = std::find(thermoElements.begin(), thermoElements.end(), element);
+	if (thermoElements.end()!=it) {
+		return (int)(it - thermoElements.begin());
+	}
+	if (thermoElements.size()<ThermoElementMask::OTHER) {
+		thermoElements.push_back(element);
+		return (int)thermoElements.size() - 1;
+	}
+	return ThermoElementMask::OTHER;
+}
+
+/**
+ * Builds the lookup tables of the index: species by name, and reaction products by element set.
+ */
+static void buildThermoDatabaseLookup(ThermoDatabaseIndex& index) {
+	index.names.clear();
+	index.products.clear();
+
+	for (size_t i=0; i<index.records.size(); ++i) {
+		ThermoDatabaseRecord& record = index.records[i];
+
+		record.mask = ThermoElementMask();
+		for (size_t j=0; j<record.elements.size(); ++j) {
+			record.mask.set(getThermoElementId(record.elements[j]));
+		}
+
+		index.names.insert(std::make_pair(record.name, i));
+
+		if (!record.reactant) {
+			index.products[record.mask].push_back(i);
+		}
+	}
+}
+
+//*****************************************************************************
+
+bool initThermoDatabaseIndex(const char* sourcePath) {
+	std::lock_guard<std::mutex> lock(thermoIndexMutex);
+
+	std::string base(sourcePath);
+
+	if (!indexThermoDatabase(thermoIndex[0], (base + "/thermo.inp").c_str())) {
+		util::Log::warnf("THERMO", "Could not index %s/thermo.inp%s", sourcePath, CR);
+		thermoIndex[0].file.close();
+		return false;
+	}
+
+	if (!indexThermoDatabase(thermoIndex[1], (base + "/usr_thermo.inp").c_str()) && thermoIndex[1].exists) {
+		util::Log::warnf("THERMO", "Could not index %s/usr_thermo.inp%s", sourcePath, CR);
+		thermoIndex[0].file.close();
+		thermoIndex[1].file.close();
+		return false;
+	}
+
+	if (!indexTransportDatabase(transportIndex, (base + "/trans.inp").c_str())) {
+		transportIndex.file.close();
+		transportIndex.records.clear();
+	}
+
+	// Properties databases are small, and used by propellant definitions directly
+	for (unsigned int i=0; i<thermoDatabaseSourcesNo; ++i) {
+		if (THERMO_DATABASE_PROPERTIES==thermoDatabaseSources[i].type) {
+			std::string path = base + "/" + thermoDatabaseSources[i].name;
+			try {
+				loadThermoDatabaseFile(THERMO_DATABASE_PROPERTIES, path.c_str());
+			} catch (const std::exception& ex) {
+				util::Log::warnf("THERMO", "Could not load properties data from %s\n", path.c_str());
+			}
+		}
+	}
+
+	if (transportIndex.records.empty()) {
+		// Transport properties are loaded eagerly then
+		std::string path = base + "/trans.inp";
+		try {
+			loadThermoDatabaseFile(THERMO_DATABASE_TRANSPORT, path.c_str());
+		} catch (const std::exception& ex) {
+			util::Log::warnf("THERMO", "Could not load transport properties data from %s\n", path.c_str());
+		}
+	}
+
+	buildThermoDatabaseLookup(thermoIndex[0]);
+	buildThermoDatabaseLookup(thermoIndex[1]);
+	thermoCandidatesCache.clear();
+
+	thermoDatabaseLazy = true;
+	thermoDatabaseComplete = false;
+
+	return true;
+}
+
+/**
+ * Returns the reaction products consisting of the elements of given set. Has to be called with locked index.
+ */
+static const ThermoCandidates& findThermoCandidates(ThermoElementMask elements, bool ions, bool multiphase) {
+	if (ions) {
+		// Ionized products contain electron "E", which is never one of the elements of propellant components
+		elements.set(getThermoElementId("E"));
+	}
+
+	std::pair<ThermoElementMask, int> key(elements, (ions ? 1 : 0) | (multiphase ? 2 : 0));
+
+	std::map<std::pair<ThermoElementMask, int>, ThermoCandidates>::iterator cached = thermoCandidatesCache.find(key);
+	if (thermoCandidatesCache.end()!=cached) {
+		return cached->second;
+	}
+
+	ThermoCandidates& candidates = thermoCandidatesCache[key];
+
+	for (int k=0; k<2; ++k) {
+		std::map<ThermoElementMask, std::vector<size_t> >::const_iterator it = thermoIndex[k].products.begin();
+		for (; it!=thermoIndex[k].products.end(); ++it) {
+			if (!it->first.isSubsetOf(elements)) {
+				continue;
+			}
+			for (size_t i=0; i<it->second.size(); ++i) {
+				const ThermoDatabaseRecord& record = thermoIndex[k].records[it->second[i]];
+				if ((ions || !record.ion) && (multiphase || !record.condensed)) {
+					candidates.push_back(std::make_pair(k, it->second[i]));
+				}
+			}
+		}
+	}
+
+	return candidates;
+}
+
+void findThermoSpeciesCandidates(const std::vector<std::string>& elements, bool ions, bool multiphase, std::vector<std::string>& candidates) {
+	std::lock_guard<std::mutex> lock(thermoIndexMutex);
+
+	candidates.clear();
+
+	ThermoElementMask mask;
+	bool other = false;
+	for (size_t i=0; i<elements.size(); ++i) {
+		std::vector<std::string>::iterator it = std::find(thermoElements.begin(), thermoElements.end(), elements[i]);
+		if (thermoElements.end()!=it) {
+			mask.set((int)(it - thermoElements.begin()));
+		} else {
+			other = true;
+		}
+	}
+
+	if (!other) {
+		const ThermoCandidates& found = findThermoCandidates(mask, ions, multiphase);
+		for (size_t i=0; i<found.size(); ++i) {
+			candidates.push_back(thermoIndex[found[i].first].records[found[i].second].name);
+		}
+		return;
+	}
+
+	// Element is either unknown, or beyond the capacity of the mask: compare the symbols of each product
+	std::vector<std::string> symbols(elements);
+	if (ions) {
+		symbols.push_back("E");
+	}
+	for (int k=0; k<2; ++k) {
+		for (size_t i=0; i<thermoIndex[k].records.size(); ++i) {
+			const ThermoDatabaseRecord& record = thermoIndex[k].records[i];
+			if (record.reactant || (!ions && record.ion) || (!multiphase && record.condensed)) {
+				continue;
+			}
+			bool matches = true;
+			for (size_t j=0; matches && j<record.elements.size(); ++j) {
+				matches = symbols.end()!=std::find(symbols.begin(), symbols.end(), record.elements[j]);
+			}
+			if (matches) {
+				candidates.push_back(record.name);
+			}
+		}
+	}
+}
+
+bool getThermoSpeciesRecord(const std::string& name, std::string& record) {
+	std::lock_guard<std::mutex> lock(thermoIndexMutex);
+
+	for (int k=1; k>=0; --k) {
+		std::map<std::string, size_t>::const_iterator it = thermoIndex[k].names.find(name);
+		if (thermoIndex[k].names.end()!=it) {
+			const ThermoDatabaseRecord& r = thermoIndex[k].records[it->second];
+			record.assign(thermoIndex[k].data + r.offset, r.length);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint64_t getThermoDatabaseVersion(const char* sourcePath) {
+	uint64_t checksum = fnv1a(NULL, 0);
+
+	for (unsigned int i=0; i<thermoDatabaseSourcesNo; ++i) {
+		uint64_t size = 0;
+		int64_t mtime = 0;
+		getFileStat(std::string(sourcePath) + "/" + thermoDatabaseSources[i].name, size, mtime);
+		checksum = fnv1a(&size, sizeof(size), checksum);
+		checksum = fnv1a(&mtime, sizeof(mtime), checksum);
+	}
+
+	return checksum;
+}
+
+/**
+ * Passes the records marked as loaded to the library, together with the transport properties of the loaded species.
+ * Has to be called with locked index.
+ */
+static void loadThermoDatabaseSelection() {
+	// Loaded set is cumulative: the library always gets all the species requested so far
+	loadThermoDatabaseRecords(thermoIndex[0], THERMO_DATABASE_THERMO, "thermo.inp");
+	if (thermoIndex[1].exists) {
+		loadThermoDatabaseRecords(thermoIndex[1], THERMO_DATABASE_USR_THERMO, "usr_thermo.inp");
+	}
+
+	if (!transportIndex.records.empty()) {
+		// Transport properties of the loaded species, and of the interactions between them
+		std::vector<std::string> loaded;
+		for (int k=0; k<2; ++k) {
+			for (size_t i=0; i<thermoIndex[k].records.size(); ++i) {
+				if (thermoIndex[k].records[i].loaded) {
+					loaded.push_back(thermoIndex[k].records[i].name);
+				}
+			}
+		}
+		std::sort(loaded.begin(), loaded.end());
+
+		bool transportModified = false;
+		for (size_t i=0; i<transportIndex.records.size(); ++i) {
+			ThermoDatabaseRecord& record = transportIndex.records[i];
+			if (!record.loaded
+					&& std::binary_search(loaded.begin(), loaded.end(), record.name)
+					&& (record.name2.empty() || std::binary_search(loaded.begin(), loaded.end(), record.name2))) {
+				record.loaded = true;
+				transportModified = true;
+			}
+		}
+
+		if (transportModified) {
+			loadThermoDatabaseRecords(transportIndex, THERMO_DATABASE_TRANSPORT, "trans.inp");
+		}
+	}
+}
+
+bool loadThermoSpecies(const std::vector<std::string>& names, bool ions, bool multiphase) {
+	std::lock_guard<std::mutex> lock(thermoIndexMutex);
+
+	if (!thermoDatabaseLazy || thermoDatabaseComplete) {
+		return true;
+	}
+
+	bool modified[2] = {false, false};
+	bool complete = true;
+
+	// Requested species, and elements they consist of
+	ThermoElementMask elements;
+	for (size_t n=0; n<names.size(); ++n) {
+		bool found = false;
+		for (int k=0; k<2; ++k) {
+			std::map<std::string, size_t>::const_iterator it = thermoIndex[k].names.find(names[n]);
+			if (thermoIndex[k].names.end()==it) {
+				continue;
+			}
+			found = true;
+
+			ThermoDatabaseRecord& record = thermoIndex[k].records[it->second];
+			elements |= record.mask;
+			if (!record.loaded) {
+				record.loaded = true;
+				modified[k] = true;
+			}
+		}
+		if (!found) {
+			util::Log::warnf("THERMO", "Species %s not found in thermodynamics database%s", names[n].c_str(), CR);
+			complete = false;
+		}
+	}
+
+	if (elements.isSet(ThermoElementMask::OTHER)) {
+		// Elements sharing the last bit of the mask can't be told apart, so the products can't be selected by the mask
+		util::Log::warnf("THERMO", "Too many chemical elements in thermodynamics database to select reaction products%s", CR);
+		complete = false;
+	}
+
+	// All reaction products consisting of the same elements
+	const ThermoCandidates& candidates = findThermoCandidates(elements, ions, multiphase);
+	for (size_t i=0; i<candidates.size(); ++i) {
+		ThermoDatabaseRecord& record = thermoIndex[candidates[i].first].records[candidates[i].second];
+		if (!record.loaded) {
+			record.loaded = true;
+			modified[candidates[i].first] = true;
+		}
+	}
+	if (modified[0] || modified[1]) {
+		loadThermoDatabaseSelection();
+	}
+
+	return complete;
+}
+
+void loadAllThermoSpecies() {
+	std::lock_guard<std::mutex> lock(thermoIndexMutex);
+
+	if (!thermoDatabaseLazy || thermoDatabaseComplete) {
+		return;
+	}
+
+	for (int k=0; k<2; ++k) {
+		for (size_t i=0; i<thermoIndex[k].records.size(); ++i) {
+			thermoIndex[k].records[i].loaded = true;
+		}
+	}
+	loadThermoDatabaseSelection();
+
+	thermoDatabaseComplete = true;
+
+	util::Log::printf("THERMO", "Loaded complete thermodynamics database%s", CR);
+}
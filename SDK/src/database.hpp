@@ -0,0 +1,239 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_DATABASE_HPP_
+#define EXAMPLES_DATABASE_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && _MSC_VER<1600
+typedef unsigned __int32 uint32_t;
+typedef unsigned __int64 uint64_t;
+typedef __int64 int64_t;
+#else
+#include <stdint.h>
+#endif
+
+/**
+ * Location of the text databases loaded by initThermoDatabase().
+ */
+#define THERMO_DATABASE_PATH "resources"
+
+/**
+ * Kind of the database file, defining which loader of the thermodynamics library has to be used.
+ */
+enum ThermoDatabaseType {
+	THERMO_DATABASE_THERMO = 0,			// loadThermodynamicsDatabase(path, true)
+	THERMO_DATABASE_USR_THERMO = 1,		// loadThermodynamicsDatabase(path, false)
+	THERMO_DATABASE_PROPERTIES = 2,		// loadPropertiesDatabase(path)
+	THERMO_DATABASE_TRANSPORT = 3		// loadTransportPropertiesDatabase(path)
+};
+
+/**
+ * Options of initThermoDatabase().
+ */
+enum ThermoDatabaseOption {
+	/**
+	 * Build only the index of species names and elements at initialization,
+	 * and load the species on demand by loadThermoSpecies().
+	 *
+	 * Loading of the species reloads the database of the library, so it is not thread-safe with respect to
+	 * the solvers: load the species of all configurations before the solvers are started on other threads.
+	 */
+	THERMO_DATABASE_OPTION_LAZY = 1
+};
+
+/**
+ * Set of chemical elements: one bit per element symbol known to the species index.
+ * All the elements beyond the capacity of the mask share the last bit OTHER, so the sets containing it
+ * can't be compared by bits.
+ */
+struct ThermoElementMask {
+	static const int OTHER = 127;
+
+	uint64_t bits[2];
+
+	ThermoElementMask() {
+		bits[0] = bits[1] = 0;
+	}
+
+	void set(int element) {
+		bits[element>>6] |= (uint64_t)1<<(element&63);
+	}
+
+	ThermoElementMask& operator|=(const ThermoElementMask& other) {
+		bits[0] |= other.bits[0];
+		bits[1] |= other.bits[1];
+		return *this;
+	}
+
+	/**
+	 * Returns true if all the elements of this set are contained in the other set.
+	 */
+	bool isSubsetOf(const ThermoElementMask& other) const {
+		return 0==(bits[0] & ~other.bits[0]) && 0==(bits[1] & ~other.bits[1]);
+	}
+
+	bool isSet(int element) const {
+		return 0!=(bits[element>>6] & ((uint64_t)1<<(element&63)));
+	}
+
+	bool operator<(const ThermoElementMask& other) const {
+		return bits[1]<other.bits[1] || (bits[1]==other.bits[1] && bits[0]<other.bits[0]);
+	}
+};
+
+/**
+ * Read-only memory mapping of the whole file.
+ */
+class MappedFile {
+private:
+	const char* data;
+	size_t size;
+
+#ifdef _WIN32
+	void* hFile;
+	void* hMapping;
+#else
+	int fd;
+#endif
+
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	/**
+	 * Maps the file into memory.
+	 *
+	 * @return false if the file could not be opened or mapped
+	 */
+	bool open(const char* path);
+
+	void close();
+
+	bool isOpen() const {
+		return NULL!=data;
+	}
+
+	const char* getData() const {
+		return data;
+	}
+
+	size_t getSize() const {
+		return size;
+	}
+};
+
+/**
+ * Calculates 64-bit FNV-1a checksum of given buffer.
+ *
+ * @param checksum initial value; pass the result of previous call to checksum several buffers
+ */
+extern uint64_t fnv1a(const void* buffer, size_t size, uint64_t checksum = 14695981039346656037ULL);
+
+/**
+ * Creates the directory, if it does not exist.
+ *
+ * @return true if the directory exists
+ */
+extern bool makeDirectory(const char* path);
+
+/**
+ * Creates new temporary file exclusively (never following an existing file or link), and opens it for writing.
+ * The file has to be removed by the caller.
+ *
+ * @param name part of the file name
+ * @param path receives the path of the file
+ * @return opened file, or NULL if the file could not be created
+ */
+extern FILE* createTemporaryFile(const char* name, std::string& path);
+
+/**
+ * Returns the version of the databases in given directory: the checksum of sizes and modification times
+ * of all source databases.
+ */
+extern uint64_t getThermoDatabaseVersion(const char* sourcePath = THERMO_DATABASE_PATH);
+
+/**
+ * Builds the index of species defined in thermo.inp, usr_thermo.inp and trans.inp, and loads properties databases.
+ *
+ * Only the name, elements, phase and location of each record are read; polynomials and transport
+ * coefficients are left to the library, which gets the required records from loadThermoSpecies().
+ *
+ * If trans.inp could not be indexed, it is loaded completely.
+ *
+ * @return false if thermo.inp or usr_thermo.inp could not be indexed; in this case nothing has been loaded
+ */
+extern bool initThermoDatabaseIndex(const char* sourcePath = THERMO_DATABASE_PATH);
+
+/**
+ * Returns true if the database has been initialized in lazy mode, i.e. species are loaded on demand.
+ */
+extern bool isThermoDatabaseLazy();
+
+/**
+ * Loads given species, and all reaction products which consist of the same elements as given species, into the library.
+ * Does nothing if the database has not been initialized in lazy mode.
+ * Must not be called while performance is being solved on other threads (see THERMO_DATABASE_OPTION_LAZY).
+ *
+ * @param names names of species, e.g. propellant components
+ * @param ions true to include ionized products (and electron)
+ * @param multiphase true to include condensed products
+ * @return false if any of the species is not found in the index, or consists of the elements beyond the capacity
+ *         of ThermoElementMask, i.e. the set of the products may be incomplete
+ */
+extern bool loadThermoSpecies(const std::vector<std::string>& names, bool ions, bool multiphase);
+
+/**
+ * Loads all the species of the index into the library; loadThermoSpecies() does nothing after that.
+ * Does nothing if the database has not been initialized in lazy mode.
+ */
+extern void loadAllThermoSpecies();
+
+/**
+ * Returns the names of all reaction products which consist of given elements only.
+ * Requires the database initialized in lazy mode.
+ *
+ * Products are grouped by their element sets, so the lookup only checks the distinct element sets
+ * of the database; the result is cached for the repeated lookups.
+ *
+ * @param elements element symbols, e.g. "C", "H", "O"; "E" stands for electron (ionized products)
+ * @param ions true to include ionized products
+ * @param multiphase true to include condensed products
+ */
+extern void findThermoSpeciesCandidates(const std::vector<std::string>& elements, bool ions, bool multiphase, std::vector<std::string>& candidates);
+
+/**
+ * Returns the text of thermo.inp record of given species (usr_thermo.inp takes precedence).
+ * Requires the database initialized in lazy mode.
+ *
+ * @return false if the species is not found
+ */
+extern bool getThermoSpeciesRecord(const std::string& name, std::string& record);
+
+#endif /* EXAMPLES_DATABASE_HPP_ */
@@ -0,0 +1,327 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+#include "thermodynamics/gasdynamics/StandardAtmosphere.hpp"
+
+#include "common.hpp"
+#include "design_optimizer.hpp"
+#include "threadpool.hpp"
+
+/**
+ * Size of the initial simplex relative to the ranges of the variables.
+ */
+static const double DESIGN_OPTIMIZER_SIMPLEX = 0.25;
+
+/**
+ * Task of the worker thread: solves one point using the configuration of the thread.
+ */
+struct DesignOptimizerTask {
+	const DesignOptimizer* optimizer;
+	WorkerConfigs* configs;
+	const std::vector<std::vector<double> >* values;
+	std::vector<PerformanceSnapshot> snapshots;
+	std::vector<char> solved;
+
+	void operator()(size_t i, int worker) {
+		solved[i] = optimizer->solvePoint(configs->get(worker), (*values)[i], snapshots[i]) ? 1 : 0;
+	}
+};
+
+/**
+ * Orders the vertices of the simplex by minus objective.
+ */
+struct DesignVertexLess {
+	const std::vector<double>* f;
+
+	explicit DesignVertexLess(const std::vector<double>* f) :
+		f(f) {
+	}
+
+	bool operator()(size_t a, size_t b) const {
+		return (*f)[a]<(*f)[b];
+	}
+};
+
+//*****************************************************************************
+
+void DesignOptimizer::addVariable(SweepAxisType type, double min, double max, double initial) {
+	Variable v;
+	v.type = type;
+	v.min = std::min(min, max);
+	v.max = std::max(min, max);
+	v.initial = initial>=v.min && initial<=v.max ? initial : 0.5*(v.min + v.max);
+	variables.push_back(v);
+}
+
+void DesignOptimizer::addAltitude(double H, double weight) {
+	StandardAtmosphere sa;
+	sa.setAltitude(H);
+
+	Altitude a;
+	a.H = H;
+	a.pa = sa.getPressure();
+	a.weight = weight;
+	altitudes.push_back(a);
+}
+
+double DesignOptimizer::getObjective(const PerformanceSnapshot& snapshot) const {
+	double sum = vacuumWeight*snapshot.Is_v;
+	double weights = vacuumWeight;
+	for (size_t i=0; i<altitudes.size(); ++i) {
+		sum += altitudes[i].weight*snapshot.getIs_H(altitudes[i].pa);
+		weights += altitudes[i].weight;
+	}
+	return weights>0 ? sum/weights : snapshot.Is_v;
+}
+
+bool DesignOptimizer::solvePoint(thermo::input::ConfigFile* config, const Vector& values, PerformanceSnapshot& snapshot) const {
+	for (size_t i=0; i<variables.size(); ++i) {
+		setSweepAxisValue(config, variables[i].type, values[i]);
+	}
+
+	try {
+		solvePerformance(cache, config, snapshot);
+	} catch (const std::exception& ex) {
+		util::Log::warnf("OPTIMIZE", "Could not solve design point: %s%s", ex.what(), CR);
+		return false;
+	}
+
+	return true;
+}
+
+DesignOptimizer::Vector DesignOptimizer::getValues(Vector& x) const {
+	Vector values(x.size());
+	for (size_t i=0; i<x.size(); ++i) {
+		x[i] = std::min(1.0, std::max(0.0, x[i]));
+		values[i] = variables[i].min + (variables[i].max - variables[i].min)*x[i];
+	}
+	return values;
+}
+
+void DesignOptimizer::solve(std::vector<Vector>& x) {
+	std::vector<Vector> pending;
+	for (size_t i=0; i<x.size(); ++i) {
+		Vector values = getValues(x[i]);
+		if (solved.find(values)==solved.end() && std::find(pending.begin(), pending.end(), values)==pending.end()
+				&& solved.size() + pending.size()<(size_t)maxEvaluations) {
+			pending.push_back(values);
+		}
+	}
+	if (pending.empty()) {
+		return;
+	}
+
+	ThreadPool pool(threads);
+	configs.prepare(pool.getThreads());
+
+	DesignOptimizerTask task;
+	task.optimizer = this;
+	task.configs = &configs;
+	task.values = &pending;
+	task.snapshots.resize(pending.size());
+	task.solved.assign(pending.size(), 0);
+
+	pool.run(pending.size(), task);
+
+	for (size_t i=0; i<pending.size(); ++i) {
+		Point& point = solved[pending[i]];
+		point.solved = 0!=task.solved[i];
+		point.value = point.solved ? getObjective(task.snapshots[i]) : -HUGE_VAL;
+		point.snapshot = task.snapshots[i];
+	}
+}
+
+double DesignOptimizer::evaluate(Vector& x) {
+	Vector values = getValues(x);
+	std::map<Vector, Point>::const_iterator it = solved.find(values);
+	if (it==solved.end()) {
+		std::vector<Vector> points(1, x);
+		solve(points);
+		it = solved.find(values);
+		if (it==solved.end()) {
+			// Maximum number of evaluations is reached
+			return HUGE_VAL;
+		}
+	}
+	return -it->second.value;
+}
+
+double DesignOptimizer::run() {
+	solved.clear();
+	iterations = 0;
+
+	size_t n = variables.size();
+	if (0==n) {
+		throw std::runtime_error("No variables to optimize");
+	}
+
+	ThreadPool pool(threads);
+	bool speculative = pool.getThreads()>1;
+
+	// Initial simplex around the initial values
+	std::vector<Vector> simplex(n + 1, Vector(n));
+	for (size_t i=0; i<n; ++i) {
+		double range = variables[i].max - variables[i].min;
+		double x0 = range>0 ? (variables[i].initial - variables[i].min)/range : 0;
+		for (size_t j=0; j<=n; ++j) {
+			simplex[j][i] = x0;
+		}
+		simplex[i+1][i] = (x0 + DESIGN_OPTIMIZER_SIMPLEX<=1) ? x0 + DESIGN_OPTIMIZER_SIMPLEX : x0 - DESIGN_OPTIMIZER_SIMPLEX;
+	}
+
+	std::vector<double> f(n + 1);
+	std::vector<size_t> order(n + 1);
+
+	try {
+		solve(simplex);
+
+		for (size_t j=0; j<=n; ++j) {
+			f[j] = evaluate(simplex[j]);
+		}
+
+		for (; ; ++iterations) {
+			for (size_t j=0; j<=n; ++j) {
+				order[j] = j;
+			}
+			std::sort(order.begin(), order.end(), DesignVertexLess(&f));
+
+			std::vector<Vector> sorted(n + 1);
+			std::vector<double> sortedF(n + 1);
+			for (size_t j=0; j<=n; ++j) {
+				sorted[j] = simplex[order[j]];
+				sortedF[j] = f[order[j]];
+			}
+			simplex.swap(sorted);
+			f.swap(sortedF);
+
+			if (HUGE_VAL==f[0]) {
+				throw std::runtime_error("Could not solve any point of the initial simplex");
+			}
+
+			// Size of the simplex
+			double size = 0;
+			for (size_t j=1; j<=n; ++j) {
+				for (size_t i=0; i<n; ++i) {
+					size = std::max(size, fabs(simplex[j][i] - simplex[0][i]));
+				}
+			}
+			if (size<tolerance || (int)solved.size()>=maxEvaluations) {
+				break;
+			}
+
+			// Centroid of all the vertices but the worst one
+			Vector c(n, 0.0);
+			for (size_t j=0; j<n; ++j) {
+				for (size_t i=0; i<n; ++i) {
+					c[i] += simplex[j][i]/(double)n;
+				}
+			}
+
+			Vector xr(n), xe(n), xoc(n), xic(n);
+			for (size_t i=0; i<n; ++i) {
+				double d = c[i] - simplex[n][i];
+				xr[i] = c[i] + d;
+				xe[i] = c[i] + 2*d;
+				xoc[i] = c[i] + 0.5*d;
+				xic[i] = c[i] - 0.5*d;
+			}
+
+			if (speculative) {
+				std::vector<Vector> trial;
+				trial.push_back(xr);
+				trial.push_back(xe);
+				trial.push_back(xoc);
+				trial.push_back(xic);
+				solve(trial);
+			}
+
+			double fr = evaluate(xr);
+			bool shrink = false;
+			if (fr<f[0]) {
+				double fe = evaluate(xe);
+				if (fe<fr) {
+					simplex[n] = xe;
+					f[n] = fe;
+				} else {
+					simplex[n] = xr;
+					f[n] = fr;
+				}
+			} else if (fr<f[n-1]) {
+				simplex[n] = xr;
+				f[n] = fr;
+			} else if (fr<f[n]) {
+				double foc = evaluate(xoc);
+				if (foc<=fr) {
+					simplex[n] = xoc;
+					f[n] = foc;
+				} else {
+					shrink = true;
+				}
+			} else {
+				double fic = evaluate(xic);
+				if (fic<f[n]) {
+					simplex[n] = xic;
+					f[n] = fic;
+				} else {
+					shrink = true;
+				}
+			}
+
+			if (shrink) {
+				for (size_t j=1; j<=n; ++j) {
+					for (size_t i=0; i<n; ++i) {
+						simplex[j][i] = simplex[0][i] + 0.5*(simplex[j][i] - simplex[0][i]);
+					}
+				}
+				solve(simplex);
+				for (size_t j=1; j<=n; ++j) {
+					f[j] = evaluate(simplex[j]);
+				}
+			}
+		}
+	} catch (...) {
+		configs.clear();
+		throw;
+	}
+
+	configs.clear();
+
+	best = getValues(simplex[0]);
+	bestValue = -f[0];
+	snapshot = solved[best].snapshot;
+
+	for (size_t i=0; i<n; ++i) {
+		setSweepAxisValue(data, variables[i].type, best[i]);
+	}
+
+	util::Log::printf("OPTIMIZE", "Optimal design found with %d points in %d iterations%s", (int)solved.size(), iterations, CR);
+
+	return bestValue;
+}
@@ -0,0 +1,225 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_DESIGN_OPTIMIZER_HPP_
+#define EXAMPLES_DESIGN_OPTIMIZER_HPP_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+
+#include "common.hpp"
+#include "performance_cache.hpp"
+#include "sweep.hpp"
+
+/**
+ * Search of the design parameters (O/F ratio, chamber pressure, nozzle area ratio) which give maximum
+ * mission-averaged specific impulse, by the Nelder-Mead simplex method with bound constraints.
+ *
+ * Variables are scaled to [0, 1] within their bounds, and the trial points are projected onto the bounds.
+ * At each step the reflection, expansion and both contraction points are solved at once on the thread pool,
+ * and the simplex is then updated as in the serial method; shrink steps solve all the new vertices at once.
+ * With one thread, only the points required by the serial method are solved.
+ *
+ * Each point is a complete solution of the problem with its own copy of the configuration (see ParametricSweep);
+ * points are solved once, and can be taken from the cache of results.
+ */
+class DesignOptimizer {
+private:
+	struct Variable {
+		SweepAxisType type;
+		double min;
+		double max;
+		double initial;
+	};
+
+	struct Altitude {
+		double H;						// altitude, m
+		double pa;						// ambient pressure, Pa
+		double weight;
+	};
+
+	struct Point {
+		bool solved;
+		double value;					// objective
+		PerformanceSnapshot snapshot;
+	};
+
+	typedef std::vector<double> Vector;
+
+	thermo::input::ConfigFile* data;
+	int threads;
+	double tolerance;
+	int maxEvaluations;
+
+	std::vector<Variable> variables;
+	std::vector<Altitude> altitudes;
+	double vacuumWeight;
+
+	PerformanceCache* cache;
+
+	WorkerConfigs configs;							// configuration of each worker thread
+	std::map<Vector, Point> solved;					// by values of the variables
+	Vector best;
+	double bestValue;
+	PerformanceSnapshot snapshot;
+	int iterations;
+
+	/**
+	 * Returns the values of the variables at the scaled point, projected onto the bounds.
+	 */
+	Vector getValues(Vector& x) const;
+
+	/**
+	 * Solves the points which have not been solved yet, in parallel.
+	 */
+	void solve(std::vector<Vector>& x);
+
+	/**
+	 * Returns minus objective at the scaled point (solving it if necessary); HUGE_VAL if it could not be solved.
+	 */
+	double evaluate(Vector& x);
+
+protected:
+	/**
+	 * Returns the objective to maximize. By default, the weighted average of specific impulse at the altitudes
+	 * and in vacuum (see addAltitude(), setVacuumWeight()); vacuum specific impulse if no weights are set.
+	 * Can be overridden to include other terms, e.g. the mass flow rate of the chamber for the required thrust.
+	 */
+	virtual double getObjective(const PerformanceSnapshot& snapshot) const;
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	DesignOptimizer(thermo::input::ConfigFile* data, int threads = 0) :
+		data(data), threads(threads), tolerance(1e-3), maxEvaluations(200), vacuumWeight(0),
+		cache(NULL), configs(data), bestValue(0), iterations(0) {
+	}
+
+	virtual ~DesignOptimizer() {
+	}
+
+	/**
+	 * Adds the variable. Pressure values are in Pa.
+	 *
+	 * @param initial initial value; if out of the bounds, the middle of the range is used
+	 */
+	void addVariable(SweepAxisType type, double min, double max, double initial);
+
+	size_t getVariablesNo() const {
+		return variables.size();
+	}
+
+	SweepAxisType getVariableType(size_t variable) const {
+		return variables[variable].type;
+	}
+
+	/**
+	 * Adds the altitude (m) of the mission with the weight of its specific impulse in the objective.
+	 */
+	void addAltitude(double H, double weight);
+
+	/**
+	 * Sets the weight of vacuum specific impulse in the objective.
+	 */
+	void setVacuumWeight(double weight) {
+		vacuumWeight = weight;
+	}
+
+	void setThreads(int threads) {
+		this->threads = threads;
+	}
+
+	/**
+	 * Sets the size of the simplex (relative to the ranges of the variables) at which the search is finished.
+	 */
+	void setTolerance(double tolerance) {
+		this->tolerance = tolerance;
+	}
+
+	void setMaxEvaluations(int maxEvaluations) {
+		this->maxEvaluations = maxEvaluations;
+	}
+
+	/**
+	 * Sets the cache of results: points found in the cache are not solved, and solved points are stored in the cache.
+	 *
+	 * @param cache cache of results; must exist as long as this object is used; NULL to solve all points
+	 */
+	void setCache(PerformanceCache* cache) {
+		this->cache = cache;
+	}
+
+	/**
+	 * Finds the optimal values of the variables and sets them in the configuration.
+	 *
+	 * Throws an exception if the initial simplex could not be solved.
+	 *
+	 * @return maximum objective
+	 */
+	double run();
+
+	/**
+	 * Solves one point using given configuration. Used by the worker threads.
+	 *
+	 * @param config configuration which is modified according to the point
+	 * @param values values of the variables
+	 * @return false if the point could not be solved
+	 */
+	bool solvePoint(thermo::input::ConfigFile* config, const Vector& values, PerformanceSnapshot& snapshot) const;
+
+	/**
+	 * Returns the optimal value of the variable.
+	 */
+	double getValue(size_t variable) const {
+		return best[variable];
+	}
+
+	double getObjectiveValue() const {
+		return bestValue;
+	}
+
+	/**
+	 * Returns the results at the optimal point.
+	 */
+	const PerformanceSnapshot& getSnapshot() const {
+		return snapshot;
+	}
+
+	/**
+	 * Returns the number of points solved (or taken from the cache) by the last run().
+	 */
+	int getEvaluationsNo() const {
+		return (int)solved.size();
+	}
+
+	int getIterationsNo() const {
+		return iterations;
+	}
+};
+
+#endif /* EXAMPLES_DESIGN_OPTIMIZER_HPP_ */
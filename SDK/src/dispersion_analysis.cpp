@@ -0,0 +1,132 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "database.hpp"
+#include "monte_carlo.hpp"
+
+/**
+ * Monte Carlo analysis which reports the progress.
+ */
+class DispersionAnalysis : public MonteCarloAnalysis {
+protected:
+	virtual bool progress(size_t samples, size_t total) {
+		fprintf(stderr, "\r%u of %u samples", (unsigned int)samples, (unsigned int)total);
+		if (samples==total) {
+			fprintf(stderr, "\n");
+		}
+		return true;
+	}
+
+public:
+	DispersionAnalysis(thermo::input::ConfigFile* data) :
+		MonteCarloAnalysis(data) {
+	}
+};
+
+/**
+ * Prints out the summary and the histogram of the result.
+ */
+static void printStatistics(const char* name, const StreamingStatistics& statistics, double factor) {
+	printf("# %s: mean %.3f, standard deviation %.3f, range %.3f..%.3f\n", name,
+		statistics.getMean()/factor, statistics.getStdDev()/factor, statistics.getMin()/factor, statistics.getMax()/factor);
+
+	for (size_t i=0; i<statistics.getPercentilesNo(); ++i) {
+		printf("#   %4.1f%%: %.3f\n", statistics.getPercentileFraction(i)*100, statistics.getPercentile(i)/factor);
+	}
+
+	size_t peak = 1;
+	for (size_t i=0; i<statistics.getBinsNo(); ++i) {
+		if (statistics.getBin(i)>peak) {
+			peak = statistics.getBin(i);
+		}
+	}
+	for (size_t i=0; i<statistics.getBinsNo(); ++i) {
+		int width = (int)(60*statistics.getBin(i)/peak);
+		printf(" %10.3f %7u %.*s\n", statistics.getBinEdge(i)/factor, (unsigned int)statistics.getBin(i), width,
+			"############################################################");
+	}
+}
+
+/**
+ * This example propagates the uncertainty of O/F ratio, chamber pressure, propellant inlet temperatures and
+ * reaction efficiency to the delivered Isp, combustion temperature and mass flow rate of rocket engine.
+ * Samples are solved in parallel, and only the summary statistics of the results are kept.
+ *
+ * Usage: dispersion_analysis [configuration file] [number of samples]
+ */
+int main(int argc, char* argv[]) {
+
+	const char* configPath = argc>1 ? argv[1] : "examples/RD-275.cfg";
+	int samples = argc>2 ? atoi(argv[2]) : 2000;
+
+	util::Log::createLog("ROOT")->
+		addLogger(new util::FileLogger("", 10*1024));
+
+	// Initialize thermodatabase
+	initThermoDatabase(THERMO_DATABASE_OPTION_LAZY);
+
+	// Initialize configuration file object
+	thermo::input::ConfigFile* data = new thermo::input::ConfigFile(configPath);
+
+	// Read configuration file
+	data->read();
+
+	// Nominal O/F weight ratio and chamber pressure (Pa) of the engine
+	double r = 2.67;
+	double pc = thermo::input::Pressure::convert(15.7, thermo::input::Pressure::MPa, thermo::input::Pressure::Pa);
+
+	// Use all hardware threads
+	DispersionAnalysis analysis(data);
+	analysis.addNormal(MONTE_CARLO_OF_RATIO, r, 0.02*r);
+	analysis.addNormal(MONTE_CARLO_CHAMBER_PRESSURE, pc, 0.01*pc);
+	analysis.addUniform(MONTE_CARLO_OXIDIZER_TEMPERATURE, 283, 303);
+	analysis.addUniform(MONTE_CARLO_FUEL_TEMPERATURE, 283, 303);
+	analysis.addTriangular(MONTE_CARLO_REACTION_EFFICIENCY, 0.97, 0.985, 0.995);
+
+	// Delivered Isp at sea level
+	analysis.setAmbientPressure(CONST_ATM);
+
+	analysis.run(samples);
+
+	printf("# %u samples solved, %u failed\n", (unsigned int)analysis.getSamplesNo(), (unsigned int)analysis.getFailedNo());
+
+	printStatistics("Is, s", analysis.getStatistics(MONTE_CARLO_IS), CONST_G);
+	printStatistics("T_c, K", analysis.getStatistics(MONTE_CARLO_T_C), 1);
+	if (analysis.getStatistics(MONTE_CARLO_MDOT).getMax()>0) {
+		printStatistics("mdot, kg/s", analysis.getStatistics(MONTE_CARLO_MDOT), 1);
+	}
+
+	delete data;
+
+	util::Log::finalize();
+
+	return 0;
+}
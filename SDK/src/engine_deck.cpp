@@ -0,0 +1,255 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "engine_deck.hpp"
+#include "performance_curve.hpp"
+#include "sweep.hpp"
+#include "threadpool.hpp"
+
+EngineDeckBuilder::EngineDeckBuilder(thermo::input::ConfigFile* data, int threads) :
+	data(data),
+	threads(threads),
+	correctionFactors(true),
+	flowSeparation(true),
+	solved(0) {
+}
+
+void EngineDeckBuilder::setAxis(EngineDeckAxis axis, const std::vector<double>& values) {
+	axes[axis] = values;
+	std::sort(axes[axis].begin(), axes[axis].end());
+	axes[axis].erase(std::unique(axes[axis].begin(), axes[axis].end()), axes[axis].end());
+}
+
+bool EngineDeckBuilder::solvePoint(thermo::input::ConfigFile* config, size_t i, size_t j, float* out, double* nominal) const {
+	if (!axes[ENGINE_DECK_OF_RATIO].empty()) {
+		setSweepAxisValue(config, SWEEP_AXIS_OF_RATIO, grid[ENGINE_DECK_OF_RATIO][i]);
+	}
+	if (!axes[ENGINE_DECK_CHAMBER_PRESSURE].empty()) {
+		setSweepAxisValue(config, SWEEP_AXIS_CHAMBER_PRESSURE, grid[ENGINE_DECK_CHAMBER_PRESSURE][j]);
+	}
+
+	const std::vector<double>& throttles = grid[ENGINE_DECK_THROTTLE];
+	const std::vector<double>& pa = grid[ENGINE_DECK_AMBIENT_PRESSURE];
+
+	double phi = correctionFactors ? 0 : 1;
+	double pa_max = flowSeparation ? std::max(pa.back(), 0.0) : 0;
+
+	performance::TheoreticalPerformance* performance = NULL;
+	performance::ThrottlingPerformance* throttlingPerformance = NULL;
+	try {
+		performance = new performance::TheoreticalPerformance(config, false);
+		performance->solve();
+
+		double mdot = getEngineMdot(performance, correctionFactors);
+
+		PerformanceCurve curve;
+		if (1==throttles.size() && 1.0==throttles[0]) {
+			curve = PerformanceCurve(performance, phi, mdot, pa_max);
+		} else {
+			throttlingPerformance = new performance::ThrottlingPerformance(performance, throttles[0]);
+			curve = PerformanceCurve(throttlingPerformance, throttles, phi, mdot, pa_max);
+		}
+
+		std::vector<double> throttle(pa.size()), Is(pa.size()), thrust(pa.size());
+		for (size_t k=0; k<throttles.size(); ++k) {
+			std::fill(throttle.begin(), throttle.end(), throttles[k]);
+			curve.evaluate(&pa[0], &throttle[0], pa.size(), &Is[0], &thrust[0]);
+
+			float* v = out + k*pa.size()*ENGINE_DECK_VALUES_NO;
+			for (size_t l=0; l<pa.size(); ++l) {
+				v[l*ENGINE_DECK_VALUES_NO + ENGINE_DECK_IS] = (float)Is[l];
+				v[l*ENGINE_DECK_VALUES_NO + ENGINE_DECK_THRUST] = (float)thrust[l];
+			}
+		}
+
+		if (nominal) {
+			nominal[ENGINE_DECK_OF_RATIO] = performance->getPropellant()->getKm();
+			nominal[ENGINE_DECK_CHAMBER_PRESSURE] = performance->getChamber()->getReaction(0)->getP();
+		}
+
+	} catch (const std::exception& ex) {
+		util::Log::warnf("DECK", "Could not solve point r[%u], pc[%u]: %s%s", (unsigned int)i, (unsigned int)j, ex.what(), CR);
+		delete throttlingPerformance;
+		delete performance;
+		return false;
+	}
+
+	delete throttlingPerformance;
+	delete performance;
+
+	return true;
+}
+
+/**
+ * Task of the worker thread: solves one pair of O/F ratio and chamber pressure using the configuration of the thread.
+ */
+struct EngineDeckTask {
+	const EngineDeckBuilder* builder;
+	WorkerConfigs* configs;
+	size_t pressures;					// number of chamber pressures
+	size_t stride;						// values per pair
+	float* table;
+	std::atomic<size_t> solved;
+
+	// O/F ratio and chamber pressure of the first pair, for the axes which are not varied
+	double nominal[2];
+
+	void operator()(size_t task, int worker) {
+		if (builder->solvePoint(configs->get(worker), task/pressures, task%pressures, table + task*stride, 0==task ? nominal : NULL)) {
+			++solved;
+		}
+	}
+};
+
+void EngineDeckBuilder::run() {
+	for (int a=0; a<ENGINE_DECK_AXES_NO; ++a) {
+		grid[a] = axes[a];
+	}
+	if (grid[ENGINE_DECK_OF_RATIO].empty()) {
+		grid[ENGINE_DECK_OF_RATIO].push_back(std::numeric_limits<double>::quiet_NaN());
+	}
+	if (grid[ENGINE_DECK_CHAMBER_PRESSURE].empty()) {
+		grid[ENGINE_DECK_CHAMBER_PRESSURE].push_back(std::numeric_limits<double>::quiet_NaN());
+	}
+	if (grid[ENGINE_DECK_THROTTLE].empty()) {
+		grid[ENGINE_DECK_THROTTLE].push_back(1.0);
+	}
+	if (grid[ENGINE_DECK_AMBIENT_PRESSURE].empty()) {
+		grid[ENGINE_DECK_AMBIENT_PRESSURE].push_back(0);
+	}
+
+	size_t pairs = grid[ENGINE_DECK_OF_RATIO].size()*grid[ENGINE_DECK_CHAMBER_PRESSURE].size();
+	size_t stride = grid[ENGINE_DECK_THROTTLE].size()*grid[ENGINE_DECK_AMBIENT_PRESSURE].size()*ENGINE_DECK_VALUES_NO;
+
+	table.assign(pairs*stride, std::numeric_limits<float>::quiet_NaN());
+
+	ThreadPool pool(threads);
+
+	WorkerConfigs configs(data);
+	configs.prepare(pool.getThreads());
+
+	EngineDeckTask task;
+	task.builder = this;
+	task.configs = &configs;
+	task.pressures = grid[ENGINE_DECK_CHAMBER_PRESSURE].size();
+	task.stride = stride;
+	task.table = &table[0];
+	task.solved = 0;
+	task.nominal[ENGINE_DECK_OF_RATIO] = task.nominal[ENGINE_DECK_CHAMBER_PRESSURE] = std::numeric_limits<double>::quiet_NaN();
+
+	pool.run(pairs, task);
+
+	solved = task.solved;
+
+	// The axes which are not varied get the values of the configuration
+	if (axes[ENGINE_DECK_OF_RATIO].empty()) {
+		grid[ENGINE_DECK_OF_RATIO][0] = task.nominal[ENGINE_DECK_OF_RATIO];
+	}
+	if (axes[ENGINE_DECK_CHAMBER_PRESSURE].empty()) {
+		grid[ENGINE_DECK_CHAMBER_PRESSURE][0] = task.nominal[ENGINE_DECK_CHAMBER_PRESSURE];
+	}
+
+	util::Log::printf("DECK", "Engine deck: %u of %u points solved%s", (unsigned int)solved, (unsigned int)pairs, CR);
+}
+
+bool EngineDeckBuilder::write(const char* path) const {
+	if (table.empty()) {
+		return false;
+	}
+
+	EngineDeckHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, engineDeckMagic, sizeof(header.magic));
+	header.version = ENGINE_DECK_VERSION;
+	header.byteOrder = 0x01020304;
+	header.axesNo = ENGINE_DECK_AXES_NO;
+	header.valuesNo = ENGINE_DECK_VALUES_NO;
+
+	std::vector<double> values;
+	for (int a=0; a<ENGINE_DECK_AXES_NO; ++a) {
+		header.size[a] = (uint32_t)grid[a].size();
+		values.insert(values.end(), grid[a].begin(), grid[a].end());
+	}
+	header.axesOffset = sizeof(header);
+	header.dataOffset = header.axesOffset + values.size()*sizeof(double);
+	header.fileSize = header.dataOffset + table.size()*sizeof(float);
+
+	// Write the temporary file and rename it, so that the readers never map incomplete deck
+	std::string target = path;
+	char suffix[32];
+#ifdef _WIN32
+	sprintf(suffix, ".%lu", (unsigned long)GetCurrentProcessId());
+#else
+	sprintf(suffix, ".%lu", (unsigned long)getpid());
+#endif
+	std::string temporary = target + suffix;
+
+	FILE* f = fopen(temporary.c_str(), "wb");
+	if (!f) {
+		return false;
+	}
+	bool ok = 1==fwrite(&header, sizeof(header), 1, f)
+		&& values.size()==fwrite(&values[0], sizeof(double), values.size(), f)
+		&& table.size()==fwrite(&table[0], sizeof(float), table.size(), f);
+	ok = 0==fclose(f) && ok;
+
+#ifdef _WIN32
+	// rename() does not replace existing file on Windows
+	if (ok) {
+		remove(target.c_str());
+	}
+#endif
+
+	if (!ok || 0!=rename(temporary.c_str(), target.c_str())) {
+		remove(temporary.c_str());
+		util::Log::errorf("DECK", "Could not write engine deck %s%s", path, CR);
+		return false;
+	}
+
+	return true;
+}
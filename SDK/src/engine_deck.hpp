@@ -0,0 +1,122 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_ENGINE_DECK_HPP_
+#define EXAMPLES_ENGINE_DECK_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "engine_deck_reader.hpp"
+
+/**
+ * Builder of the engine deck: the table of delivered specific impulse and thrust on the grid
+ * of O/F ratio, chamber pressure, throttle value and ambient pressure (see EngineDeckAxis),
+ * which is written to the file read by EngineDeck.
+ *
+ * Each pair of O/F ratio and chamber pressure is solved on the thread pool, with its own copy of the configuration.
+ * The throttle values are solved by one ThrottlingPerformance of the pair, and the ambient pressures are
+ * evaluated from its PerformanceCurve, so the ambient pressure axis doesn't add solutions.
+ *
+ * Axes which are not set have the single value taken from the configuration (O/F ratio, chamber pressure),
+ * 1 (throttle value) or 0 (ambient pressure).
+ */
+class EngineDeckBuilder {
+private:
+	thermo::input::ConfigFile* data;
+	int threads;
+
+	std::vector<double> axes[ENGINE_DECK_AXES_NO];		// as set
+	std::vector<double> grid[ENGINE_DECK_AXES_NO];		// used by the last run()
+	bool correctionFactors;
+	bool flowSeparation;
+
+	std::vector<float> table;
+	size_t solved;
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	EngineDeckBuilder(thermo::input::ConfigFile* data, int threads = 0);
+
+	/**
+	 * Sets the values of the axis. Values are sorted, and duplicates are removed. Pressure values are in Pa.
+	 */
+	void setAxis(EngineDeckAxis axis, const std::vector<double>& values);
+
+	/**
+	 * Returns the values of the axis used by the last run(), including the single value of the axis which is not set.
+	 */
+	const std::vector<double>& getAxisValues(EngineDeckAxis axis) const {
+		return grid[axis];
+	}
+
+	/**
+	 * @param correctionFactors if true (default), apply the performance correction factor (see CorrectionFactors) of each point
+	 */
+	void setCorrectionFactors(bool correctionFactors) {
+		this->correctionFactors = correctionFactors;
+	}
+
+	/**
+	 * @param flowSeparation if true (default), consider the flow separation up to the maximum ambient pressure
+	 */
+	void setFlowSeparation(bool flowSeparation) {
+		this->flowSeparation = flowSeparation;
+	}
+
+	/**
+	 * Solves all the points of the grid. The points which could not be solved are NaN.
+	 */
+	void run();
+
+	/**
+	 * Returns the number of the pairs of O/F ratio and chamber pressure solved by the last run().
+	 */
+	size_t getSolvedNo() const {
+		return solved;
+	}
+
+	/**
+	 * Solves one pair of O/F ratio and chamber pressure. Used by the worker threads.
+	 *
+	 * @param config configuration which is modified according to the pair
+	 * @param out table of the throttle values and ambient pressures of the pair
+	 * @param nominal array receiving O/F ratio and chamber pressure of the solved problem, or NULL
+	 * @return false if the pair could not be solved
+	 */
+	bool solvePoint(thermo::input::ConfigFile* config, size_t i, size_t j, float* out, double* nominal = NULL) const;
+
+	/**
+	 * Writes the engine deck file.
+	 *
+	 * @return false if the file could not be written
+	 */
+	bool write(const char* path) const;
+};
+
+#endif /* EXAMPLES_ENGINE_DECK_HPP_ */
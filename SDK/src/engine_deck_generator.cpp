@@ -0,0 +1,115 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "database.hpp"
+#include "engine_deck.hpp"
+#include "engine_deck_reader.hpp"
+
+/**
+ * This example builds the engine deck of rocket engine: delivered Isp and thrust on the grid of O/F ratio,
+ * throttle value and ambient pressure, which is written to the binary file. The file is read back by
+ * the header-only EngineDeck reader (engine_deck_reader.hpp), which can be used by the simulators
+ * without the SDK.
+ *
+ * Usage: engine_deck_generator [configuration file] [engine deck file]
+ */
+int main(int argc, char* argv[]) {
+
+	const char* configPath = argc>1 ? argv[1] : "examples/RD-170_altitude.cfg";
+	const char* deckPath = argc>2 ? argv[2] : "RD-170.deck";
+
+	util::Log::createLog("ROOT")->
+		addLogger(new util::FileLogger("", 10*1024));
+
+	// Initialize thermodatabase
+	initThermoDatabase(THERMO_DATABASE_OPTION_LAZY);
+
+	// Initialize configuration file object
+	thermo::input::ConfigFile* data = new thermo::input::ConfigFile(configPath);
+
+	// Read configuration file
+	data->read();
+
+	// Array with different values of O/F weight ratio
+	double r[] = {2.4, 2.5, 2.6, 2.7, 2.8};
+
+	// Array with different throttle values
+	double throttle[] = {0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0};
+
+	// Ambient pressure from vacuum to sea level
+	std::vector<double> pa;
+	for (int i=0; i<=20; ++i) {
+		pa.push_back(CONST_ATM*i/20.);
+	}
+
+	// Use all hardware threads; chamber pressure is taken from the configuration
+	EngineDeckBuilder builder(data);
+	builder.setAxis(ENGINE_DECK_OF_RATIO, std::vector<double>(r, r + sizeof(r)/sizeof(r[0])));
+	builder.setAxis(ENGINE_DECK_THROTTLE, std::vector<double>(throttle, throttle + sizeof(throttle)/sizeof(throttle[0])));
+	builder.setAxis(ENGINE_DECK_AMBIENT_PRESSURE, pa);
+
+	builder.run();
+
+	if (!builder.write(deckPath)) {
+		printf("Could not write %s\n", deckPath);
+		delete data;
+		util::Log::finalize();
+		return 1;
+	}
+
+	delete data;
+
+	util::Log::finalize();
+
+	// Read the deck as the simulator would do
+	EngineDeck deck;
+	if (!deck.open(deckPath)) {
+		printf("Could not open %s\n", deckPath);
+		return 1;
+	}
+
+	double pc = deck.getAxisValues(ENGINE_DECK_CHAMBER_PRESSURE)[0];
+
+	// Print out table header
+	printf("#%4s %8s %8s %8s %10s\n", "r", "throttle", "pa,atm", "Is,s", "F,kN");
+
+	for (double ri=2.45; ri<2.8; ri+=0.1) {
+		for (double ti=0.45; ti<1.0; ti+=0.2) {
+			for (double h=0; h<=1.0; h+=0.25) {
+				double Is, thrust;
+				deck.lookup(ri, pc, ti, h*CONST_ATM, Is, thrust);
+				printf(" %4.2f %8.2f %8.2f %8.2f %10.2f\n", ri, ti, h, Is/CONST_G, thrust/1000.);
+			}
+		}
+	}
+
+	return 0;
+}
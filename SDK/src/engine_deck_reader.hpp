@@ -0,0 +1,305 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_ENGINE_DECK_READER_HPP_
+#define EXAMPLES_ENGINE_DECK_READER_HPP_
+
+/*
+ * Header-only reader of the engine deck files written by EngineDeckBuilder (see engine_deck.hpp).
+ * It depends on the C++ standard library and the OS only, so it can be used in the simulators
+ * which don't link the SDK.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Version of the engine deck file format. Files written with any other version are rejected.
+ */
+#define ENGINE_DECK_VERSION 1
+
+/**
+ * Axes of the engine deck, in the order of the dimensions of the table.
+ */
+enum EngineDeckAxis {
+	ENGINE_DECK_OF_RATIO = 0,			// O/F weight ratio
+	ENGINE_DECK_CHAMBER_PRESSURE = 1,	// nominal chamber pressure, Pa
+	ENGINE_DECK_THROTTLE = 2,			// throttle value
+	ENGINE_DECK_AMBIENT_PRESSURE = 3,	// ambient pressure, Pa
+
+	ENGINE_DECK_AXES_NO = 4
+};
+
+/**
+ * Values of the engine deck at each node of the table.
+ */
+enum EngineDeckValue {
+	ENGINE_DECK_IS = 0,					// delivered specific impulse, m/s
+	ENGINE_DECK_THRUST = 1,				// thrust, N
+
+	ENGINE_DECK_VALUES_NO = 2
+};
+
+/**
+ * Header of the engine deck file. The file consists of the header, the values of the axes (double, one after another
+ * in the order of EngineDeckAxis) at axesOffset, and the table (float, ENGINE_DECK_VALUES_NO values per node,
+ * the last axis varying fastest) at dataOffset. All numbers are in the byte order of the machine which has written the file.
+ */
+struct EngineDeckHeader {
+	char magic[8];								// "RPADECK\0"
+	uint32_t version;							// ENGINE_DECK_VERSION
+	uint32_t byteOrder;							// 0x01020304
+	uint32_t axesNo;							// ENGINE_DECK_AXES_NO
+	uint32_t valuesNo;							// ENGINE_DECK_VALUES_NO
+	uint32_t size[ENGINE_DECK_AXES_NO];			// number of values of each axis
+	uint64_t axesOffset;
+	uint64_t dataOffset;
+	uint64_t fileSize;
+};
+
+static const char engineDeckMagic[8] = {'R', 'P', 'A', 'D', 'E', 'C', 'K', 0};
+
+/**
+ * Engine deck mapped into memory.
+ *
+ * lookup() interpolates multilinearly between the nodes of the table. It doesn't allocate memory, and the number
+ * of operations doesn't depend on the arguments: the intervals are found by the binary search of fixed length
+ * with conditional moves, and all the 16 corners of the cell are summed with weights. The arguments out of
+ * the range of the axes are clamped. The object can be used by several threads simultaneously.
+ */
+class EngineDeck {
+private:
+	const char* map;
+	size_t mapSize;
+
+	const double* axes[ENGINE_DECK_AXES_NO];
+	uint32_t size[ENGINE_DECK_AXES_NO];
+	size_t stride[ENGINE_DECK_AXES_NO];			// in nodes
+	const float* data;
+
+	EngineDeck(const EngineDeck&);
+	EngineDeck& operator=(const EngineDeck&);
+
+	/**
+	 * Finds the interval of the axis and the interpolation weight of its upper node.
+	 */
+	void locate(int axis, double x, size_t& lower, size_t& upper, double& t) const {
+		const double* v = axes[axis];
+		size_t n = size[axis];
+
+		// Largest i such that v[i]<=x, or 0
+		size_t i = 0;
+		for (size_t len=n; len>1; ) {
+			size_t half = len/2;
+			i = x>=v[i+half] ? i + half : i;
+			len -= half;
+		}
+
+		// Parenthesized so that min and max macros of windows.h are not expanded
+		size_t j = (std::min)(i + 1, n - 1);
+		double dv = v[j] - v[i];
+		t = dv>0 ? (x - v[i])/dv : 0;
+		t = (std::min)((std::max)(t, 0.0), 1.0);
+
+		lower = i*stride[axis];
+		upper = j*stride[axis];
+	}
+
+	bool validate() const {
+		if (mapSize<sizeof(EngineDeckHeader)) {
+			return false;
+		}
+
+		const EngineDeckHeader* header = reinterpret_cast<const EngineDeckHeader*>(map);
+		if (0!=memcmp(header->magic, engineDeckMagic, sizeof(engineDeckMagic))
+				|| ENGINE_DECK_VERSION!=header->version
+				|| 0x01020304!=header->byteOrder
+				|| ENGINE_DECK_AXES_NO!=header->axesNo
+				|| ENGINE_DECK_VALUES_NO!=header->valuesNo
+				|| mapSize!=header->fileSize
+				|| 0!=header->axesOffset%sizeof(double)
+				|| 0!=header->dataOffset%sizeof(float)) {
+			return false;
+		}
+
+		uint64_t axesSize = 0;
+		uint64_t nodes = 1;
+		for (int a=0; a<ENGINE_DECK_AXES_NO; ++a) {
+			if (0==header->size[a]) {
+				return false;
+			}
+			axesSize += header->size[a];
+			nodes *= header->size[a];
+		}
+
+		return header->axesOffset + axesSize*sizeof(double)<=header->dataOffset
+			&& header->dataOffset + nodes*ENGINE_DECK_VALUES_NO*sizeof(float)<=header->fileSize;
+	}
+
+public:
+	EngineDeck() :
+		map(NULL), mapSize(0), data(NULL) {
+	}
+
+	~EngineDeck() {
+		close();
+	}
+
+	/**
+	 * Maps the file into memory.
+	 *
+	 * @return false if the file could not be mapped, or it is not an engine deck of supported version
+	 */
+	bool open(const char* path) {
+		close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (INVALID_HANDLE_VALUE==file) {
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		HANDLE mapping = NULL;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart>0) {
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		}
+		CloseHandle(file);
+		if (!mapping) {
+			return false;
+		}
+		map = reinterpret_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		CloseHandle(mapping);
+		if (!map) {
+			return false;
+		}
+		mapSize = (size_t)fileSize.QuadPart;
+#else
+		int fd = ::open(path, O_RDONLY);
+		if (fd<0) {
+			return false;
+		}
+		struct stat st;
+		void* p = MAP_FAILED;
+		if (0==fstat(fd, &st) && st.st_size>0) {
+			p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		}
+		::close(fd);
+		if (MAP_FAILED==p) {
+			return false;
+		}
+		map = reinterpret_cast<const char*>(p);
+		mapSize = (size_t)st.st_size;
+#endif
+
+		if (!validate()) {
+			close();
+			return false;
+		}
+
+		const EngineDeckHeader* header = reinterpret_cast<const EngineDeckHeader*>(map);
+		const double* values = reinterpret_cast<const double*>(map + header->axesOffset);
+		for (int a=0; a<ENGINE_DECK_AXES_NO; ++a) {
+			axes[a] = values;
+			size[a] = header->size[a];
+			values += size[a];
+		}
+		stride[ENGINE_DECK_AXES_NO-1] = 1;
+		for (int a=ENGINE_DECK_AXES_NO-2; a>=0; --a) {
+			stride[a] = stride[a+1]*size[a+1];
+		}
+		data = reinterpret_cast<const float*>(map + header->dataOffset);
+
+		return true;
+	}
+
+	void close() {
+		if (map) {
+#ifdef _WIN32
+			UnmapViewOfFile(map);
+#else
+			munmap(const_cast<char*>(map), mapSize);
+#endif
+		}
+		map = NULL;
+		mapSize = 0;
+		data = NULL;
+	}
+
+	bool isOpen() const {
+		return NULL!=map;
+	}
+
+	size_t getSize(EngineDeckAxis axis) const {
+		return size[axis];
+	}
+
+	const double* getAxisValues(EngineDeckAxis axis) const {
+		return axes[axis];
+	}
+
+	/**
+	 * Interpolates delivered specific impulse (m/s) and thrust (N). The deck must be open.
+	 * The results are NaN if any node of the cell could not be solved when the deck was built.
+	 *
+	 * @param r O/F weight ratio
+	 * @param pc nominal chamber pressure, Pa
+	 * @param throttle throttle value
+	 * @param pa ambient pressure, Pa
+	 */
+	void lookup(double r, double pc, double throttle, double pa, double& Is, double& thrust) const {
+		const double x[ENGINE_DECK_AXES_NO] = {r, pc, throttle, pa};
+
+		size_t lower[ENGINE_DECK_AXES_NO], upper[ENGINE_DECK_AXES_NO];
+		double t[ENGINE_DECK_AXES_NO];
+		for (int a=0; a<ENGINE_DECK_AXES_NO; ++a) {
+			locate(a, x[a], lower[a], upper[a], t[a]);
+		}
+
+		Is = 0;
+		thrust = 0;
+		for (unsigned int corner=0; corner<(1u<<ENGINE_DECK_AXES_NO); ++corner) {
+			size_t node = 0;
+			double w = 1;
+			for (int a=0; a<ENGINE_DECK_AXES_NO; ++a) {
+				size_t bit = (corner>>a) & 1;
+				node += lower[a] + bit*(upper[a] - lower[a]);
+				w *= (1 - t[a]) + (double)bit*(2*t[a] - 1);
+			}
+			const float* v = data + node*ENGINE_DECK_VALUES_NO;
+			Is += w*v[ENGINE_DECK_IS];
+			thrust += w*v[ENGINE_DECK_THRUST];
+		}
+	}
+};
+
+#endif /* EXAMPLES_ENGINE_DECK_READER_HPP_ */
@@ -0,0 +1,238 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cmath>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "correction_factors.hpp"
+#include "database.hpp"
+#include "engine_pipeline.hpp"
+#include "performance_cache.hpp"
+
+static uint64_t hashValue(double value, uint64_t checksum) {
+	// +0 and -0 are the same input
+	if (0==value) {
+		value = 0;
+	}
+	return fnv1a(&value, sizeof(value), checksum);
+}
+
+static uint64_t hashFlag(bool value, uint64_t checksum) {
+	unsigned char b = value ? 1 : 0;
+	return fnv1a(&b, sizeof(b), checksum);
+}
+
+EnginePipeline::EnginePipeline(thermo::input::ConfigFile* data, bool applyCorrectionFactors) :
+	data(data),
+	applyCorrectionFactors(applyCorrectionFactors),
+	optimizePropellant(false),
+	performance(NULL),
+	correctionFactors(NULL),
+	chamber(NULL),
+	nozzle(NULL) {
+
+	for (int s=0; s<PIPELINE_STAGES_NO; ++s) {
+		keys[s] = 0;
+		valid[s] = false;
+		runs[s] = 0;
+	}
+}
+
+EnginePipeline::~EnginePipeline() {
+	clear(PIPELINE_PERFORMANCE);
+}
+
+bool EnginePipeline::getKey(EnginePipelineStage stage, uint64_t& key) const {
+	uint64_t checksum = fnv1a(NULL, 0);
+
+	thermo::input::NozzleFlowOptions& flowOptions = data->getNozzleFlowOptions();
+	thermo::input::EngineSize& engineSize = data->getEngineSize();
+	thermo::input::ChamberGeometry& geometry = engineSize.getChamberGeometry();
+
+	switch (stage) {
+	case PIPELINE_PERFORMANCE:
+		if (!getPerformanceCacheKey(data, checksum)) {
+			return false;
+		}
+		checksum = hashFlag(optimizePropellant, checksum);
+		break;
+
+	case PIPELINE_CORRECTION_FACTORS: {
+		checksum = hashFlag(applyCorrectionFactors, checksum);
+		uint64_t factorsKey = getEfficiencyFactorsKey(data);
+		checksum = fnv1a(&factorsKey, sizeof(factorsKey), checksum);
+		break;
+	}
+
+	case PIPELINE_CHAMBER:
+		checksum = hashFlag(engineSize.isThrustSet(), checksum);
+		checksum = hashValue(engineSize.isThrustSet() ? engineSize.getThrust(true) : 0, checksum);
+		checksum = hashFlag(engineSize.isMdotSet(), checksum);
+		checksum = hashValue(engineSize.isMdotSet() ? engineSize.getMdot(true) : 0, checksum);
+		checksum = hashFlag(engineSize.isThroatDSet(), checksum);
+		checksum = hashValue(engineSize.isThroatDSet() ? engineSize.getThroatD(true) : 0, checksum);
+		checksum = hashValue(engineSize.getAmbientPressure(true), checksum);
+		checksum = hashValue(engineSize.getChambersNo(), checksum);
+		checksum = hashValue(geometry.getContractionAngle(), checksum);
+		checksum = hashValue(geometry.getR1ToRtRatio(), checksum);
+		checksum = hashValue(geometry.getR2ToR2maxRatio(), checksum);
+		checksum = hashValue(geometry.getChamberLength(), checksum);
+		checksum = hashFlag(geometry.isCharacteristicLength(), checksum);
+		break;
+
+	case PIPELINE_NOZZLE: {
+		bool conical = flowOptions.isEfficiencyFactorsSet() && flowOptions.getEfficiencyFactors().isConeHalfAngleSet();
+		checksum = hashFlag(conical, checksum);
+		checksum = hashValue(conical ? flowOptions.getEfficiencyFactors().getConeHalfAngle() : 0, checksum);
+		checksum = hashValue(geometry.getR1ToRtRatio(), checksum);
+		checksum = hashValue(geometry.getRnToRtRatio(), checksum);
+		checksum = hashFlag(geometry.isTOC(), checksum);
+		checksum = hashFlag(geometry.isTw_to_T0(), checksum);
+		checksum = hashValue(geometry.isTw_to_T0() ? geometry.getTwToT0() : 0, checksum);
+		checksum = hashFlag(geometry.isTOC_L(), checksum);
+		checksum = hashValue(geometry.isTOC_L() ? geometry.getLe() : 0, checksum);
+		checksum = hashFlag(geometry.isParabolicInitialAngle(), checksum);
+		checksum = hashValue(geometry.isParabolicInitialAngle() ? geometry.getParabolicInitialAngle() : 0, checksum);
+		checksum = hashFlag(geometry.isParabolicExitAngle(), checksum);
+		checksum = hashValue(geometry.isParabolicExitAngle() ? geometry.getParabolicExitAngle() : 0, checksum);
+		break;
+	}
+
+	default:
+		return false;
+	}
+
+	key = checksum;
+	return true;
+}
+
+void EnginePipeline::clear(EnginePipelineStage stage) {
+	// Downstream results refer to the upstream ones, so they are deleted first
+	if (stage<=PIPELINE_NOZZLE) {
+		delete nozzle;
+		nozzle = NULL;
+	}
+	if (stage<=PIPELINE_CHAMBER) {
+		delete chamber;
+		chamber = NULL;
+	}
+	if (stage<=PIPELINE_CORRECTION_FACTORS) {
+		delete correctionFactors;
+		correctionFactors = NULL;
+	}
+	if (stage<=PIPELINE_PERFORMANCE) {
+		delete performance;
+		performance = NULL;
+	}
+
+	for (int s=stage; s<PIPELINE_STAGES_NO; ++s) {
+		valid[s] = false;
+	}
+}
+
+void EnginePipeline::run(EnginePipelineStage stage) {
+	switch (stage) {
+	case PIPELINE_PERFORMANCE:
+		// Species of the modified propellant may have to be loaded
+		loadThermoSpecies(data);
+
+		performance = new performance::TheoreticalPerformance(data, false);
+		if (optimizePropellant && thermo::input::Ratio::fractions!=data->getPropellant().getRatioType()) {
+			performance->optimizeForSpecificImpulse();
+		} else {
+			performance->solve();
+		}
+		break;
+
+	case PIPELINE_CORRECTION_FACTORS:
+		if (applyCorrectionFactors) {
+			correctionFactors = new performance::efficiency::CorrectionFactors(performance);
+		}
+		break;
+
+	case PIPELINE_CHAMBER:
+		chamber = createChamber(performance, correctionFactors);
+		break;
+
+	case PIPELINE_NOZZLE:
+		if (chamber) {
+			nozzle = createNozzle(chamber);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void EnginePipeline::invalidate(EnginePipelineStage stage) {
+	for (int s=stage; s<PIPELINE_STAGES_NO; ++s) {
+		valid[s] = false;
+	}
+}
+
+bool EnginePipeline::isDirty(EnginePipelineStage stage) const {
+	for (int s=0; s<=stage; ++s) {
+		uint64_t key;
+		if (!valid[s] || !getKey((EnginePipelineStage)s, key) || key!=keys[s]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+EnginePipelineStage EnginePipeline::update(EnginePipelineStage last) {
+	EnginePipelineStage first = PIPELINE_STAGES_NO;
+
+	for (int i=0; i<=last && i<PIPELINE_STAGES_NO; ++i) {
+		EnginePipelineStage stage = (EnginePipelineStage)i;
+
+		uint64_t key = 0;
+		bool keyed = getKey(stage, key);
+		if (PIPELINE_STAGES_NO==first) {
+			if (valid[stage] && keyed && key==keys[stage]) {
+				continue;
+			}
+			// This and all the downstream stages have to be re-run
+			first = stage;
+			clear(stage);
+		}
+
+		try {
+			run(stage);
+		} catch (...) {
+			clear(stage);
+			throw;
+		}
+
+		keys[stage] = key;
+		valid[stage] = keyed;
+		++runs[stage];
+	}
+
+	return first;
+}
@@ -0,0 +1,157 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_ENGINE_PIPELINE_HPP_
+#define EXAMPLES_ENGINE_PIPELINE_HPP_
+
+#include <stdint.h>
+#include <string>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+/**
+ * Stages of the engine design, in the order of their dependencies: each stage uses the results of the previous ones.
+ */
+enum EnginePipelineStage {
+	PIPELINE_PERFORMANCE = 0,			// equilibrium solution (propellant, chamber pressure, nozzle flow options)
+	PIPELINE_CORRECTION_FACTORS = 1,	// performance correction factors (efficiency factors)
+	PIPELINE_CHAMBER = 2,				// size and geometry of the chamber (engine size, chamber geometry)
+	PIPELINE_NOZZLE = 3,				// nozzle contour: conical, parabolic or MOC (nozzle geometry)
+
+	PIPELINE_STAGES_NO = 4
+};
+
+/**
+ * Chain of the engine design stages which keeps the results of each stage, and re-runs only the stages whose inputs
+ * have changed, together with the stages downstream of them.
+ *
+ * Inputs of each stage are the fields of the configuration it reads. On update(), the fingerprint (hash) of these
+ * fields is compared with the one the stage has been run for, so that the configuration can be modified directly;
+ * e.g. changing the contraction angle re-runs the chamber and nozzle stages, but not the equilibrium solution.
+ * The stage can also be marked as changed explicitly (see invalidate()), e.g. if the fields which can not be read
+ * back from the configuration have been modified.
+ *
+ * Objects returned by the getters are owned by the pipeline, and valid until the stage is re-run.
+ */
+class EnginePipeline {
+private:
+	thermo::input::ConfigFile* data;
+	bool applyCorrectionFactors;
+	bool optimizePropellant;
+
+	performance::TheoreticalPerformance* performance;
+	performance::efficiency::CorrectionFactors* correctionFactors;
+	design::Chamber* chamber;
+	design::Nozzle* nozzle;
+
+	uint64_t keys[PIPELINE_STAGES_NO];		// fingerprints of the inputs the stages have been run for
+	bool valid[PIPELINE_STAGES_NO];
+	int runs[PIPELINE_STAGES_NO];
+
+	/**
+	 * Calculates the fingerprint of the inputs of the stage.
+	 *
+	 * @return false if the inputs can not be fingerprinted; the stage is re-run on each update then
+	 */
+	bool getKey(EnginePipelineStage stage, uint64_t& key) const;
+
+	void run(EnginePipelineStage stage);
+
+	/**
+	 * Deletes the results of the stage and all the downstream ones.
+	 */
+	void clear(EnginePipelineStage stage);
+
+	EnginePipeline(const EnginePipeline&);
+	EnginePipeline& operator=(const EnginePipeline&);
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 */
+	explicit EnginePipeline(thermo::input::ConfigFile* data, bool applyCorrectionFactors = true);
+
+	~EnginePipeline();
+
+	/**
+	 * Specifies whether the performance correction factors are applied (true by default).
+	 */
+	void setCorrectionFactors(bool applyCorrectionFactors) {
+		this->applyCorrectionFactors = applyCorrectionFactors;
+	}
+
+	/**
+	 * Specifies whether the mixture ratio is optimized for the maximum specific impulse (false by default).
+	 */
+	void setOptimizePropellant(bool optimizePropellant) {
+		this->optimizePropellant = optimizePropellant;
+	}
+
+	/**
+	 * Marks the stage, and all the downstream ones, as changed.
+	 */
+	void invalidate(EnginePipelineStage stage);
+
+	/**
+	 * Returns true if the stage has not been run for the current inputs.
+	 */
+	bool isDirty(EnginePipelineStage stage) const;
+
+	/**
+	 * Re-runs the changed stages up to (and including) the last one.
+	 *
+	 * @return first stage which has been re-run, or PIPELINE_STAGES_NO if all of them were up to date
+	 */
+	EnginePipelineStage update(EnginePipelineStage last = PIPELINE_NOZZLE);
+
+	performance::TheoreticalPerformance* getPerformance() const {
+		return performance;
+	}
+
+	/**
+	 * Returns the correction factors, or NULL if they are not applied.
+	 */
+	performance::efficiency::CorrectionFactors* getCorrectionFactors() const {
+		return correctionFactors;
+	}
+
+	/**
+	 * Returns the chamber, or NULL if the size of the engine is not defined.
+	 */
+	design::Chamber* getChamber() const {
+		return chamber;
+	}
+
+	design::Nozzle* getNozzle() const {
+		return nozzle;
+	}
+
+	/**
+	 * Returns the number of times the stage has been run.
+	 */
+	int getRunsNo(EnginePipelineStage stage) const {
+		return runs[stage];
+	}
+};
+
+#endif /* EXAMPLES_ENGINE_PIPELINE_HPP_ */
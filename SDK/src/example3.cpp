@@ -27,44 +27,7 @@
 #include "thermodynamics/gasdynamics/StandardAtmosphere.hpp"
 
 #include "common.hpp"
-
-performance::equilibrium::NozzleSectionConditions* getFlowSeparation(performance::TheoreticalPerformance* performance, double pa, bool checkFlowSeparation)  {
-
-	if (checkFlowSeparation) {
-
-		// Critical ambient pressure
-		double pa_crit = performance->getPaCrit();
-
-		if (pa>pa_crit) {
-			// If pa>pa_crit, there is a flow separation in the nozzle
-			// Find the location of the flow separation
-
-			thermo::input::NozzleFlowOptions* pFlowOptions = new thermo::input::NozzleFlowOptions(performance->getData()->getNozzleFlowOptions());
-
-			bool checkForFreezing = pFlowOptions->isFreezingConditionsSet() && pFlowOptions->getFreezingConditions().isCalculate();
-
-			thermo::input::NozzleSectionConditions& nozzleSectionConditions = pFlowOptions->getNozzleExitConditions();
-			double condition;
-			performance::frozen::NozzleSectionConditions::CONDITION_TYPE conditionType;
-			if (nozzleSectionConditions.isAreaRatio()) {
-				condition = nozzleSectionConditions.getAreaRatio();
-				conditionType = performance::frozen::NozzleSectionConditions::FR;
-			} else if (nozzleSectionConditions.isPressureRatio()) {
-				condition = nozzleSectionConditions.getPressureRatio();
-				conditionType = performance::frozen::NozzleSectionConditions::pp;
-			} else if (nozzleSectionConditions.isPressure()) {
-				condition = nozzleSectionConditions.getPressure();
-				conditionType = performance::frozen::NozzleSectionConditions::P;
-			}
-
-			return performance->solveNozzleSection(condition, conditionType, checkForFreezing, true, pa, false);
-		}
-
-	}
-
-	return NULL;
-}
-
+#include "flow_separation.hpp"
 
 /**
  * This example calculates the performance of rocket engine at several values of ambient pressure using pre-defined configuration file,
@@ -102,33 +65,35 @@ int main(int argc, char* argv[]) {
 
 	// Get nozzle exit object
 	performance::equilibrium::NozzleSectionConditions* nozzleExit = (throttlingPerformance?throttlingPerformance:performance)->getExitSection();
-	performance::equilibrium::NozzleSectionConditions* flowSeparationSection = NULL;
 
 	int n = 50;
 	double p1 = CONST_ATM;			// Ambient pressure initial value
 	double p2 = CONST_ATM*0.0001;	// Ambient pressure final value
+
+	// Solve the flow separation once for all ambient pressures up to p1, and interpolate it in the loop
+	FlowSeparationTable* flowSeparation = NULL;
+	if (checkFlowSeparation) {
+		flowSeparation = new FlowSeparationTable(throttlingPerformance?throttlingPerformance:performance);
+		flowSeparation->build(p1);
+	}
+
 	for (int i=0; i<=n; ++i) {
 		double pa = p1 + (p2-p1)*(double)i/(double)n;	// Ambient pressure current value
 
-		flowSeparationSection = getFlowSeparation(throttlingPerformance?throttlingPerformance:performance, pa, checkFlowSeparation);
-
 		double Is = 0;
-		if (flowSeparationSection) {
-			// Calculate Isp for nozzle with flow separation.
-			double p2 = flowSeparationSection->getP();
-			double IsH2 = 0.3*(pa - p2)*(flowSeparationSection->getF() - nozzleExit->getF());
-			Is = flowSeparationSection->getIs_H(pa) + IsH2;
+		if (flowSeparation) {
+			// Interpolated Isp for nozzle with flow separation, or Isp for nozzle without flow separation
+			Is = flowSeparation->getIs_H(pa);
 		} else {
 			// Calculate Isp for nozzle without flow separation.
 			Is = nozzleExit->getIs_H(pa);
 		}
 
 		double F = Is*mdot;
-		printf("pa=%8.3f atm, Is=%8.3f m/s, F=%8.3f kN, r=%4.2f %s\n", pa/CONST_ATM, Is, F/1000., throttleValue, NULL!=flowSeparationSection?"(flow separation)":"");
-
-		delete flowSeparationSection;
+		printf("pa=%8.3f atm, Is=%8.3f m/s, F=%8.3f kN, r=%4.2f %s\n", pa/CONST_ATM, Is, F/1000., throttleValue, flowSeparation && flowSeparation->isSeparated(pa)?"(flow separation)":"");
 	}
 
+	delete flowSeparation;
 	delete performance;
 	delete throttlingPerformance;
 	delete data;
@@ -26,7 +26,10 @@
 #include "thermodynamics/dll/Export.hpp"
 #include "thermodynamics/gasdynamics/StandardAtmosphere.hpp"
 
+#include <vector>
+
 #include "common.hpp"
+#include "performance_curve.hpp"
 
 
 /**
@@ -63,9 +66,6 @@ int main(int argc, char* argv[]) {
 		throttlingPerformance = new performance::ThrottlingPerformance(performance, throttleValue);
 	}
 
-	// Get nozzle exit object
-	performance::equilibrium::NozzleSectionConditions* nozzleExit = (throttlingPerformance?throttlingPerformance:performance)->getExitSection();
-
 	// Performance correction factor
 	double phi = 1.0;
 	if (applyCorrectionFactor) {
@@ -75,14 +75,23 @@ int main(int argc, char* argv[]) {
 		delete correctionFactors;
 	}
 
+	// Extract the performance curve (without flow separation), which doesn't need the solver to be evaluated
+	PerformanceCurve curve(throttlingPerformance?throttlingPerformance:performance, phi, mdot, 0);
+
 	int n = 50;
 	double p1 = CONST_ATM;			// Ambient pressure initial value
 	double p2 = CONST_ATM*0.0001;	// Ambient pressure final value
+
+	std::vector<double> pa(n+1), Is(n+1), F(n+1);
+	for (int i=0; i<=n; ++i) {
+		pa[i] = p1 + (p2-p1)*(double)i/(double)n;	// Ambient pressure current value
+	}
+
+	// Evaluate all the samples at once: Is = Is_v*phi - F_e*pa
+	curve.evaluate(&pa[0], pa.size(), &Is[0], &F[0]);
+
 	for (int i=0; i<=n; ++i) {
-		double pa = p1 + (p2-p1)*(double)i/(double)n;	// Ambient pressure current value
-		double Is = nozzleExit->getIs_v()*phi - nozzleExit->getF()*pa;
-		double F = Is*mdot;
-		printf("pa=%8.3f atm, Is=%8.3f m/s, F=%8.3f kN, r=%4.2f\n", pa/CONST_ATM, Is, F/1000., throttleValue);
+		printf("pa=%8.3f atm, Is=%8.3f m/s, F=%8.3f kN, r=%4.2f\n", pa[i]/CONST_ATM, Is[i], F[i]/1000., throttleValue);
 	}
 
 	delete performance;
@@ -27,6 +27,8 @@
 #include "thermodynamics/gasdynamics/StandardAtmosphere.hpp"
 
 #include "common.hpp"
+#include "correction_factors.hpp"
+#include "throttle_schedule.hpp"
 
 performance::equilibrium::NozzleSectionConditions* getFlowSeparation(performance::TheoreticalPerformance* performance, double pa, bool checkFlowSeparation)  {
 
@@ -94,7 +96,10 @@ int main(int argc, char* argv[]) {
 
 	// Solve
 	performance->solve();
-	performance::ThrottlingPerformance* throttlingPerformance = new performance::ThrottlingPerformance(performance, 1.0);
+
+	// Throttled problem, re-solved only when the throttle value changes
+	ThrottleSchedule* schedule = new ThrottleSchedule(performance);
+	CorrectionFactorsCache correctionFactors;
 
 	int n = 50;
 
@@ -112,7 +117,7 @@ int main(int argc, char* argv[]) {
 		double mdot = throttleValue*nominalMdot;
 
 		// Re-calculate throttle performance
-		throttlingPerformance->throttle(throttleValue);
+		performance::TheoreticalPerformance* throttlingPerformance = schedule->throttle(throttleValue);
 
 		// Get nozzle exit object
 		performance::equilibrium::NozzleSectionConditions* nozzleExit = (throttlingPerformance)->getExitSection();
@@ -121,10 +126,10 @@ int main(int argc, char* argv[]) {
 		// Performance correction factor
 		double phi = 1.0;
 		if (applyCorrectionFactor) {
-			// Get performance correction factor
-			performance::efficiency::CorrectionFactors* correctionFactors = new performance::efficiency::CorrectionFactors(throttlingPerformance);
-			phi = correctionFactors->getOverallEfficiency();
-			delete correctionFactors;
+			// Get performance correction factor, recalculated only if the throttle value has changed
+			correctionFactors.attach(throttlingPerformance);
+			correctionFactors.update(throttleValue);
+			phi = correctionFactors.getOverallEfficiency();
 		}
 
 		double Is = 0;
@@ -146,8 +151,8 @@ int main(int argc, char* argv[]) {
 		flowSeparationSection = NULL;
 	}
 
+	delete schedule;
 	delete performance;
-	delete throttlingPerformance;
 	delete data;
 
 	util::Log::finalize();
@@ -0,0 +1,204 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "flow_separation.hpp"
+
+/**
+ * Delivered specific impulse of the nozzle with flow separation, given the separation section.
+ */
+static double getSeparatedIs_H(double pa, double Is_v, double F, double p, double F_e, double phi) {
+	double IsH2 = 0.3*(pa - p)*(F - F_e);
+	return Is_v*phi - F*pa + IsH2;
+}
+
+double FlowSeparationData::getIs_H(double pa, double phi) const {
+	if (pa<=pa_crit || Is_v.size()<2) {
+		// Nozzle without flow separation
+		return Is_v_e*phi - F_e*pa;
+	}
+	return getSeparatedIs_H(pa, Is_v.evaluate(pa), F.evaluate(pa), p.evaluate(pa), F_e, phi);
+}
+
+//*****************************************************************************
+
+FlowSeparationTable::FlowSeparationTable(performance::TheoreticalPerformance* performance) :
+	performance(performance), errorBound(0), solves(0) {
+
+	performance::equilibrium::NozzleSectionConditions* exitSection = performance->getExitSection();
+	data.Is_v_e = exitSection->getIs_v();
+	data.F_e = exitSection->getF();
+
+	data.pa_crit = performance->getPaCrit();
+}
+
+void FlowSeparationTable::solveSection(double pa, Section& section) const {
+	thermo::input::NozzleFlowOptions& flowOptions = performance->getData()->getNozzleFlowOptions();
+
+	bool checkForFreezing = flowOptions.isFreezingConditionsSet() && flowOptions.getFreezingConditions().isCalculate();
+
+	thermo::input::NozzleSectionConditions& nozzleSectionConditions = flowOptions.getNozzleExitConditions();
+	double condition = 0;
+	performance::frozen::NozzleSectionConditions::CONDITION_TYPE conditionType = performance::frozen::NozzleSectionConditions::FR;
+	if (nozzleSectionConditions.isAreaRatio()) {
+		condition = nozzleSectionConditions.getAreaRatio();
+		conditionType = performance::frozen::NozzleSectionConditions::FR;
+	} else if (nozzleSectionConditions.isPressureRatio()) {
+		condition = nozzleSectionConditions.getPressureRatio();
+		conditionType = performance::frozen::NozzleSectionConditions::pp;
+	} else if (nozzleSectionConditions.isPressure()) {
+		condition = nozzleSectionConditions.getPressure();
+		conditionType = performance::frozen::NozzleSectionConditions::P;
+	}
+
+	performance::equilibrium::NozzleSectionConditions* flowSeparationSection = performance->solveNozzleSection(condition, conditionType, checkForFreezing, true, pa, false);
+
+	section.pa = pa;
+	section.Is_v = flowSeparationSection->getIs_v();
+	section.F = flowSeparationSection->getF();
+	section.p = flowSeparationSection->getP();
+
+	delete flowSeparationSection;
+}
+
+void FlowSeparationTable::interpolate(const std::vector<Section>& sections) {
+	std::vector<double> pa(sections.size()), Is_v(sections.size()), F(sections.size()), p(sections.size());
+	for (size_t i=0; i<sections.size(); ++i) {
+		pa[i] = sections[i].pa;
+		Is_v[i] = sections[i].Is_v;
+		F[i] = sections[i].F;
+		p[i] = sections[i].p;
+	}
+
+	data.Is_v.build(pa, Is_v);
+	data.F.build(pa, F);
+	data.p.build(pa, p);
+}
+
+void FlowSeparationTable::build(double pa_max, double tolerance, int nodes, int maxNodes) {
+	data.pa_max = pa_max;
+	errorBound = 0;
+	solves = 0;
+
+	std::vector<Section> sections;
+
+	double pa_crit = data.pa_crit;
+	if (pa_max<=pa_crit) {
+		interpolate(sections);
+		return;
+	}
+
+	nodes = std::max(nodes, 2);
+	for (int i=0; i<nodes; ++i) {
+		Section section;
+		solveSection(pa_crit + (pa_max - pa_crit)*(double)i/(double)(nodes - 1), section);
+		sections.push_back(section);
+		++solves;
+	}
+
+	// The initial intervals are checked in any case
+	maxNodes = std::max(maxNodes, 2*nodes - 1);
+
+	// checked[i] is true if the interval between sections i and i+1 satisfies the tolerance;
+	// error[i] is the error measured at the midpoint of the interval, or of its parent if the interval is not checked yet
+	std::vector<char> checked(sections.size() - 1, 0);
+	std::vector<double> error(sections.size() - 1, 0);
+
+	for (;;) {
+		size_t unchecked = std::count(checked.begin(), checked.end(), 0);
+		if (0==unchecked) {
+			break;
+		}
+
+		if (sections.size() + unchecked>(size_t)maxNodes) {
+			// Refinement is stopped: the error of the remaining intervals is estimated by the error of their parents
+			for (size_t i=0; i<checked.size(); ++i) {
+				if (!checked[i]) {
+					errorBound = std::max(errorBound, error[i]);
+				}
+			}
+			util::Log::warnf("SEPARATION", "Flow separation table has not reached the tolerance %e with %d nodes%s", tolerance, maxNodes, CR);
+			break;
+		}
+
+		interpolate(sections);
+
+		std::vector<Section> next;
+		std::vector<char> nextChecked;
+		std::vector<double> nextError;
+
+		for (size_t i=0; i<sections.size()-1; ++i) {
+			next.push_back(sections[i]);
+
+			if (checked[i]) {
+				nextChecked.push_back(1);
+				nextError.push_back(error[i]);
+				continue;
+			}
+
+			Section section;
+			solveSection(0.5*(sections[i].pa + sections[i+1].pa), section);
+			++solves;
+
+			double IsH = getSeparatedIs_H(section.pa, section.Is_v, section.F, section.p, data.F_e, 1.0);
+			double e = std::fabs(data.getIs_H(section.pa, 1.0) - IsH)/std::fabs(IsH);
+
+			// The midpoint becomes a node in any case; the halves are accepted if the error of the interval is small enough
+			bool accepted = e<=tolerance;
+			if (accepted) {
+				errorBound = std::max(errorBound, e);
+			}
+
+			next.push_back(section);
+			for (int k=0; k<2; ++k) {
+				nextChecked.push_back(accepted ? 1 : 0);
+				nextError.push_back(e);
+			}
+		}
+		next.push_back(sections.back());
+
+		sections.swap(next);
+		checked.swap(nextChecked);
+		error.swap(nextError);
+	}
+
+	interpolate(sections);
+
+	util::Log::printf("SEPARATION", "Flow separation table: %u nodes, %d solves, estimated error %e%s",
+		(unsigned int)data.Is_v.size(), solves, errorBound, CR);
+}
+
+double FlowSeparationTable::getIs_H(double pa, double phi) const {
+	if (pa>data.pa_max && data.isSeparated(pa)) {
+		Section section;
+		solveSection(pa, section);
+		return getSeparatedIs_H(pa, section.Is_v, section.F, section.p, data.F_e, phi);
+	}
+	return data.getIs_H(pa, phi);
+}
@@ -0,0 +1,180 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_FLOW_SEPARATION_HPP_
+#define EXAMPLES_FLOW_SEPARATION_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/dll/Export.hpp"
+
+#include "interpolation.hpp"
+
+/**
+ * Interpolated nozzle flow separation of one solved problem. Plain data: can be copied, and used without the solver.
+ */
+struct FlowSeparationData {
+	double pa_crit;							// critical ambient pressure, Pa
+	double pa_max;							// maximum tabulated ambient pressure, Pa
+
+	// Nozzle exit
+	double Is_v_e;							// vacuum specific impulse, m/s
+	double F_e;								// specific area, m2*s/kg
+
+	MonotoneCubicInterpolation Is_v;		// vacuum specific impulse at the separation section, m/s
+	MonotoneCubicInterpolation F;			// specific area at the separation section, m2*s/kg
+	MonotoneCubicInterpolation p;			// pressure at the separation section, Pa
+
+	FlowSeparationData() :
+		pa_crit(0), pa_max(0), Is_v_e(0), F_e(0) {
+	}
+
+	/**
+	 * Returns true if the flow separates in the nozzle at given ambient pressure (Pa).
+	 */
+	bool isSeparated(double pa) const {
+		return pa>pa_crit;
+	}
+
+	/**
+	 * Returns delivered specific impulse (m/s) at given ambient pressure (Pa).
+	 * Pressures above pa_max are extrapolated; if the table is empty, the flow is considered attached.
+	 *
+	 * @param phi correction factor
+	 */
+	double getIs_H(double pa, double phi) const;
+};
+
+/**
+ * Table of the nozzle flow separation over the range of ambient pressures.
+ *
+ * For each ambient pressure above the critical one (see TheoreticalPerformance::getPaCrit()), the nozzle section
+ * at the location of the flow separation is solved once at build(); queries then interpolate its specific impulse,
+ * specific area and pressure with monotone cubic splines, instead of solving the nozzle section for every sample.
+ *
+ * The table is built adaptively: each interval is checked at its midpoint against the solved section,
+ * and is split until the relative error of the specific impulse is below the tolerance.
+ */
+class FlowSeparationTable {
+private:
+	performance::TheoreticalPerformance* performance;
+
+	FlowSeparationData data;
+
+	double errorBound;
+	int solves;
+
+	struct Section {
+		double pa;
+		double Is_v;
+		double F;
+		double p;
+	};
+
+	/**
+	 * Solves the nozzle section at the location of the flow separation.
+	 */
+	void solveSection(double pa, Section& section) const;
+
+	void interpolate(const std::vector<Section>& sections);
+
+public:
+	/**
+	 * @param performance solved problem (TheoreticalPerformance or ThrottlingPerformance); must exist as long as this object is used
+	 */
+	explicit FlowSeparationTable(performance::TheoreticalPerformance* performance);
+
+	performance::TheoreticalPerformance* getPerformance() const {
+		return performance;
+	}
+
+	/**
+	 * Solves the separation sections for ambient pressures from the critical one to pa_max.
+	 *
+	 * @param pa_max maximum ambient pressure, Pa
+	 * @param tolerance maximum relative error of the specific impulse at the midpoints of the intervals
+	 * @param nodes initial number of nodes
+	 * @param maxNodes maximum number of nodes; refinement is stopped when exceeded
+	 */
+	void build(double pa_max = CONST_ATM, double tolerance = 1e-4, int nodes = 9, int maxNodes = 257);
+
+	double getPaCrit() const {
+		return data.pa_crit;
+	}
+
+	double getPaMax() const {
+		return data.pa_max;
+	}
+
+	/**
+	 * Returns true if the flow separates in the nozzle at given ambient pressure (Pa).
+	 */
+	bool isSeparated(double pa) const {
+		return data.isSeparated(pa);
+	}
+
+	/**
+	 * Returns the interpolated data, which can be used after the solver is deleted.
+	 */
+	const FlowSeparationData& getData() const {
+		return data;
+	}
+
+	/**
+	 * Returns delivered specific impulse (m/s) at given ambient pressure (Pa).
+	 *
+	 * Pressures up to the critical one are calculated for the nozzle without flow separation, pressures within
+	 * the table are interpolated; pressures above pa_max are solved directly.
+	 *
+	 * @param phi correction factor
+	 */
+	double getIs_H(double pa, double phi = 1.0) const;
+
+	/**
+	 * Returns thrust (N) at given ambient pressure (Pa) and mass flow rate (kg/s).
+	 */
+	double getThrust(double pa, double mdot, double phi = 1.0) const {
+		return getIs_H(pa, phi)*mdot;
+	}
+
+	/**
+	 * Returns estimated maximum relative error of the interpolated specific impulse, i.e. the largest error
+	 * observed at the midpoints of the intervals of the final table.
+	 */
+	double getErrorBound() const {
+		return errorBound;
+	}
+
+	size_t getNodesNo() const {
+		return data.Is_v.size();
+	}
+
+	/**
+	 * Returns the number of nozzle sections solved by build().
+	 */
+	int getSolvesNo() const {
+		return solves;
+	}
+};
+
+#endif /* EXAMPLES_FLOW_SEPARATION_HPP_ */
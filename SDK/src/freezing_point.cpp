@@ -0,0 +1,348 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "freezing_point.hpp"
+
+/**
+ * Maximum number of iterations of the Illinois method.
+ */
+static const int MAX_ITERATIONS = 100;
+
+/**
+ * Finds the root of the function f(u), bracketed by [a, b], by the Illinois method.
+ * Iterations are finished when the bracket in terms of area ratio Fr=exp(u^2) is smaller than tolerance.
+ */
+template<class Function>
+static double solveIllinois(const Function& f, double a, double b, double fa, double fb, double tolerance, int& iterationsNo) {
+	int side = 0;
+	double c = a;
+	for (iterationsNo=0; iterationsNo<MAX_ITERATIONS; ++iterationsNo) {
+		c = (a*fb - b*fa)/(fb - fa);
+		if (fabs(exp(b*b) - exp(a*a))<tolerance) {
+			break;
+		}
+
+		double fc = f(c);
+		if (0==fc) {
+			break;
+		} else if ((fc>0)==(fb>0)) {
+			b = c;
+			fb = fc;
+			if (-1==side) {
+				fa /= 2;
+			}
+			side = -1;
+		} else {
+			a = c;
+			fa = fc;
+			if (1==side) {
+				fb /= 2;
+			}
+			side = 1;
+		}
+	}
+	return c;
+}
+
+/**
+ * Isentropic expansion of calorically perfect gas from given section.
+ */
+class FrozenExpansion {
+private:
+	const NozzleStation& origin;
+
+	double k;
+	double R;
+	double c;			// (k-1)/2
+	double e;			// (k+1)/(2*(k-1))
+	double M;			// Mach number at the origin
+	double lnA;			// ln(A/A*) at the origin
+
+	double getLnA(double M) const {
+		return e*log((1 + c*M*M)/(1 + c)) - log(M);
+	}
+
+public:
+	explicit FrozenExpansion(const NozzleStation& origin) :
+		origin(origin) {
+
+		k = origin.k;
+		R = origin.p/(origin.rho*origin.T);
+		c = (k - 1)/2;
+		e = (k + 1)/(2*(k - 1));
+		M = origin.w/sqrt(k*R*origin.T);
+		lnA = getLnA(M);
+	}
+
+	/**
+	 * Solves the supersonic section at area ratio Fr>=origin.Fr.
+	 *
+	 * @param M initial guess of Mach number; replaced with the solution
+	 */
+	void solve(double Fr, double& M, NozzleStation& station) const {
+		double target = lnA + log(Fr/origin.Fr);
+
+		// Bracket the supersonic root, then safeguarded Newton's method
+		double lo = 1, hi = std::max(2.0, M);
+		while (getLnA(hi)<target) {
+			lo = hi;
+			hi *= 2;
+		}
+		M = std::min(std::max(M, lo), hi);
+		for (int i=0; i<MAX_ITERATIONS; ++i) {
+			double g = getLnA(M) - target;
+			if (g>0) {
+				hi = M;
+			} else {
+				lo = M;
+			}
+
+			double next = M - g*M*(1 + c*M*M)/(M*M - 1);
+			if (!(next>lo && next<hi)) {
+				next = (lo + hi)/2;
+			}
+
+			bool converged = fabs(next - M)<1e-12*M;
+			M = next;
+			if (converged) {
+				break;
+			}
+		}
+
+		station.Fr = Fr;
+		station.M = M;
+		station.T = origin.T*(1 + c*this->M*this->M)/(1 + c*M*M);
+		station.p = origin.p*pow(station.T/origin.T, k/(k - 1));
+		station.rho = station.p/(R*station.T);
+		station.w = M*sqrt(k*R*station.T);
+		station.k = k;
+		station.F = origin.F*Fr/origin.Fr;
+		station.Is = station.w;
+		station.Is_v = station.w + station.p*station.F;
+	}
+};
+
+BrayCriterion::BrayCriterion(double A, double n, double r_t, double alpha) :
+	A(A),
+	n(n),
+	r_t(r_t),
+	tanAlpha(tan(alpha)) {
+}
+
+double BrayCriterion::evaluate(const NozzleStation& station, double dlnrho_dFr) const {
+	// Conical nozzle: r=r_t*sqrt(Fr), dr/dx=tan(alpha)
+	double dFr_dx = 2*sqrt(station.Fr)*tanAlpha/r_t;
+
+	double recombination = A*pow(station.T, -n)*station.rho*station.rho;
+	double expansion = station.w*fabs(dlnrho_dFr)*dFr_dx;
+
+	return log(recombination/expansion);
+}
+
+/**
+ * Criterion of the freezing as function of u=sqrt(ln(Fr)).
+ */
+class CriterionFunction {
+private:
+	const NozzleStationTable& table;
+	const FreezingCriterion& criterion;
+	double h;
+
+	double getLnRho(double u) const {
+		NozzleStation station;
+		table.get(exp(u*u), performance::frozen::NozzleSectionConditions::FR, station);
+		return log(station.rho);
+	}
+
+public:
+	CriterionFunction(const NozzleStationTable& table, const FreezingCriterion& criterion) :
+		table(table),
+		criterion(criterion) {
+
+		double u1 = sqrt(log(table.getStation(0).Fr));
+		double u2 = sqrt(log(table.getStation(table.getStationsNo() - 1).Fr));
+		h = 1e-4*(u2 - u1);
+	}
+
+	double operator()(double u) const {
+		NozzleStation station;
+		table.get(exp(u*u), performance::frozen::NozzleSectionConditions::FR, station);
+
+		// Central difference, one-sided at the ends of the table
+		double u1 = std::max(u - h, sqrt(log(table.getStation(0).Fr)));
+		double u2 = std::min(u + h, sqrt(log(table.getStation(table.getStationsNo() - 1).Fr)));
+		double dlnrho_dFr = (getLnRho(u2) - getLnRho(u1))/(exp(u2*u2) - exp(u1*u1));
+
+		return criterion.evaluate(station, dlnrho_dFr);
+	}
+};
+
+/**
+ * Difference between vacuum specific impulse of the flow frozen at Fr_f=exp(u^2) and target one.
+ */
+class IspFunction {
+private:
+	const NozzleStationTable& table;
+	double Fr_e;
+	double Is_v;
+
+public:
+	IspFunction(const NozzleStationTable& table, double Fr_e, double Is_v) :
+		table(table),
+		Fr_e(Fr_e),
+		Is_v(Is_v) {
+	}
+
+	double operator()(double u) const {
+		NozzleStation freezing, exit;
+		table.get(exp(u*u), performance::frozen::NozzleSectionConditions::FR, freezing);
+
+		FrozenExpansion expansion(freezing);
+		double M = freezing.M;
+		expansion.solve(std::max(Fr_e, freezing.Fr), M, exit);
+
+		return exit.Is_v - Is_v;
+	}
+};
+
+/**
+ * Orders the indices of the sections by area ratio.
+ */
+struct AreaRatioLess {
+	const double* Fr;
+
+	explicit AreaRatioLess(const double* Fr) :
+		Fr(Fr) {
+	}
+
+	bool operator()(int a, int b) const {
+		return Fr[a]<Fr[b];
+	}
+};
+
+FreezingPointSearch::FreezingPointSearch(performance::TheoreticalPerformance* performance) :
+	table(performance, true),
+	tolerance(1e-3),
+	iterationsNo(0) {
+}
+
+void FreezingPointSearch::build(double Fr_max, int stations) {
+	table.build(Fr_max, stations);
+}
+
+double FreezingPointSearch::find(const FreezingCriterion& criterion) {
+	iterationsNo = 0;
+	if (table.getStationsNo()<2) {
+		return 0;
+	}
+
+	CriterionFunction f(table, criterion);
+
+	// Bracket the first change of sign at the stations; the throat is skipped, since the derivative
+	// of density by area ratio is infinite there
+	size_t first = table.getStation(0).Fr>1 ? 0 : 1;
+	double u1 = sqrt(log(table.getStation(first).Fr));
+	double f1 = f(u1);
+	if (f1<=0) {
+		return table.getStation(first).Fr;
+	}
+	for (size_t i=first+1; i<table.getStationsNo(); ++i) {
+		double u2 = sqrt(log(table.getStation(i).Fr));
+		double f2 = f(u2);
+		if (f2<=0) {
+			double u = 0==f2 ? u2 : solveIllinois(f, u1, u2, f1, f2, tolerance, iterationsNo);
+			return exp(u*u);
+		}
+		u1 = u2;
+		f1 = f2;
+	}
+
+	return 0;
+}
+
+double FreezingPointSearch::find(double Fr_e, double Is_v) {
+	iterationsNo = 0;
+	if (table.getStationsNo()<2) {
+		return 0;
+	}
+
+	IspFunction f(table, Fr_e, Is_v);
+
+	// Vacuum specific impulse grows as the freezing point moves downstream
+	double u1 = sqrt(log(table.getStation(0).Fr));
+	double u2 = sqrt(log(std::min(Fr_e, table.getStation(table.getStationsNo() - 1).Fr)));
+	if (u2<u1) {
+		return 0;
+	}
+
+	double f1 = f(u1);
+	double f2 = f(u2);
+	if (f1>0 || f2<0) {
+		util::Log::warnf("FREEZING", "Target vacuum specific impulse %f m/s is out of range [%f, %f] m/s%s", Is_v, Is_v + f1, Is_v + f2, CR);
+		return 0;
+	}
+
+	double u = solveIllinois(f, u1, u2, f1, f2, tolerance, iterationsNo);
+	return exp(u*u);
+}
+
+bool FreezingPointSearch::march(double Fr_f, const double* Fr, int n, NozzleStation* out) const {
+	NozzleStation freezing;
+	if (!table.get(Fr_f, performance::frozen::NozzleSectionConditions::FR, freezing)) {
+		return false;
+	}
+
+	// March in increasing order of area ratio, each section starting from the solution at the previous one
+	std::vector<int> order(n);
+	for (int i=0; i<n; ++i) {
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), AreaRatioLess(Fr));
+
+	FrozenExpansion expansion(freezing);
+	double M = freezing.M;
+
+	bool result = true;
+	for (int i=0; i<n; ++i) {
+		int j = order[i];
+		if (Fr[j]>Fr_f) {
+			expansion.solve(Fr[j], M, out[j]);
+		} else if (!table.get(Fr[j], performance::frozen::NozzleSectionConditions::FR, out[j])) {
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+void FreezingPointSearch::apply(thermo::input::ConfigFile* data, double Fr_f) {
+	data->getNozzleFlowOptions().setFreezingConditions().setCalculate(true);
+	data->getNozzleFlowOptions().setFreezingConditions().setExpansionRatio(Fr_f);
+}
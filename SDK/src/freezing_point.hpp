@@ -0,0 +1,154 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_FREEZING_POINT_HPP_
+#define EXAMPLES_FREEZING_POINT_HPP_
+
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "station_table.hpp"
+
+/**
+ * Criterion of the freezing of the shifting equilibrium flow in the nozzle. The flow freezes where the criterion
+ * changes sign from positive to negative.
+ */
+class FreezingCriterion {
+public:
+	virtual ~FreezingCriterion() {
+	}
+
+	/**
+	 * @param station equilibrium flow at the section
+	 * @param dlnrho_dFr derivative of the logarithm of density by area ratio at the section
+	 */
+	virtual double evaluate(const NozzleStation& station, double dlnrho_dFr) const = 0;
+};
+
+/**
+ * Bray-type criterion for the conical nozzle: the flow freezes where the rate of three-body recombination
+ * k_r*rho^2, k_r = A*T^-n, falls below the rate of expansion w*|d(ln rho)/dx|. The criterion is the logarithm
+ * of their ratio (the Damkohler number).
+ */
+class BrayCriterion : public FreezingCriterion {
+private:
+	double A;
+	double n;
+	double r_t;
+	double tanAlpha;
+
+public:
+	/**
+	 * @param A rate constant, m6/(kg2*s)*K^n
+	 * @param n temperature exponent of the rate constant
+	 * @param r_t throat radius, m
+	 * @param alpha half-angle of the nozzle, rad
+	 */
+	BrayCriterion(double A, double n, double r_t, double alpha);
+
+	virtual double evaluate(const NozzleStation& station, double dlnrho_dFr) const;
+};
+
+/**
+ * Search of the section of the nozzle where the shifting equilibrium flow is switched to frozen one.
+ *
+ * Both the criterion and the target specific impulse are searched by the Illinois method over
+ * the table of the equilibrium stations, which is solved once; no further problems are solved.
+ * The frozen flow past the freezing point is marched with the composition and the isentropic exponent
+ * of the freezing point, which is exact for calorically perfect frozen mixture.
+ *
+ * The found area ratio can be applied to the configuration (see apply()) to solve the problem exactly.
+ */
+class FreezingPointSearch {
+private:
+	NozzleStationTable table;
+
+	double tolerance;
+
+	int iterationsNo;
+
+public:
+	/**
+	 * @param performance solved problem; must exist as long as this object is used
+	 */
+	explicit FreezingPointSearch(performance::TheoreticalPerformance* performance);
+
+	/**
+	 * Solves the table of equilibrium stations (see NozzleStationTable::build()).
+	 */
+	void build(double Fr_max, int stations = 64);
+
+	const NozzleStationTable& getTable() const {
+		return table;
+	}
+
+	/**
+	 * @param tolerance absolute tolerance of the found area ratio
+	 */
+	void setTolerance(double tolerance) {
+		this->tolerance = tolerance;
+	}
+
+	/**
+	 * Returns the area ratio where the criterion changes sign from positive to negative,
+	 * the smallest supersonic area ratio of the table if the criterion is negative there,
+	 * or 0 if the flow doesn't freeze within the table.
+	 */
+	double find(const FreezingCriterion& criterion);
+
+	/**
+	 * Returns the area ratio where the flow has to freeze so that vacuum specific impulse at given exit area ratio
+	 * is equal to target one (m/s), or 0 if the target can't be reached.
+	 */
+	double find(double Fr_e, double Is_v);
+
+	/**
+	 * Calculates the frozen flow at n sections, the flow being frozen at the area ratio Fr_f.
+	 * The sections upstream of the freezing point are interpolated from the equilibrium stations.
+	 *
+	 * @param Fr array of n area ratios, in any order
+	 * @param out array of n sections
+	 * @return false if the freezing point is out of the range of the table
+	 */
+	bool march(double Fr_f, const double* Fr, int n, NozzleStation* out) const;
+
+	bool march(double Fr_f, const std::vector<double>& Fr, std::vector<NozzleStation>& out) const {
+		out.resize(Fr.size());
+		return Fr.empty() || march(Fr_f, &Fr[0], (int)Fr.size(), &out[0]);
+	}
+
+	/**
+	 * Sets the area ratio of the freezing point in the configuration.
+	 */
+	static void apply(thermo::input::ConfigFile* data, double Fr_f);
+
+	/**
+	 * @return number of iterations of the last search
+	 */
+	int getIterationsNo() const {
+		return iterationsNo;
+	}
+};
+
+#endif /* EXAMPLES_FREEZING_POINT_HPP_ */
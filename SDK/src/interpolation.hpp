@@ -0,0 +1,129 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_INTERPOLATION_HPP_
+#define EXAMPLES_INTERPOLATION_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+/**
+ * Monotone piecewise cubic Hermite interpolation (PCHIP, Fritsch-Carlson).
+ *
+ * The interpolant preserves monotonicity of the data: it does not overshoot between the nodes,
+ * which matters for the tabulated nozzle flow parameters used in place of the solver.
+ * Outside the range of the nodes the end intervals are extrapolated.
+ */
+class MonotoneCubicInterpolation {
+private:
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<double> d;		// derivatives at the nodes
+
+	/**
+	 * One-sided three-point derivative at the end node, limited to keep the interpolant monotone.
+	 */
+	static double getEndDerivative(double h0, double h1, double delta0, double delta1) {
+		double d = ((2*h0 + h1)*delta0 - h0*delta1)/(h0 + h1);
+		if (d*delta0<=0) {
+			return 0;
+		}
+		if (delta0*delta1<0 && std::fabs(d)>std::fabs(3*delta0)) {
+			return 3*delta0;
+		}
+		return d;
+	}
+
+public:
+	/**
+	 * @param x nodes in increasing order
+	 * @param y values at the nodes
+	 */
+	void build(const std::vector<double>& x, const std::vector<double>& y) {
+		this->x = x;
+		this->y = y;
+
+		size_t n = x.size();
+		d.assign(n, 0);
+
+		if (n<2) {
+			return;
+		}
+
+		std::vector<double> h(n - 1), delta(n - 1);
+		for (size_t i=0; i<n-1; ++i) {
+			h[i] = x[i+1] - x[i];
+			delta[i] = (y[i+1] - y[i])/h[i];
+		}
+
+		if (2==n) {
+			d[0] = d[1] = delta[0];
+			return;
+		}
+
+		// Interior nodes: weighted harmonic mean of the slopes, zero at local extrema
+		for (size_t i=1; i<n-1; ++i) {
+			if (delta[i-1]*delta[i]>0) {
+				double w1 = 2*h[i] + h[i-1];
+				double w2 = h[i] + 2*h[i-1];
+				d[i] = (w1 + w2)/(w1/delta[i-1] + w2/delta[i]);
+			}
+		}
+
+		d[0] = getEndDerivative(h[0], h[1], delta[0], delta[1]);
+		d[n-1] = getEndDerivative(h[n-2], h[n-3], delta[n-2], delta[n-3]);
+	}
+
+	size_t size() const {
+		return x.size();
+	}
+
+	double evaluate(double t) const {
+		size_t n = x.size();
+		if (0==n) {
+			return 0;
+		}
+		if (1==n) {
+			return y[0];
+		}
+
+		// Interval containing t; end intervals are used for extrapolation
+		size_t i = std::upper_bound(x.begin(), x.end(), t) - x.begin();
+		i = i<1 ? 0 : std::min(i - 1, n - 2);
+
+		double h = x[i+1] - x[i];
+		double s = (t - x[i])/h;
+		double s2 = s*s;
+		double s3 = s2*s;
+
+		double h00 = 2*s3 - 3*s2 + 1;
+		double h10 = s3 - 2*s2 + s;
+		double h01 = -2*s3 + 3*s2;
+		double h11 = s3 - s2;
+
+		return h00*y[i] + h10*h*d[i] + h01*y[i+1] + h11*h*d[i+1];
+	}
+};
+
+#endif /* EXAMPLES_INTERPOLATION_HPP_ */
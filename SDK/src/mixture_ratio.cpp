@@ -0,0 +1,359 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "mixture_ratio.hpp"
+#include "threadpool.hpp"
+
+/**
+ * Golden section ratio used by Brent's method: (3-sqrt(5))/2.
+ */
+static const double MIXTURE_RATIO_GOLDEN = 0.3819660112501051;
+
+/**
+ * Maximum number of shifts of the search range.
+ */
+static const int MIXTURE_RATIO_MAX_SHIFTS = 10;
+
+/**
+ * Maximum number of steps narrowing the bracket.
+ */
+static const int MIXTURE_RATIO_MAX_ITERATIONS = 100;
+
+/**
+ * Task of the worker thread: solves one probe using the configuration of the thread.
+ */
+struct MixtureRatioTask {
+	const MixtureRatioOptimizer* optimizer;
+	WorkerConfigs* configs;
+	const std::vector<double>* r;
+	std::vector<PerformanceSnapshot> snapshots;
+	std::vector<char> solved;
+
+	void operator()(size_t i, int worker) {
+		solved[i] = optimizer->solveProbe(configs->get(worker), (*r)[i], snapshots[i]) ? 1 : 0;
+	}
+};
+
+//*****************************************************************************
+
+int MixtureRatioOptimizer::getProbes() const {
+	if (probes>0) {
+		return probes;
+	}
+	ThreadPool pool(threads);
+	return pool.getThreads();
+}
+
+double MixtureRatioOptimizer::getObjective(const PerformanceSnapshot& snapshot) const {
+	return pa<0 ? snapshot.Is : snapshot.getIs_H(pa);
+}
+
+bool MixtureRatioOptimizer::solveProbe(thermo::input::ConfigFile* config, double r, PerformanceSnapshot& snapshot) const {
+	config->getPropellant().setRatio(r, thermo::input::Ratio::km);
+
+	try {
+		solvePerformance(cache, config, snapshot);
+	} catch (const std::exception& ex) {
+		util::Log::warnf("OPTIMIZE", "Could not solve O/F=%f: %s%s", r, ex.what(), CR);
+		return false;
+	}
+
+	return true;
+}
+
+void MixtureRatioOptimizer::solve(const std::vector<double>& r) {
+	std::vector<double> pending;
+	for (size_t i=0; i<r.size(); ++i) {
+		if (solved.find(r[i])==solved.end() && std::find(pending.begin(), pending.end(), r[i])==pending.end()) {
+			pending.push_back(r[i]);
+		}
+	}
+	if (pending.empty()) {
+		return;
+	}
+	++iterations;
+
+	ThreadPool pool(threads);
+	configs.prepare(pool.getThreads());
+
+	MixtureRatioTask task;
+	task.optimizer = this;
+	task.configs = &configs;
+	task.r = &pending;
+	task.snapshots.resize(pending.size());
+	task.solved.assign(pending.size(), 0);
+
+	pool.run(pending.size(), task);
+
+	for (size_t i=0; i<pending.size(); ++i) {
+		Probe& probe = solved[pending[i]];
+		probe.solved = 0!=task.solved[i];
+		probe.value = probe.solved ? getObjective(task.snapshots[i]) : -HUGE_VAL;
+		probe.snapshot = task.snapshots[i];
+	}
+}
+
+double MixtureRatioOptimizer::evaluate(double r) {
+	std::map<double, Probe>::const_iterator it = solved.find(r);
+	if (it==solved.end()) {
+		solve(std::vector<double>(1, r));
+		it = solved.find(r);
+	}
+	return it->second.value;
+}
+
+bool MixtureRatioOptimizer::bracket(double& a, double& x, double& b) {
+	double lo = r_min;
+	double hi = r_max;
+	if (!(lo>0 && hi>lo)) {
+		// Range around the ratio of the configuration
+		double r0 = 0;
+		if (thermo::input::Ratio::km==data->getPropellant().getRatioType()) {
+			r0 = data->getPropellant().getRatio();
+		} else {
+			thermo::input::ConfigFile config(*data);
+			performance::TheoreticalPerformance performance(&config, false);
+			performance.solve();
+			r0 = performance.getPropellant()->getKm();
+		}
+		lo = r0/2;
+		hi = r0*2;
+	}
+
+	int m = std::max(getProbes(), 3);
+	std::vector<double> grid(m);
+
+	for (int shift=0; ; ++shift) {
+		for (int i=0; i<m; ++i) {
+			grid[i] = lo + (hi - lo)*(double)i/(double)(m - 1);
+		}
+		solve(grid);
+
+		int k = 0;
+		for (int i=1; i<m; ++i) {
+			if (evaluate(grid[i])>evaluate(grid[k])) {
+				k = i;
+			}
+		}
+		if (-HUGE_VAL==evaluate(grid[k])) {
+			throw std::runtime_error("Could not solve any O/F ratio of the search range");
+		}
+
+		x = grid[k];
+		if (k>0 && k<m-1) {
+			a = grid[k-1];
+			b = grid[k+1];
+			return true;
+		}
+		if (shift==MIXTURE_RATIO_MAX_SHIFTS) {
+			util::Log::warnf("OPTIMIZE", "Maximum of specific impulse is at the end of the search range, O/F=%f%s", x, CR);
+			return false;
+		}
+
+		// Shift the range towards the end with the maximum, keeping two probes of the previous grid
+		double width = hi - lo;
+		if (0==k) {
+			hi = grid[1];
+			lo = std::max(lo - width, lo/2);
+		} else {
+			lo = grid[m-2];
+			hi = hi + width;
+		}
+	}
+}
+
+void MixtureRatioOptimizer::brent(double a, double x, double b) {
+	// Brent's method minimizing -Is
+	double w = x, v = x;
+	double fx = -evaluate(x), fw = fx, fv = fx;
+	double d = 0, e = 0;
+
+	for (int i=0; i<MIXTURE_RATIO_MAX_ITERATIONS; ++i) {
+		double m = 0.5*(a + b);
+		double tol1 = tolerance*fabs(x) + 1e-12;
+		double tol2 = 2*tol1;
+		if (fabs(x - m)<=tol2 - 0.5*(b - a)) {
+			break;
+		}
+
+		bool golden = true;
+		if (fabs(e)>tol1) {
+			// Parabola through x, w and v
+			double r = (x - w)*(fx - fv);
+			double q = (x - v)*(fx - fw);
+			double p = (x - v)*q - (x - w)*r;
+			q = 2*(q - r);
+			if (q>0) {
+				p = -p;
+			} else {
+				q = -q;
+			}
+			double e0 = e;
+			e = d;
+			if (fabs(p)<fabs(0.5*q*e0) && p>q*(a - x) && p<q*(b - x)) {
+				d = p/q;
+				double u = x + d;
+				if (u - a<tol2 || b - u<tol2) {
+					d = m>=x ? tol1 : -tol1;
+				}
+				golden = false;
+			}
+		}
+		if (golden) {
+			e = x>=m ? a - x : b - x;
+			d = MIXTURE_RATIO_GOLDEN*e;
+		}
+
+		double u = fabs(d)>=tol1 ? x + d : x + (d>=0 ? tol1 : -tol1);
+		double fu = -evaluate(u);
+
+		if (fu<=fx) {
+			if (u>=x) {
+				a = x;
+			} else {
+				b = x;
+			}
+			v = w; fv = fw;
+			w = x; fw = fx;
+			x = u; fx = fu;
+		} else {
+			if (u<x) {
+				a = u;
+			} else {
+				b = u;
+			}
+			if (fu<=fw || w==x) {
+				v = w; fv = fw;
+				w = u; fw = fu;
+			} else if (fu<=fv || v==x || v==w) {
+				v = u; fv = fu;
+			}
+		}
+	}
+
+	r_opt = x;
+}
+
+/**
+ * Returns the vertex of the parabola through three points, or false if the points are collinear.
+ */
+static bool getParabolaVertex(double a, double fa, double x, double fx, double b, double fb, double& u) {
+	double p = (x - a)*(x - a)*(fx - fb) - (x - b)*(x - b)*(fx - fa);
+	double q = (x - a)*(fx - fb) - (x - b)*(fx - fa);
+	if (0==q) {
+		return false;
+	}
+	u = x - 0.5*p/q;
+	return true;
+}
+
+void MixtureRatioOptimizer::multisection(double a, double x, double b) {
+	int n = getProbes();
+
+	for (int i=0; i<MIXTURE_RATIO_MAX_ITERATIONS && b - a>2*tolerance*fabs(x); ++i) {
+		std::vector<double> grid;
+
+		// The vertex of the parabola through the bracket is probed together with the points at the tolerance
+		// on either side of it, so that the bracket collapses around the vertex as soon as it is accurate
+		double u;
+		if (getParabolaVertex(a, evaluate(a), x, evaluate(x), b, evaluate(b), u)) {
+			double tol = tolerance*fabs(x);
+			double vertex[3] = {u - tol, u, u + tol};
+			for (int j=0; j<3; ++j) {
+				if (vertex[j]>a && vertex[j]<b) {
+					grid.push_back(vertex[j]);
+				}
+			}
+		}
+
+		int m = n - (int)grid.size();
+		for (int j=1; j<=m; ++j) {
+			grid.push_back(a + (b - a)*(double)j/(double)(m + 1));
+		}
+		solve(grid);
+
+		// Best of the probes within the bracket, and its neighbours
+		grid.push_back(a);
+		grid.push_back(x);
+		grid.push_back(b);
+		std::sort(grid.begin(), grid.end());
+		grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+
+		size_t k = 1;
+		for (size_t j=2; j+1<grid.size(); ++j) {
+			if (evaluate(grid[j])>evaluate(grid[k])) {
+				k = j;
+			}
+		}
+		a = grid[k-1];
+		x = grid[k];
+		b = grid[k+1];
+	}
+
+	// Final parabolic step
+	double u;
+	if (getParabolaVertex(a, evaluate(a), x, evaluate(x), b, evaluate(b), u) && u>a && u<b && u!=x && evaluate(u)>evaluate(x)) {
+		x = u;
+	}
+
+	r_opt = x;
+}
+
+double MixtureRatioOptimizer::run() {
+	solved.clear();
+	iterations = 0;
+	r_opt = 0;
+
+	try {
+		double a, x, b;
+		if (!bracket(a, x, b)) {
+			r_opt = x;
+		} else if (getProbes()>=3) {
+			multisection(a, x, b);
+		} else {
+			brent(a, x, b);
+		}
+	} catch (...) {
+		configs.clear();
+		throw;
+	}
+
+	configs.clear();
+
+	snapshot = solved[r_opt].snapshot;
+
+	data->getPropellant().setRatio(r_opt, thermo::input::Ratio::km);
+
+	util::Log::printf("OPTIMIZE", "Optimal O/F=%f found with %d probes in %d steps%s", r_opt, (int)solved.size(), iterations, CR);
+
+	return r_opt;
+}
@@ -0,0 +1,199 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_MIXTURE_RATIO_HPP_
+#define EXAMPLES_MIXTURE_RATIO_HPP_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+
+#include "common.hpp"
+#include "performance_cache.hpp"
+
+/**
+ * Search of the O/F weight ratio which gives maximum specific impulse: a replacement of
+ * TheoreticalPerformance::optimizeForSpecificImpulse() which solves several probes at once.
+ *
+ * The optimum is first bracketed by the grid of probes over the search range (the range is shifted if the maximum
+ * is at its end), then the bracket is narrowed until its width is below the tolerance:
+ * - with less than three probes per step, by Brent's method (parabolic interpolation with golden-section steps);
+ * - otherwise, by solving the probes on the thread pool: the vertex of the parabola through the bracket,
+ *   the points at the tolerance on either side of it, and the rest evenly spaced in the bracket.
+ *
+ * Each probe is a complete solution of the problem with its own copy of the configuration (see ParametricSweep);
+ * probes are solved once, and can be taken from the cache of results.
+ */
+class MixtureRatioOptimizer {
+private:
+	struct Probe {
+		bool solved;
+		double value;					// objective, m/s
+		PerformanceSnapshot snapshot;
+	};
+
+	thermo::input::ConfigFile* data;
+	int threads;
+	int probes;
+	double tolerance;
+	double pa;
+	double r_min;
+	double r_max;
+
+	PerformanceCache* cache;
+
+	WorkerConfigs configs;							// configuration of each worker thread
+	std::map<double, Probe> solved;
+	double r_opt;
+	PerformanceSnapshot snapshot;
+	int iterations;
+
+	double getObjective(const PerformanceSnapshot& snapshot) const;
+
+	/**
+	 * Solves the probes which have not been solved yet, in parallel.
+	 */
+	void solve(const std::vector<double>& r);
+
+	/**
+	 * Returns the objective at r (solving the probe if necessary); -HUGE_VAL if the probe could not be solved.
+	 */
+	double evaluate(double r);
+
+	/**
+	 * Finds the bracket a<x<b of the maximum, x being the best probe.
+	 *
+	 * @return false if the maximum is at the end of the range after all the shifts; x is then the best probe
+	 */
+	bool bracket(double& a, double& x, double& b);
+
+	void brent(double a, double x, double b);
+	void multisection(double a, double x, double b);
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	MixtureRatioOptimizer(thermo::input::ConfigFile* data, int threads = 0) :
+		data(data), threads(threads), probes(0), tolerance(1e-4), pa(-1), r_min(0), r_max(0),
+		cache(NULL), configs(data), r_opt(0), iterations(0) {
+	}
+
+	void setThreads(int threads) {
+		this->threads = threads;
+	}
+
+	/**
+	 * Sets the number of probes solved at each step; 0 (default) to use the number of threads.
+	 * Less than three probes select Brent's method.
+	 */
+	void setProbes(int probes) {
+		this->probes = probes;
+	}
+
+	int getProbes() const;
+
+	/**
+	 * Sets the relative tolerance of the optimal O/F ratio.
+	 */
+	void setTolerance(double tolerance) {
+		this->tolerance = tolerance;
+	}
+
+	double getTolerance() const {
+		return tolerance;
+	}
+
+	/**
+	 * Sets the ambient pressure (Pa) of the specific impulse to maximize: 0 for vacuum specific impulse,
+	 * negative value (default) for specific impulse at optimum expansion.
+	 */
+	void setAmbientPressure(double pa) {
+		this->pa = pa;
+	}
+
+	/**
+	 * Sets the initial search range of O/F weight ratio. If not set, the range is from 1/2 to 2 times the ratio
+	 * of the configuration.
+	 */
+	void setRange(double r_min, double r_max) {
+		this->r_min = r_min;
+		this->r_max = r_max;
+	}
+
+	/**
+	 * Sets the cache of results: probes found in the cache are not solved, and solved probes are stored in the cache.
+	 *
+	 * @param cache cache of results; must exist as long as this object is used; NULL to solve all probes
+	 */
+	void setCache(PerformanceCache* cache) {
+		this->cache = cache;
+	}
+
+	/**
+	 * Finds the optimal O/F weight ratio and sets it in the configuration.
+	 *
+	 * Throws an exception if none of the probes could be solved.
+	 *
+	 * @return optimal O/F weight ratio
+	 */
+	double run();
+
+	/**
+	 * Solves one probe using given configuration. Used by the worker threads.
+	 *
+	 * @param config configuration which is modified according to the probe
+	 * @return false if the probe could not be solved
+	 */
+	bool solveProbe(thermo::input::ConfigFile* config, double r, PerformanceSnapshot& snapshot) const;
+
+	double getRatio() const {
+		return r_opt;
+	}
+
+	/**
+	 * Returns the results at the optimal O/F ratio.
+	 */
+	const PerformanceSnapshot& getSnapshot() const {
+		return snapshot;
+	}
+
+	/**
+	 * Returns the number of probes solved (or taken from the cache) by the last run().
+	 */
+	int getSolvesNo() const {
+		return (int)solved.size();
+	}
+
+	/**
+	 * Returns the number of steps of the last run(), i.e. the number of times the solver has been waited for.
+	 */
+	int getIterationsNo() const {
+		return iterations;
+	}
+};
+
+#endif /* EXAMPLES_MIXTURE_RATIO_HPP_ */
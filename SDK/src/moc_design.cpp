@@ -0,0 +1,174 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <limits>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+#include "nozzle/MocNozzle.hpp"
+
+#include "common.hpp"
+#include "moc_design.hpp"
+#include "threadpool.hpp"
+
+MocDesignSweep::MocDesignSweep(thermo::input::ConfigFile* data, int threads) :
+	data(data),
+	threads(threads),
+	applyCorrectionFactors(true),
+	tnMaxTolerance(1e-3) {
+}
+
+design::MocNozzle* MocDesignSweep::design(design::Chamber* chamber, const MocDesignCandidate& candidate,
+		NozzleContourSummary* summary, double tnMaxTolerance) {
+
+	design::MocNozzle* nozzle = new design::MocNozzle(chamber);
+	try {
+		switch (candidate.mode) {
+		case MOC_DESIGN_FIXED_AREA:
+			nozzle->calcGeometryAtFixedArea(candidate.Fr, candidate.R1, candidate.Rn, candidate.Tw_bar);
+			break;
+		case MOC_DESIGN_FIXED_LENGTH:
+			nozzle->calcGeometryAtFixedLength(candidate.Le_bar, candidate.R1, candidate.Rn, candidate.Tw_bar);
+			break;
+		case MOC_DESIGN_FIXED_AREA_AND_LENGTH:
+			nozzle->calcGeometryAtFixedAreaAndLength(candidate.Fr, candidate.Le_bar, candidate.R1, candidate.Rn);
+			break;
+		case MOC_DESIGN_MAX_THRUST:
+			nozzle->calcGeometryMaxThrust(candidate.R1, candidate.Rn, candidate.Tw_bar);
+			break;
+		}
+
+		if (summary) {
+			getMocNozzleSummary(nozzle, *summary, tnMaxTolerance);
+		}
+	} catch (...) {
+		delete nozzle;
+		throw;
+	}
+	return nozzle;
+}
+
+/**
+ * Task of the worker thread: designs one candidate using the chamber of the thread.
+ */
+struct MocDesignTask {
+	/**
+	 * Solved problem of the thread, created on its first task.
+	 */
+	struct Worker {
+		thermo::input::ConfigFile* config;			// owned by WorkerConfigs
+		performance::TheoreticalPerformance* performance;
+		performance::efficiency::CorrectionFactors* correctionFactors;
+		design::Chamber* chamber;
+		bool failed;
+	};
+
+	MocDesignSweep* sweep;
+	WorkerConfigs* configs;
+	std::vector<Worker> workers;
+
+	bool init(Worker& w) {
+		try {
+			w.performance = new performance::TheoreticalPerformance(w.config, false);
+			w.performance->solve();
+			if (sweep->applyCorrectionFactors) {
+				w.correctionFactors = new performance::efficiency::CorrectionFactors(w.performance);
+			}
+			w.chamber = createChamber(w.performance, w.correctionFactors);
+			if (!w.chamber) {
+				util::Log::errorf("MOC", "Engine size design parameters not defined%s", CR);
+				return false;
+			}
+		} catch (const std::exception& ex) {
+			util::Log::errorf("MOC", "Could not design chamber: %s%s", ex.what(), CR);
+			return false;
+		}
+		return true;
+	}
+
+	void operator()(size_t task, int worker) {
+		Worker& w = workers[worker];
+		if (!w.config) {
+			w.config = configs->get(worker);
+			w.failed = !init(w);
+		}
+		if (w.failed) {
+			return;
+		}
+
+		NozzleContourSummary summary;
+		design::MocNozzle* nozzle = NULL;
+		try {
+			nozzle = MocDesignSweep::design(w.chamber, sweep->candidates[task], &summary, sweep->tnMaxTolerance);
+		} catch (const std::exception& ex) {
+			util::Log::warnf("MOC", "Could not design candidate %u: %s%s", (unsigned int)task, ex.what(), CR);
+			return;
+		}
+		delete nozzle;
+
+		sweep->Le[task] = summary.Le;
+		sweep->Te[task] = summary.Te;
+		sweep->Tn_max[task] = summary.Tn_max;
+		sweep->solved[task] = 1;
+	}
+};
+
+size_t MocDesignSweep::run() {
+	size_t n = candidates.size();
+
+	Le.assign(n, std::numeric_limits<double>::quiet_NaN());
+	Te.assign(n, std::numeric_limits<double>::quiet_NaN());
+	Tn_max.assign(n, std::numeric_limits<double>::quiet_NaN());
+	solved.assign(n, 0);
+
+	if (0==n) {
+		return 0;
+	}
+
+	ThreadPool pool(threads);
+
+	WorkerConfigs configs(data);
+	configs.prepare(pool.getThreads());
+
+	MocDesignTask::Worker empty = {NULL, NULL, NULL, NULL, false};
+
+	MocDesignTask task;
+	task.sweep = this;
+	task.configs = &configs;
+	task.workers.assign(pool.getThreads(), empty);
+
+	pool.run(n, task);
+
+	for (size_t i=0; i<task.workers.size(); ++i) {
+		delete task.workers[i].chamber;
+		delete task.workers[i].correctionFactors;
+		delete task.workers[i].performance;
+	}
+
+	size_t designed = 0;
+	for (size_t i=0; i<n; ++i) {
+		designed += solved[i] ? 1 : 0;
+	}
+	return designed;
+}
@@ -0,0 +1,161 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_MOC_DESIGN_HPP_
+#define EXAMPLES_MOC_DESIGN_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/dll/Export.hpp"
+#include "nozzle/MocNozzle.hpp"
+
+#include "nozzle_contour.hpp"
+
+/**
+ * Method of the design of MOC nozzle (see design::MocNozzle).
+ */
+enum MocDesignMode {
+	MOC_DESIGN_FIXED_AREA = 0,				// exit area ratio and wall temperature ratio (calcGeometryAtFixedArea)
+	MOC_DESIGN_FIXED_LENGTH = 1,			// relative length and wall temperature ratio (calcGeometryAtFixedLength)
+	MOC_DESIGN_FIXED_AREA_AND_LENGTH = 2,	// exit area ratio and relative length (calcGeometryAtFixedAreaAndLength)
+	MOC_DESIGN_MAX_THRUST = 3				// wall temperature ratio (calcGeometryMaxThrust)
+};
+
+/**
+ * Parameters of one MOC nozzle design; the ones not used by the mode are ignored.
+ */
+struct MocDesignCandidate {
+	MocDesignMode mode;
+	double Fr;					// exit area ratio
+	double Le_bar;				// nozzle length relative to the throat radius
+	double R1;					// radius of the upstream throat arc relative to the throat radius
+	double Rn;					// radius of the downstream throat arc relative to the throat radius
+	double Tw_bar;				// wall temperature ratio Tw/T0
+};
+
+/**
+ * Designs the set of MOC nozzles for the chamber of the configuration, e.g. the candidates of the outer
+ * optimization loop.
+ *
+ * Candidates are designed on the thread pool. Each thread solves the performance and the chamber of its own copy of
+ * the configuration once, and then designs its candidates one by one. Results are stored in the arrays indexed by
+ * the candidate; the nozzles are not kept.
+ *
+ * The contours are designed exactly as by design(). By default the sweep only uses a looser tolerance of the
+ * golden-section search of the maximum wall angle (see setTnMaxTolerance()), which affects the reported Tn_max only.
+ */
+class MocDesignSweep {
+private:
+	thermo::input::ConfigFile* data;
+	int threads;
+	bool applyCorrectionFactors;
+	double tnMaxTolerance;
+
+	std::vector<MocDesignCandidate> candidates;
+
+	std::vector<double> Le;
+	std::vector<double> Te;
+	std::vector<double> Tn_max;
+	std::vector<char> solved;
+
+	friend struct MocDesignTask;
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	MocDesignSweep(thermo::input::ConfigFile* data, int threads = 0);
+
+	void addCandidate(const MocDesignCandidate& candidate) {
+		candidates.push_back(candidate);
+	}
+
+	size_t getCandidatesNo() const {
+		return candidates.size();
+	}
+
+	const MocDesignCandidate& getCandidate(size_t i) const {
+		return candidates[i];
+	}
+
+	/**
+	 * Specifies whether the chamber is sized with the performance correction factors (true by default).
+	 */
+	void setCorrectionFactors(bool applyCorrectionFactors) {
+		this->applyCorrectionFactors = applyCorrectionFactors;
+	}
+
+	/**
+	 * Sets the tolerance of the golden-section search of the contour parameter of the maximum wall angle Tn_max
+	 * (1e-3 by default).
+	 */
+	void setTnMaxTolerance(double tnMaxTolerance) {
+		this->tnMaxTolerance = tnMaxTolerance;
+	}
+
+	/**
+	 * Designs the candidate using given chamber.
+	 *
+	 * @param summary if not NULL, receives the parameters of the contour
+	 * @param tnMaxTolerance tolerance of the golden-section search of the contour parameter of the maximum wall angle
+	 * @return designed nozzle, which must be deleted by the caller
+	 */
+	static design::MocNozzle* design(design::Chamber* chamber, const MocDesignCandidate& candidate,
+			NozzleContourSummary* summary = NULL, double tnMaxTolerance = 1e-5);
+
+	/**
+	 * Designs all the candidates.
+	 *
+	 * @return number of the candidates designed
+	 */
+	size_t run();
+
+	bool isSolved(size_t i) const {
+		return solved[i]!=0;
+	}
+
+	/**
+	 * Returns the nozzle length, m.
+	 */
+	double getLe(size_t i) const {
+		return Le[i];
+	}
+
+	/**
+	 * Returns the exit wall angle, rad.
+	 */
+	double getTe(size_t i) const {
+		return Te[i];
+	}
+
+	/**
+	 * Returns the maximum wall angle, rad.
+	 */
+	double getTn_max(size_t i) const {
+		return Tn_max[i];
+	}
+};
+
+#endif /* EXAMPLES_MOC_DESIGN_HPP_ */
@@ -0,0 +1,478 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "monte_carlo.hpp"
+#include "performance_cache.hpp"
+#include "threadpool.hpp"
+
+void setMonteCarloParameter(thermo::input::ConfigFile* config, MonteCarloParameter type, double value) {
+	switch (type) {
+	case MONTE_CARLO_REACTION_EFFICIENCY:
+		config->getNozzleFlowOptions().setEfficiencyFactors().setReactionEfficiency(value);
+		break;
+	case MONTE_CARLO_NOZZLE_EFFICIENCY:
+		config->getNozzleFlowOptions().setEfficiencyFactors().setNozzleEfficiency(value);
+		break;
+	case MONTE_CARLO_CYCLE_EFFICIENCY:
+		config->getNozzleFlowOptions().setEfficiencyFactors().setCycleEfficiency(value);
+		break;
+	default:
+		setSweepAxisValue(config, (SweepAxisType)type, value);
+		break;
+	}
+}
+
+StreamingStatistics::Quantile::Quantile(double p) :
+	p(p) {
+	dn[0] = 0;
+	dn[1] = p/2;
+	dn[2] = p;
+	dn[3] = (1 + p)/2;
+	dn[4] = 1;
+}
+
+void StreamingStatistics::Quantile::add(double x, size_t count) {
+	// The first 5 values are kept as they are
+	if (count<5) {
+		q[count] = x;
+		if (4==count) {
+			std::sort(q, q + 5);
+			for (int i=0; i<5; ++i) {
+				n[i] = i + 1;
+			}
+			np[0] = 1;
+			np[1] = 1 + 2*p;
+			np[2] = 1 + 4*p;
+			np[3] = 3 + 2*p;
+			np[4] = 5;
+		}
+		return;
+	}
+
+	// Cell of the value
+	int k;
+	if (x<q[0]) {
+		q[0] = x;
+		k = 0;
+	} else
+	if (x>=q[4]) {
+		q[4] = x;
+		k = 3;
+	} else {
+		k = 0;
+		while (x>=q[k+1]) {
+			++k;
+		}
+	}
+
+	for (int i=k+1; i<5; ++i) {
+		n[i] += 1;
+	}
+	for (int i=0; i<5; ++i) {
+		np[i] += dn[i];
+	}
+
+	// Move the middle markers towards their desired positions
+	for (int i=1; i<4; ++i) {
+		double d = np[i] - n[i];
+		if ((d>=1 && n[i+1] - n[i]>1) || (d<=-1 && n[i-1] - n[i]<-1)) {
+			double s = d>=0 ? 1 : -1;
+
+			// Piecewise-parabolic prediction, or linear one if it's not monotone
+			double qp = q[i] + s/(n[i+1] - n[i-1])*(
+				(n[i] - n[i-1] + s)*(q[i+1] - q[i])/(n[i+1] - n[i]) +
+				(n[i+1] - n[i] - s)*(q[i] - q[i-1])/(n[i] - n[i-1]));
+			if (!(q[i-1]<qp && qp<q[i+1])) {
+				int j = i + (int)s;
+				qp = q[i] + s*(q[j] - q[i])/(n[j] - n[i]);
+			}
+
+			q[i] = qp;
+			n[i] += s;
+		}
+	}
+}
+
+StreamingStatistics::StreamingStatistics(int bins, const std::vector<double>* percentiles) :
+	count(0),
+	mean(0),
+	m2(0),
+	min(std::numeric_limits<double>::quiet_NaN()),
+	max(std::numeric_limits<double>::quiet_NaN()),
+	bins(std::max(bins, 1), 0),
+	underflow(0),
+	overflow(0),
+	low(0),
+	high(0),
+	ranged(false) {
+
+	static const double defaultPercentiles[] = {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+
+	std::vector<double> p;
+	if (percentiles) {
+		p = *percentiles;
+	} else {
+		p.assign(defaultPercentiles, defaultPercentiles + sizeof(defaultPercentiles)/sizeof(defaultPercentiles[0]));
+	}
+	std::sort(p.begin(), p.end());
+
+	for (size_t i=0; i<p.size(); ++i) {
+		if (p[i]>0 && p[i]<1) {
+			quantiles.push_back(Quantile(p[i]));
+		}
+	}
+}
+
+void StreamingStatistics::setRange(double low, double high) {
+	if (count>0) {
+		util::Log::warnf("MONTE_CARLO", "Range of the histogram can not be changed after the values are added%s", CR);
+		return;
+	}
+	this->low = std::min(low, high);
+	this->high = std::max(low, high);
+	ranged = this->high>this->low;
+}
+
+void StreamingStatistics::getRange(double& low, double& high) const {
+	if (ranged) {
+		low = this->low;
+		high = this->high;
+		return;
+	}
+	if (warmup.empty()) {
+		low = high = 0;
+		return;
+	}
+
+	double lo = *std::min_element(warmup.begin(), warmup.end());
+	double hi = *std::max_element(warmup.begin(), warmup.end());
+	double spread = hi - lo;
+	if (spread<=0) {
+		spread = std::max(fabs(lo)*1e-3, 1e-12);
+	}
+	low = lo - spread/2;
+	high = hi + spread/2;
+}
+
+void StreamingStatistics::addToHistogram(double x) {
+	if (x<low) {
+		++underflow;
+	} else
+	if (x>=high) {
+		++overflow;
+	} else {
+		size_t i = (size_t)((x - low)/(high - low)*(double)bins.size());
+		++bins[std::min(i, bins.size() - 1)];
+	}
+}
+
+void StreamingStatistics::add(double x) {
+	if (0==count) {
+		min = max = x;
+	} else {
+		min = std::min(min, x);
+		max = std::max(max, x);
+	}
+
+	for (size_t i=0; i<quantiles.size(); ++i) {
+		quantiles[i].add(x, count);
+	}
+
+	++count;
+	double delta = x - mean;
+	mean += delta/(double)count;
+	m2 += delta*(x - mean);
+
+	if (ranged) {
+		addToHistogram(x);
+		return;
+	}
+
+	warmup.push_back(x);
+	if (warmup.size()>=WARMUP_SIZE) {
+		getRange(low, high);
+		ranged = true;
+		for (size_t i=0; i<warmup.size(); ++i) {
+			addToHistogram(warmup[i]);
+		}
+		std::vector<double>().swap(warmup);
+	}
+}
+
+double StreamingStatistics::getStdDev() const {
+	return count>1 ? sqrt(m2/(double)(count - 1)) : 0;
+}
+
+double StreamingStatistics::getPercentile(size_t i) const {
+	const Quantile& quantile = quantiles[i];
+	if (count>=5) {
+		return quantile.q[2];
+	}
+	if (0==count) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	// Too few values for the estimator: interpolate between the sorted values
+	double q[5];
+	std::copy(quantile.q, quantile.q + count, q);
+	std::sort(q, q + count);
+	double t = quantile.p*(double)(count - 1);
+	size_t j = std::min((size_t)t, count - 1);
+	return j + 1<count ? q[j] + (t - j)*(q[j+1] - q[j]) : q[j];
+}
+
+double StreamingStatistics::getPercentileAt(double p) const {
+	if (quantiles.empty()) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	if (p<=quantiles.front().p) {
+		return p<=0 ? min : getPercentile(0);
+	}
+	if (p>=quantiles.back().p) {
+		return p>=1 ? max : getPercentile(quantiles.size() - 1);
+	}
+
+	size_t i = 1;
+	while (quantiles[i].p<p) {
+		++i;
+	}
+	double t = (p - quantiles[i-1].p)/(quantiles[i].p - quantiles[i-1].p);
+	return getPercentile(i - 1) + t*(getPercentile(i) - getPercentile(i - 1));
+}
+
+size_t StreamingStatistics::getBin(size_t i) const {
+	if (ranged) {
+		return bins[i];
+	}
+
+	// The range has not been chosen yet: count the values kept so far
+	double low, high;
+	getRange(low, high);
+	size_t n = 0;
+	for (size_t k=0; k<warmup.size(); ++k) {
+		size_t b = (size_t)((warmup[k] - low)/(high - low)*(double)bins.size());
+		if (std::min(b, bins.size() - 1)==i) {
+			++n;
+		}
+	}
+	return n;
+}
+
+double StreamingStatistics::getBinEdge(size_t i) const {
+	double low, high;
+	getRange(low, high);
+	return low + (high - low)*(double)i/(double)bins.size();
+}
+
+MonteCarloAnalysis::MonteCarloAnalysis(thermo::input::ConfigFile* data, int threads) :
+	data(data),
+	threads(threads),
+	pa(0),
+	seed(1),
+	correctionFactors(true),
+	bins(50),
+	batchSize(0),
+	statistics(MONTE_CARLO_OUTPUTS_NO),
+	samplesNo(0),
+	failedNo(0) {
+}
+
+void MonteCarloAnalysis::addVariable(MonteCarloParameter type, MonteCarloDistribution distribution, double a, double b, double c) {
+	Variable v;
+	v.type = type;
+	v.distribution = distribution;
+	v.a = a;
+	v.b = b;
+	v.c = c;
+	variables.push_back(v);
+}
+
+void MonteCarloAnalysis::addNormal(MonteCarloParameter type, double mean, double sigma, double truncation) {
+	addVariable(type, MONTE_CARLO_NORMAL, mean, fabs(sigma), truncation);
+}
+
+void MonteCarloAnalysis::addUniform(MonteCarloParameter type, double min, double max) {
+	addVariable(type, MONTE_CARLO_UNIFORM, std::min(min, max), std::max(min, max), 0);
+}
+
+void MonteCarloAnalysis::addTriangular(MonteCarloParameter type, double min, double mode, double max) {
+	if (mode<min || mode>max) {
+		util::Log::errorf("MONTE_CARLO", "Mode of triangular distribution is out of its range%s", CR);
+		return;
+	}
+	addVariable(type, MONTE_CARLO_TRIANGULAR, min, mode, max);
+}
+
+void MonteCarloAnalysis::sample(size_t i, double* x) const {
+	std::seed_seq sequence = {seed, (unsigned int)((unsigned long long)i & 0xFFFFFFFFu), (unsigned int)((unsigned long long)i >> 32)};
+	std::mt19937 random(sequence);
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	std::normal_distribution<double> normal(0.0, 1.0);
+
+	for (size_t v=0; v<variables.size(); ++v) {
+		const Variable& variable = variables[v];
+		switch (variable.distribution) {
+		case MONTE_CARLO_NORMAL: {
+			double z = normal(random);
+			while (variable.c>0 && fabs(z)>variable.c) {
+				z = normal(random);
+			}
+			x[v] = variable.a + variable.b*z;
+			break;
+		}
+		case MONTE_CARLO_UNIFORM:
+			x[v] = variable.a + uniform(random)*(variable.b - variable.a);
+			break;
+		case MONTE_CARLO_TRIANGULAR: {
+			// Inverse of the distribution function
+			double u = uniform(random);
+			double width = variable.c - variable.a;
+			if (width<=0) {
+				x[v] = variable.b;
+			} else
+			if (u*width<variable.b - variable.a) {
+				x[v] = variable.a + sqrt(u*width*(variable.b - variable.a));
+			} else {
+				x[v] = variable.c - sqrt((1 - u)*width*(variable.c - variable.b));
+			}
+			break;
+		}
+		}
+	}
+}
+
+bool MonteCarloAnalysis::solveSample(thermo::input::ConfigFile* config, size_t i, double* values) const {
+	if (!variables.empty()) {
+		std::vector<double> x(variables.size());
+		sample(i, &x[0]);
+		for (size_t v=0; v<variables.size(); ++v) {
+			setMonteCarloParameter(config, variables[v].type, x[v]);
+		}
+	}
+
+	performance::TheoreticalPerformance* performance = NULL;
+	performance::efficiency::CorrectionFactors* factors = NULL;
+	try {
+		performance = new performance::TheoreticalPerformance(config, false);
+		performance->solve();
+
+		PerformanceSnapshot snapshot;
+		getPerformanceSnapshot(performance, NULL, snapshot);
+
+		double phi = 1;
+		if (correctionFactors) {
+			factors = new performance::efficiency::CorrectionFactors(performance);
+			phi = factors->getOverallEfficiency();
+		}
+
+		values[MONTE_CARLO_IS] = snapshot.getIs_H(pa)*phi;
+		values[MONTE_CARLO_T_C] = snapshot.T_c;
+		values[MONTE_CARLO_MDOT] = getEngineMdot(performance, correctionFactors);
+
+	} catch (const std::exception& ex) {
+		util::Log::warnf("MONTE_CARLO", "Could not solve sample %u: %s%s", (unsigned int)i, ex.what(), CR);
+		delete factors;
+		delete performance;
+		return false;
+	}
+
+	delete factors;
+	delete performance;
+
+	return true;
+}
+
+/**
+ * Task of the worker thread: solves one sample of the batch using the configuration of the thread.
+ */
+struct MonteCarloTask {
+	const MonteCarloAnalysis* analysis;
+	WorkerConfigs* configs;
+	size_t first;
+	double* values;
+	char* solved;
+
+	void operator()(size_t task, int worker) {
+		solved[task] = analysis->solveSample(configs->get(worker), first + task, values + task*MONTE_CARLO_OUTPUTS_NO) ? 1 : 0;
+	}
+};
+
+size_t MonteCarloAnalysis::run(size_t samples) {
+	statistics.assign(MONTE_CARLO_OUTPUTS_NO, StreamingStatistics(bins));
+	samplesNo = 0;
+	failedNo = 0;
+
+	ThreadPool pool(threads);
+
+	WorkerConfigs configs(data);
+	configs.prepare(pool.getThreads());
+
+	size_t batch = batchSize>0 ? batchSize : 16*(size_t)pool.getThreads();
+	std::vector<double> values(batch*MONTE_CARLO_OUTPUTS_NO);
+	std::vector<char> solved(batch);
+
+	MonteCarloTask task;
+	task.analysis = this;
+	task.configs = &configs;
+	task.values = &values[0];
+	task.solved = &solved[0];
+
+	for (size_t first=0; first<samples; first+=batch) {
+		size_t n = std::min(batch, samples - first);
+
+		task.first = first;
+		pool.run(n, task);
+
+		// Results are added in the order of the samples, so that the estimators do not depend on the scheduling
+		for (size_t i=0; i<n; ++i) {
+			if (!solved[i]) {
+				++failedNo;
+				continue;
+			}
+			for (int o=0; o<MONTE_CARLO_OUTPUTS_NO; ++o) {
+				statistics[o].add(values[i*MONTE_CARLO_OUTPUTS_NO + o]);
+			}
+			++samplesNo;
+		}
+
+		if (!progress(first + n, samples)) {
+			break;
+		}
+	}
+
+	if (failedNo>0) {
+		util::Log::warnf("MONTE_CARLO", "%u of %u samples could not be solved%s", (unsigned int)failedNo, (unsigned int)(samplesNo + failedNo), CR);
+	}
+
+	return samplesNo;
+}
@@ -0,0 +1,343 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_MONTE_CARLO_HPP_
+#define EXAMPLES_MONTE_CARLO_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+
+#include "sweep.hpp"
+
+/**
+ * Uncertain parameters of the configuration. The first ones are the same as the axes of the sweep (see SweepAxisType).
+ */
+enum MonteCarloParameter {
+	MONTE_CARLO_OF_RATIO = SWEEP_AXIS_OF_RATIO,							// O/F weight ratio
+	MONTE_CARLO_ALPHA = SWEEP_AXIS_ALPHA,								// oxidizer excess coefficient
+	MONTE_CARLO_CHAMBER_PRESSURE = SWEEP_AXIS_CHAMBER_PRESSURE,			// chamber pressure, Pa
+	MONTE_CARLO_AREA_RATIO = SWEEP_AXIS_AREA_RATIO,						// nozzle exit area ratio
+	MONTE_CARLO_OXIDIZER_TEMPERATURE = SWEEP_AXIS_OXIDIZER_TEMPERATURE,	// inlet temperature of the first oxidizer component, K
+	MONTE_CARLO_FUEL_TEMPERATURE = SWEEP_AXIS_FUEL_TEMPERATURE,			// inlet temperature of the first fuel component, K
+	MONTE_CARLO_REACTION_EFFICIENCY = 6,								// reaction efficiency factor
+	MONTE_CARLO_NOZZLE_EFFICIENCY = 7,									// nozzle efficiency factor
+	MONTE_CARLO_CYCLE_EFFICIENCY = 8									// cycle efficiency factor
+};
+
+/**
+ * Assigns the value of the parameter in the configuration.
+ */
+extern void setMonteCarloParameter(thermo::input::ConfigFile* config, MonteCarloParameter type, double value);
+
+enum MonteCarloDistribution {
+	MONTE_CARLO_NORMAL = 0,				// parameters: mean, standard deviation, truncation (in standard deviations)
+	MONTE_CARLO_UNIFORM = 1,			// parameters: min, max
+	MONTE_CARLO_TRIANGULAR = 2			// parameters: min, mode, max
+};
+
+/**
+ * Results obtained for each sample.
+ */
+enum MonteCarloOutput {
+	MONTE_CARLO_IS = 0,					// delivered specific impulse at the ambient pressure, m/s
+	MONTE_CARLO_T_C = 1,				// combustion temperature, K
+	MONTE_CARLO_MDOT = 2,				// mass flow rate of the engine, kg/s (0 if the size of the engine is not defined)
+	MONTE_CARLO_OUTPUTS_NO = 3
+};
+
+/**
+ * Summary statistics of the stream of values, updated in constant memory per value: mean and variance (Welford),
+ * minimum and maximum, percentiles (P-square estimators of Jain and Chlamtac), and the histogram.
+ *
+ * Unless the range of the histogram is set, it is chosen from the first values (kept until then), extended by
+ * the half of their spread to each side; values out of the range are counted in the underflow and overflow bins.
+ */
+class StreamingStatistics {
+private:
+	/**
+	 * P-square estimator of one percentile: heights and positions of 5 markers.
+	 */
+	struct Quantile {
+		double p;
+		double q[5];				// marker heights
+		double n[5];				// actual marker positions
+		double np[5];				// desired marker positions
+		double dn[5];				// increments of the desired positions
+
+		explicit Quantile(double p);
+
+		void add(double x, size_t count);
+	};
+
+	size_t count;
+	double mean;
+	double m2;						// sum of squared deviations from the mean
+	double min;
+	double max;
+
+	std::vector<Quantile> quantiles;
+
+	std::vector<size_t> bins;
+	size_t underflow;
+	size_t overflow;
+	double low;
+	double high;
+	bool ranged;					// true if the range of the histogram has been chosen
+	std::vector<double> warmup;		// first values, until the range of the histogram is chosen
+
+	/**
+	 * Returns the range of the histogram, or the range which would be chosen from the values kept so far.
+	 */
+	void getRange(double& low, double& high) const;
+
+	void addToHistogram(double x);
+
+public:
+	/**
+	 * Number of the first values used to choose the range of the histogram.
+	 */
+	static const size_t WARMUP_SIZE = 100;
+
+	/**
+	 * @param bins number of the bins of the histogram
+	 * @param percentiles fractions (0..1) of the percentiles to estimate; 1, 5, 25, 50, 75, 95 and 99% if NULL
+	 */
+	explicit StreamingStatistics(int bins = 50, const std::vector<double>* percentiles = NULL);
+
+	/**
+	 * Fixes the range of the histogram. Must be called before the first value is added.
+	 */
+	void setRange(double low, double high);
+
+	void add(double x);
+
+	size_t getCount() const {
+		return count;
+	}
+
+	double getMean() const {
+		return mean;
+	}
+
+	/**
+	 * Returns the sample standard deviation.
+	 */
+	double getStdDev() const;
+
+	double getMin() const {
+		return min;
+	}
+
+	double getMax() const {
+		return max;
+	}
+
+	size_t getPercentilesNo() const {
+		return quantiles.size();
+	}
+
+	/**
+	 * Returns the fraction (0..1) of the i-th percentile.
+	 */
+	double getPercentileFraction(size_t i) const {
+		return quantiles[i].p;
+	}
+
+	/**
+	 * Returns the estimate of the i-th percentile.
+	 */
+	double getPercentile(size_t i) const;
+
+	/**
+	 * Returns the estimate of the percentile p (0..1); if it's not one of the estimated ones, interpolates
+	 * between the nearest ones.
+	 */
+	double getPercentileAt(double p) const;
+
+	size_t getBinsNo() const {
+		return bins.size();
+	}
+
+	/**
+	 * Returns the number of values in the bin.
+	 */
+	size_t getBin(size_t i) const;
+
+	/**
+	 * Returns the lower bound of the bin (i = getBinsNo() returns the upper bound of the last bin).
+	 */
+	double getBinEdge(size_t i) const;
+
+	size_t getUnderflow() const {
+		return underflow;
+	}
+
+	size_t getOverflow() const {
+		return overflow;
+	}
+};
+
+/**
+ * Propagates the uncertainty of the configuration parameters to the performance of the engine.
+ *
+ * Samples are solved on the thread pool in batches, each thread with its own copy of the configuration, and
+ * the results of each batch are added to the statistics (see StreamingStatistics) in the order of the samples, so
+ * that no sample is kept after its batch. The values of each sample are drawn from the generator seeded by the
+ * seed and the index of the sample, so that the results do not depend on the number of threads.
+ */
+class MonteCarloAnalysis {
+private:
+	struct Variable {
+		MonteCarloParameter type;
+		MonteCarloDistribution distribution;
+		double a;
+		double b;
+		double c;
+	};
+
+	thermo::input::ConfigFile* data;
+	int threads;
+
+	std::vector<Variable> variables;
+	double pa;
+	unsigned int seed;
+	bool correctionFactors;
+	int bins;
+	size_t batchSize;
+
+	std::vector<StreamingStatistics> statistics;
+	size_t samplesNo;
+	size_t failedNo;
+
+	void addVariable(MonteCarloParameter type, MonteCarloDistribution distribution, double a, double b, double c);
+
+protected:
+	/**
+	 * Called after each batch of samples; return false to stop the analysis.
+	 *
+	 * @param samples number of the samples done so far
+	 * @param total number of the samples requested
+	 */
+	virtual bool progress(size_t samples, size_t total) {
+		return true;
+	}
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	MonteCarloAnalysis(thermo::input::ConfigFile* data, int threads = 0);
+
+	virtual ~MonteCarloAnalysis() {
+	}
+
+	/**
+	 * Adds the parameter of normal distribution, truncated at the given number of standard deviations from the mean.
+	 * Pressure is in Pa, temperature is in K.
+	 */
+	void addNormal(MonteCarloParameter type, double mean, double sigma, double truncation = 3);
+
+	void addUniform(MonteCarloParameter type, double min, double max);
+
+	void addTriangular(MonteCarloParameter type, double min, double mode, double max);
+
+	size_t getVariablesNo() const {
+		return variables.size();
+	}
+
+	/**
+	 * Sets the ambient pressure (Pa) of the delivered specific impulse (vacuum by default).
+	 */
+	void setAmbientPressure(double pa) {
+		this->pa = pa;
+	}
+
+	void setSeed(unsigned int seed) {
+		this->seed = seed;
+	}
+
+	/**
+	 * Specifies whether the performance correction factors are applied to the specific impulse and mass flow rate
+	 * (true by default). Efficiency parameters have no effect otherwise.
+	 */
+	void setCorrectionFactors(bool correctionFactors) {
+		this->correctionFactors = correctionFactors;
+	}
+
+	/**
+	 * Sets the number of the bins of the histograms (50 by default).
+	 */
+	void setBins(int bins) {
+		this->bins = bins;
+	}
+
+	/**
+	 * Sets the number of the samples solved between the updates of the statistics; 0 (default) chooses it
+	 * by the number of threads.
+	 */
+	void setBatchSize(size_t batchSize) {
+		this->batchSize = batchSize;
+	}
+
+	/**
+	 * Draws the values of the variables of the sample.
+	 */
+	void sample(size_t i, double* x) const;
+
+	/**
+	 * Solves the sample using given configuration object.
+	 *
+	 * @param values array of MONTE_CARLO_OUTPUTS_NO results
+	 * @return false if the sample could not be solved
+	 */
+	bool solveSample(thermo::input::ConfigFile* config, size_t i, double* values) const;
+
+	/**
+	 * Solves the samples 0..samples-1 and collects the statistics.
+	 *
+	 * @return number of the samples solved
+	 */
+	size_t run(size_t samples);
+
+	const StreamingStatistics& getStatistics(MonteCarloOutput output) const {
+		return statistics[output];
+	}
+
+	/**
+	 * Returns the number of the samples solved by the last run.
+	 */
+	size_t getSamplesNo() const {
+		return samplesNo;
+	}
+
+	/**
+	 * Returns the number of the samples which could not be solved by the last run.
+	 */
+	size_t getFailedNo() const {
+		return failedNo;
+	}
+};
+
+#endif /* EXAMPLES_MONTE_CARLO_HPP_ */
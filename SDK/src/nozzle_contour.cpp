@@ -0,0 +1,119 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cmath>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/dll/Export.hpp"
+#include "nozzle/MocNozzle.hpp"
+
+#include "nozzle_contour.hpp"
+
+void getMocWallAngles(design::MocNozzle* nozzle, const double* t, size_t n, double* theta) {
+	for (size_t i=0; i<n; ++i) {
+		design::moc::Point* p = nozzle->getPoint(t[i]);
+		theta[i] = p->theta();
+		delete p;
+	}
+}
+
+/**
+ * Number of the intervals of the coarse scan.
+ */
+static const int mocScanIntervals = 20;
+
+double findMocMaxWallAngle(design::MocNozzle* nozzle, double* t_max, double tolerance, int* evaluations) {
+	int n = 0;
+
+	// Coarse scan until the angle starts to decrease; the maximum is then between the previous and the current point
+	double dt = 1./mocScanIntervals;
+	double t0 = 0, t1 = 0;
+	double theta_max = 0;
+	double t_best = 0;
+	for (int i=0; i<=mocScanIntervals; ++i) {
+		double t = i==mocScanIntervals ? 1.0 : i*dt;
+		double theta;
+		getMocWallAngles(nozzle, &t, 1, &theta);
+		++n;
+
+		if (0==i || theta>=theta_max) {
+			theta_max = theta;
+			t_best = t;
+			t0 = i>0 ? t - dt : 0;
+			t1 = t;
+		} else {
+			t1 = t;
+			break;
+		}
+	}
+
+	// Golden section search in [t0, t1]
+	static const double g = 0.5*(sqrt(5.) - 1.);
+
+	double a = t0, b = t1;
+	double c = b - g*(b - a), d = a + g*(b - a);
+	double tc[] = {c, d};
+	double theta_c[2];
+	getMocWallAngles(nozzle, tc, 2, theta_c);
+	n += 2;
+	double fc = theta_c[0], fd = theta_c[1];
+
+	while (b - a>tolerance) {
+		if (fc>fd) {
+			b = d;
+			d = c;
+			fd = fc;
+			c = b - g*(b - a);
+			getMocWallAngles(nozzle, &c, 1, &fc);
+		} else {
+			a = c;
+			c = d;
+			fc = fd;
+			d = a + g*(b - a);
+			getMocWallAngles(nozzle, &d, 1, &fd);
+		}
+		++n;
+	}
+
+	if (fc>theta_max) {
+		theta_max = fc;
+		t_best = c;
+	}
+	if (fd>theta_max) {
+		theta_max = fd;
+		t_best = d;
+	}
+
+	if (t_max) {
+		*t_max = t_best;
+	}
+	if (evaluations) {
+		*evaluations = n;
+	}
+	return theta_max;
+}
+
+void getMocNozzleSummary(design::MocNozzle* nozzle, NozzleContourSummary& summary, double tolerance) {
+	summary.Tn_max = findMocMaxWallAngle(nozzle, &summary.t_max, tolerance, &summary.evaluations);
+	summary.Te = nozzle->getTe()*M_PI/180.;
+	summary.Le = nozzle->getLe();
+}
@@ -0,0 +1,66 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_NOZZLE_CONTOUR_HPP_
+#define EXAMPLES_NOZZLE_CONTOUR_HPP_
+
+#include <cstddef>
+
+#include "thermodynamics/dll/Export.hpp"
+#include "nozzle/MocNozzle.hpp"
+
+/**
+ * Parameters of the designed MOC nozzle contour.
+ */
+struct NozzleContourSummary {
+	double Tn_max;				// maximum wall angle, rad
+	double t_max;				// contour parameter of the maximum wall angle (0 - throat, 1 - exit)
+	double Te;					// exit wall angle, rad
+	double Le;					// nozzle length, m
+	int evaluations;			// number of the contour points queried
+};
+
+/**
+ * Fills the wall angles (rad) of the MOC nozzle at n values of the contour parameter (0 - throat, 1 - exit)
+ * into the array provided by the caller.
+ *
+ * Each point returned by MocNozzle::getPoint() is released as soon as its angle is taken, so that no more than
+ * one point exists at a time.
+ */
+extern void getMocWallAngles(design::MocNozzle* nozzle, const double* t, size_t n, double* theta);
+
+/**
+ * Finds the maximum wall angle (rad) of the MOC nozzle: the contour is scanned with the coarse step until the angle
+ * starts to decrease, and the maximum is then refined by golden section search in the bracketing interval.
+ *
+ * @param t_max if not NULL, receives the contour parameter of the maximum
+ * @param tolerance tolerance of the contour parameter
+ * @param evaluations if not NULL, receives the number of the contour points queried
+ */
+extern double findMocMaxWallAngle(design::MocNozzle* nozzle, double* t_max = NULL, double tolerance = 1e-5, int* evaluations = NULL);
+
+/**
+ * Returns the parameters of the designed contour in one call.
+ */
+extern void getMocNozzleSummary(design::MocNozzle* nozzle, NozzleContourSummary& summary, double tolerance = 1e-5);
+
+#endif /* EXAMPLES_NOZZLE_CONTOUR_HPP_ */
@@ -0,0 +1,112 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "database.hpp"
+#include "nozzle_optimizer.hpp"
+
+/**
+ * Prints out the candidate and its result.
+ */
+static void printContour(const NozzleContourOptimizer& optimizer, size_t i) {
+	const NozzleContourCandidate& c = optimizer.getCandidate(i);
+	const NozzleContourResult& r = optimizer.getResult(i);
+
+	if (NOZZLE_CONTOUR_PARABOLIC==c.type) {
+		printf("parabolic l=%5.2f Tn=%5.2f Te=%5.2f", c.l, c.tn, c.te);
+	} else {
+		printf("MOC   Le_bar=%6.2f       Te=%5.2f", c.Le_bar, r.Te);
+	}
+	printf("  Le=%8.2f mm  efficiency=%7.5f  Is_v=%7.2f s  objective=%7.2f s\n",
+		r.Le*1000., r.efficiency, r.Is_v/CONST_G, r.objective/CONST_G);
+}
+
+/**
+ * This example searches the parabolic and MOC nozzle contours for the exit area ratio of the engine,
+ * and prints out the best contour and the Pareto front of nozzle length vs. delivered specific impulse.
+ * The candidates are evaluated in parallel, with the correction factors calculated for each contour.
+ *
+ * Usage: nozzle_optimization [configuration file]
+ */
+int main(int argc, char* argv[]) {
+
+	const char* configPath = argc>1 ? argv[1] : "examples/RD-170.cfg";
+
+	util::Log::createLog("ROOT")->
+		addLogger(new util::FileLogger("", 10*1024));
+
+	// Initialize thermodatabase
+	initThermoDatabase(THERMO_DATABASE_OPTION_LAZY);
+
+	// Initialize configuration file object
+	thermo::input::ConfigFile* data = new thermo::input::ConfigFile(configPath);
+
+	// Read configuration file
+	data->read();
+
+	// Load species of the propellant and reaction products
+	loadThermoSpecies(data);
+
+	// Use all hardware threads
+	NozzleContourOptimizer optimizer(data);
+
+	// Parabolic contours: 60..100% of the length of 15 deg conical nozzle, initial angle 20..40 deg, exit angle 4..16 deg
+	optimizer.addParabolicGrid(0.6, 1.0, 9, 20., 40., 11, 4., 16., 13);
+
+	// MOC contours: 5..30 throat radii
+	optimizer.addMocGrid(5., 30., 26);
+
+	// Average over the ascent: vacuum and 10, 20 km
+	optimizer.addAltitude(10000., 1.);
+	optimizer.addAltitude(20000., 1.);
+
+	size_t evaluated = optimizer.run();
+	printf("# %u of %u contours evaluated\n", (unsigned int)evaluated, (unsigned int)optimizer.getCandidatesNo());
+
+	size_t best = optimizer.getBest();
+	if (best<optimizer.getCandidatesNo()) {
+		printf("# Best contour\n");
+		printContour(optimizer, best);
+
+		std::vector<size_t> front;
+		optimizer.getParetoFront(front);
+
+		printf("# Pareto front: nozzle length vs. objective\n");
+		for (size_t i=0; i<front.size(); ++i) {
+			printContour(optimizer, front[i]);
+		}
+	}
+
+	delete data;
+
+	util::Log::finalize();
+
+	return 0;
+}
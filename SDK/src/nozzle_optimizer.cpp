@@ -0,0 +1,315 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+#include "thermodynamics/gasdynamics/StandardAtmosphere.hpp"
+
+#include "nozzle/ParabolicNozzle.hpp"
+#include "nozzle/MocNozzle.hpp"
+
+#include "common.hpp"
+#include "nozzle_optimizer.hpp"
+#include "threadpool.hpp"
+
+NozzleContourOptimizer::NozzleContourOptimizer(thermo::input::ConfigFile* data, int threads) :
+	data(data),
+	threads(threads),
+	applyCorrectionFactors(true),
+	vacuumWeight(1) {
+
+	R1 = data->getEngineSize().getChamberGeometry().getR1ToRtRatio();
+	Rn = data->getEngineSize().getChamberGeometry().getRnToRtRatio();
+}
+
+void NozzleContourOptimizer::addAltitude(double H, double weight) {
+	StandardAtmosphere sa;
+	sa.setAltitude(H);
+
+	Altitude a;
+	a.H = H;
+	a.pa = sa.getPressure();
+	a.weight = weight;
+	altitudes.push_back(a);
+}
+
+void NozzleContourOptimizer::addParabolicGrid(double lMin, double lMax, int lNo,
+		double tnMin, double tnMax, int tnNo, double teMin, double teMax, int teNo) {
+
+	NozzleContourCandidate c;
+	c.type = NOZZLE_CONTOUR_PARABOLIC;
+	c.Le_bar = 0;
+
+	for (int i=0; i<lNo; ++i) {
+		c.l = lNo>1 ? lMin + (lMax - lMin)*i/(lNo - 1) : lMin;
+		for (int j=0; j<tnNo; ++j) {
+			c.tn = tnNo>1 ? tnMin + (tnMax - tnMin)*j/(tnNo - 1) : tnMin;
+			for (int k=0; k<teNo; ++k) {
+				c.te = teNo>1 ? teMin + (teMax - teMin)*k/(teNo - 1) : teMin;
+				if (c.te<c.tn) {
+					candidates.push_back(c);
+				}
+			}
+		}
+	}
+}
+
+void NozzleContourOptimizer::addMocGrid(double LeMin, double LeMax, int LeNo) {
+	NozzleContourCandidate c;
+	c.type = NOZZLE_CONTOUR_MOC;
+	c.l = 0;
+	c.tn = 0;
+	c.te = 0;
+
+	for (int i=0; i<LeNo; ++i) {
+		c.Le_bar = LeNo>1 ? LeMin + (LeMax - LeMin)*i/(LeNo - 1) : LeMin;
+		candidates.push_back(c);
+	}
+}
+
+double NozzleContourOptimizer::getObjective(double Is_v, double F) const {
+	double sum = vacuumWeight*Is_v;
+	double weights = vacuumWeight;
+	for (size_t i=0; i<altitudes.size(); ++i) {
+		sum += altitudes[i].weight*(Is_v - F*altitudes[i].pa);
+		weights += altitudes[i].weight;
+	}
+	return weights>0 ? sum/weights : Is_v;
+}
+
+/**
+ * Task of the worker thread: evaluates one candidate using the configuration of the thread.
+ */
+struct NozzleContourTask {
+	/**
+	 * Solved problem of the thread, created on its first task.
+	 */
+	struct Worker {
+		thermo::input::ConfigFile* config;			// owned by WorkerConfigs
+		performance::TheoreticalPerformance* performance;
+		PerformanceSnapshot snapshot;
+		double Fr;									// exit area ratio
+		bool failed;
+	};
+
+	NozzleContourOptimizer* optimizer;
+	WorkerConfigs* configs;
+	std::vector<Worker> workers;
+
+	bool init(Worker& w) {
+		// Nozzle efficiency is calculated for the contour of each candidate
+		w.config->getNozzleFlowOptions().setEfficiencyFactors().deleteNozzleEfficiency();
+		w.config->getNozzleFlowOptions().setEfficiencyFactors().deleteConeHalfAngle();
+
+		try {
+			w.performance = new performance::TheoreticalPerformance(w.config, false);
+			w.performance->solve();
+			getPerformanceSnapshot(w.performance, NULL, w.snapshot);
+
+			design::Chamber* chamber = createChamber(w.performance, NULL);
+			if (!chamber) {
+				util::Log::errorf("NOZZLE", "Engine size design parameters not defined%s", CR);
+				return false;
+			}
+			w.Fr = chamber->getFre();
+			delete chamber;
+		} catch (const std::exception& ex) {
+			util::Log::errorf("NOZZLE", "Could not design chamber: %s%s", ex.what(), CR);
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Sets the type, length and wall angles of the candidate in the configuration.
+	 */
+	static void setContour(thermo::input::ConfigFile* config, const NozzleContourCandidate& c, double Fr) {
+		if (NOZZLE_CONTOUR_PARABOLIC==c.type) {
+			config->getEngineSize().getChamberGeometry().setTOC(false);
+			config->getEngineSize().getChamberGeometry().setParabolicInitialAngle(c.tn);
+			config->getEngineSize().getChamberGeometry().setParabolicExitAngle(c.te);
+			config->getNozzleFlowOptions().setEfficiencyFactors().setNozzleLength(100.*c.l);
+		} else {
+			// Length of 15 deg conical nozzle of the same exit area ratio, relative to the throat radius
+			double L15_bar = (sqrt(Fr) - 1.)/tan(15.*M_PI/180.);
+			config->getEngineSize().getChamberGeometry().setTOC(true);
+			config->getNozzleFlowOptions().setEfficiencyFactors().setNozzleLength(100.*c.Le_bar/L15_bar);
+		}
+	}
+
+	void operator()(size_t task, int worker) {
+		Worker& w = workers[worker];
+		if (!w.config) {
+			w.config = configs->get(worker);
+			w.failed = !init(w);
+		}
+		if (w.failed) {
+			return;
+		}
+
+		const NozzleContourCandidate& c = optimizer->candidates[task];
+		setContour(w.config, c, w.Fr);
+
+		performance::efficiency::CorrectionFactors* correctionFactors = NULL;
+		design::Chamber* chamber = NULL;
+		design::Nozzle* nozzle = NULL;
+		double efficiency = 1;
+		double Le = 0;
+		double Te = 0;
+		try {
+			correctionFactors = new performance::efficiency::CorrectionFactors(w.performance);
+			if (optimizer->applyCorrectionFactors) {
+				efficiency = correctionFactors->getOverallEfficiency();
+				chamber = createChamber(w.performance, correctionFactors);
+			} else {
+				efficiency = correctionFactors->getNozzleEfficiency();
+				chamber = createChamber(w.performance, NULL);
+			}
+
+			if (NOZZLE_CONTOUR_PARABOLIC==c.type) {
+				design::ParabolicNozzle* parabolic = new design::ParabolicNozzle(chamber);
+				nozzle = parabolic;
+				parabolic->calcGeometry(c.tn, c.te, optimizer->R1, optimizer->Rn, c.l);
+				Le = parabolic->getL();
+				Te = c.te;
+			} else {
+				design::MocNozzle* moc = new design::MocNozzle(chamber);
+				nozzle = moc;
+				moc->calcGeometryAtFixedAreaAndLength(chamber->getFre(), c.Le_bar, optimizer->R1, optimizer->Rn);
+				Le = moc->getLe();
+				Te = moc->getTe();
+			}
+		} catch (const std::exception& ex) {
+			util::Log::warnf("NOZZLE", "Could not design candidate %u: %s%s", (unsigned int)task, ex.what(), CR);
+			delete nozzle;
+			delete chamber;
+			delete correctionFactors;
+			return;
+		}
+		delete nozzle;
+		delete chamber;
+		delete correctionFactors;
+
+		NozzleContourResult& r = optimizer->results[task];
+		r.Le = Le;
+		r.Te = Te;
+		r.efficiency = efficiency;
+		r.Is_v = efficiency*w.snapshot.Is_v;
+		r.objective = optimizer->getObjective(r.Is_v, w.snapshot.F);
+		r.solved = true;
+	}
+};
+
+size_t NozzleContourOptimizer::run() {
+	size_t n = candidates.size();
+
+	NozzleContourResult empty;
+	empty.solved = false;
+	empty.Le = empty.Te = empty.efficiency = empty.Is_v = empty.objective = std::numeric_limits<double>::quiet_NaN();
+	results.assign(n, empty);
+
+	if (0==n) {
+		return 0;
+	}
+
+	ThreadPool pool(threads);
+
+	WorkerConfigs configs(data);
+	configs.prepare(pool.getThreads());
+
+	NozzleContourTask::Worker worker;
+	worker.config = NULL;
+	worker.performance = NULL;
+	worker.Fr = 0;
+	worker.failed = false;
+
+	NozzleContourTask task;
+	task.optimizer = this;
+	task.configs = &configs;
+	task.workers.assign(pool.getThreads(), worker);
+
+	pool.run(n, task);
+
+	for (size_t i=0; i<task.workers.size(); ++i) {
+		delete task.workers[i].performance;
+	}
+
+	size_t evaluated = 0;
+	for (size_t i=0; i<n; ++i) {
+		evaluated += results[i].solved ? 1 : 0;
+	}
+	return evaluated;
+}
+
+size_t NozzleContourOptimizer::getBest() const {
+	size_t best = candidates.size();
+	for (size_t i=0; i<results.size(); ++i) {
+		if (results[i].solved && (best==candidates.size() || results[i].objective>results[best].objective)) {
+			best = i;
+		}
+	}
+	return best;
+}
+
+/**
+ * Orders the candidates by increasing length, and by decreasing objective at the same length.
+ */
+struct NozzleContourLengthLess {
+	const std::vector<NozzleContourResult>* results;
+
+	bool operator()(size_t a, size_t b) const {
+		const NozzleContourResult& ra = (*results)[a];
+		const NozzleContourResult& rb = (*results)[b];
+		if (ra.Le!=rb.Le) {
+			return ra.Le<rb.Le;
+		}
+		return ra.objective>rb.objective;
+	}
+};
+
+void NozzleContourOptimizer::getParetoFront(std::vector<size_t>& front) const {
+	front.clear();
+
+	std::vector<size_t> order;
+	for (size_t i=0; i<results.size(); ++i) {
+		if (results[i].solved) {
+			order.push_back(i);
+		}
+	}
+
+	NozzleContourLengthLess less;
+	less.results = &results;
+	std::sort(order.begin(), order.end(), less);
+
+	// Candidate is not dominated if no shorter one gives the same or higher objective
+	for (size_t i=0; i<order.size(); ++i) {
+		if (front.empty() || results[order[i]].objective>results[front.back()].objective) {
+			front.push_back(order[i]);
+		}
+	}
+}
@@ -0,0 +1,184 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_NOZZLE_OPTIMIZER_HPP_
+#define EXAMPLES_NOZZLE_OPTIMIZER_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "performance_cache.hpp"
+
+/**
+ * Type of the nozzle contour.
+ */
+enum NozzleContourType {
+	NOZZLE_CONTOUR_PARABOLIC = 0,	// parabolic contour (ParabolicNozzle::calcGeometry)
+	NOZZLE_CONTOUR_MOC = 1			// MOC contour with the exit area ratio of the chamber (MocNozzle::calcGeometryAtFixedAreaAndLength)
+};
+
+/**
+ * Parameters of one nozzle contour; the ones not used by the type are ignored.
+ */
+struct NozzleContourCandidate {
+	NozzleContourType type;
+	double l;					// parabolic: nozzle length relative to the length of 15 deg conical nozzle
+	double tn;					// parabolic: initial wall angle, deg
+	double te;					// parabolic: exit wall angle, deg
+	double Le_bar;				// MOC: nozzle length relative to the throat radius
+};
+
+/**
+ * Evaluated nozzle contour.
+ */
+struct NozzleContourResult {
+	bool solved;
+	double Le;					// nozzle length, m
+	double Te;					// exit wall angle, deg
+	double efficiency;			// correction factor of the theoretical specific impulse
+	double Is_v;				// delivered vacuum specific impulse, m/s
+	double objective;			// delivered specific impulse to maximize, m/s
+};
+
+/**
+ * Search of the nozzle contour (length, initial and exit wall angles) which gives maximum delivered specific impulse
+ * for the exit area ratio of the chamber.
+ *
+ * Candidates are evaluated on the thread pool. Each thread solves the performance of its own copy of the
+ * configuration once, and then evaluates its candidates one by one: the type, length and wall angles of the
+ * candidate are set in the copy (the nozzle efficiency and the cone half angle of the configuration are removed
+ * from it), and the delivered specific impulse is the theoretical one multiplied by the efficiency of
+ * CorrectionFactors calculated for that copy. The chamber is sized with these correction factors, and the contour
+ * is designed on it.
+ *
+ * Shorter nozzles give lower specific impulse, so the result is a trade-off; see getParetoFront().
+ */
+class NozzleContourOptimizer {
+private:
+	struct Altitude {
+		double H;						// altitude, m
+		double pa;						// ambient pressure, Pa
+		double weight;
+	};
+
+	thermo::input::ConfigFile* data;
+	int threads;
+	bool applyCorrectionFactors;
+
+	double R1;
+	double Rn;
+
+	std::vector<Altitude> altitudes;
+	double vacuumWeight;
+
+	std::vector<NozzleContourCandidate> candidates;
+	std::vector<NozzleContourResult> results;
+
+	friend struct NozzleContourTask;
+
+	double getObjective(double Is_v, double F) const;
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	NozzleContourOptimizer(thermo::input::ConfigFile* data, int threads = 0);
+
+	/**
+	 * Specifies whether the delivered specific impulse includes all the correction factors, and the chamber is sized
+	 * with them (true by default). Otherwise only the nozzle efficiency is applied, and the chamber is sized without
+	 * correction factors.
+	 */
+	void setCorrectionFactors(bool applyCorrectionFactors) {
+		this->applyCorrectionFactors = applyCorrectionFactors;
+	}
+
+	/**
+	 * Sets the radii of the throat arcs relative to the throat radius (taken from the configuration by default).
+	 */
+	void setThroatRadii(double R1, double Rn) {
+		this->R1 = R1;
+		this->Rn = Rn;
+	}
+
+	/**
+	 * Adds the altitude (m) of the mission with the weight of its specific impulse in the objective.
+	 */
+	void addAltitude(double H, double weight);
+
+	/**
+	 * Sets the weight of vacuum specific impulse in the objective (1 by default).
+	 */
+	void setVacuumWeight(double weight) {
+		vacuumWeight = weight;
+	}
+
+	void addCandidate(const NozzleContourCandidate& candidate) {
+		candidates.push_back(candidate);
+	}
+
+	/**
+	 * Adds the grid of parabolic contours; the ones with the exit angle not less than the initial one are skipped.
+	 */
+	void addParabolicGrid(double lMin, double lMax, int lNo, double tnMin, double tnMax, int tnNo, double teMin, double teMax, int teNo);
+
+	/**
+	 * Adds the MOC contours of lengths from LeMin to LeMax (relative to the throat radius).
+	 */
+	void addMocGrid(double LeMin, double LeMax, int LeNo);
+
+	size_t getCandidatesNo() const {
+		return candidates.size();
+	}
+
+	const NozzleContourCandidate& getCandidate(size_t i) const {
+		return candidates[i];
+	}
+
+	/**
+	 * Evaluates all the candidates.
+	 *
+	 * @return number of the candidates evaluated
+	 */
+	size_t run();
+
+	const NozzleContourResult& getResult(size_t i) const {
+		return results[i];
+	}
+
+	/**
+	 * Returns the index of the candidate with maximum objective, or getCandidatesNo() if none is evaluated.
+	 */
+	size_t getBest() const;
+
+	/**
+	 * Fills the indices of the candidates which are not dominated in both nozzle length and objective,
+	 * in the order of increasing length.
+	 */
+	void getParetoFront(std::vector<size_t>& front) const;
+};
+
+#endif /* EXAMPLES_NOZZLE_OPTIMIZER_HPP_ */
@@ -27,6 +27,7 @@
 #include "thermodynamics/gasdynamics/StandardAtmosphere.hpp"
 
 #include "common.hpp"
+#include "mixture_ratio.hpp"
 
 /**
  * This example calculates the performance of rocket engine using pre-defined configuration file.
@@ -61,15 +62,20 @@ int main(int argc, char* argv[]) {
 	//
 	// etc.
 
+	if (optimizePropellant && thermo::input::Ratio::fractions!=data->getPropellant().getRatioType()) {
+		// Find optimal mixture ratio for given propellant, solving the probes on all hardware threads,
+		// and set it in the configuration
+		MixtureRatioOptimizer optimizer(data);
+		optimizer.setTolerance(1e-4);
+		optimizer.run();
+	}
+
 	// Initialize performance solver
 	performance::TheoreticalPerformance* performance = new performance::TheoreticalPerformance(data, false);
 
-	if (optimizePropellant && thermo::input::Ratio::fractions!=data->getPropellant().getRatioType()) {
-		// Find optimal mixture ratio for given propellant
-		performance->optimizeForSpecificImpulse();
-	} else {
-		performance->solve();
-	}
+	// Solve
+	performance->solve();
+
 	// O/F ratio
 	double r = performance->getPropellant()->getKm();
 
@@ -27,6 +27,7 @@
 #include "thermodynamics/gasdynamics/StandardAtmosphere.hpp"
 
 #include "common.hpp"
+#include "correction_factors.hpp"
 
 
 /**
@@ -94,6 +95,9 @@ int main(int argc, char* argv[]) {
 
 	StandardAtmosphere sa;
 
+	// Correction factor doesn't depend on altitude
+	CorrectionFactorsCache correctionFactors(performance);
+
 	for (int i=0; i<H_size; ++i) {
 		sa.setAltitude(H[i]);
 
@@ -136,10 +140,8 @@ int main(int argc, char* argv[]) {
 		// Performance correction factor
 		double phi = 1.0;
 		if (applyCorrectionFactor) {
-			// Get performance correction factor
-			performance::efficiency::CorrectionFactors* correctionFactors = new performance::efficiency::CorrectionFactors(performance);
-			phi = correctionFactors->getOverallEfficiency();
-			delete correctionFactors;
+			// Get performance correction factor (calculated at the first altitude only)
+			phi = correctionFactors.getOverallEfficiency();
 		}
 
 		// Specific impulse at defined altitude, m/s
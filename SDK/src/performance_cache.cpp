@@ -0,0 +1,352 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "database.hpp"
+#include "performance_cache.hpp"
+
+static const char performanceCacheMagic[8] = {'R', 'P', 'A', 'P', 'E', 'R', 'F', 0};
+
+static uint64_t hashDouble(double value, uint64_t checksum) {
+	// +0 and -0 are the same input
+	if (0==value) {
+		value = 0;
+	}
+	return fnv1a(&value, sizeof(value), checksum);
+}
+
+static uint64_t hashInt(int64_t value, uint64_t checksum) {
+	return fnv1a(&value, sizeof(value), checksum);
+}
+
+static uint64_t hashString(const std::string& value, uint64_t checksum) {
+	return fnv1a(value.c_str(), value.size() + 1, checksum);
+}
+
+static uint64_t hashComponent(thermo::input::Component& c, uint64_t checksum) {
+	checksum = hashString(c.getName(), checksum);
+	checksum = hashDouble(c.getMf(), checksum);
+	checksum = hashDouble(c.getT(thermo::input::Temperature::K), checksum);
+	checksum = hashDouble(c.getP(thermo::input::Pressure::Pa), checksum);
+	return checksum;
+}
+
+bool getPerformanceCacheKey(thermo::input::ConfigFile* data, uint64_t& key) {
+	// Values of freezing and nozzle inlet conditions can not be read back from the configuration object
+	thermo::input::NozzleFlowOptions& flowOptions = data->getNozzleFlowOptions();
+	if ((flowOptions.isFreezingConditionsSet() && flowOptions.getFreezingConditions().isCalculate()) || flowOptions.isNozzleInletConditionsSet()) {
+		return false;
+	}
+
+	uint64_t checksum = hashInt(PERFORMANCE_CACHE_VERSION, fnv1a(NULL, 0));
+
+	uint64_t databaseVersion = getThermoDatabaseVersion();
+	checksum = fnv1a(&databaseVersion, sizeof(databaseVersion), checksum);
+
+	// Species options
+	checksum = hashInt(data->getGeneralOptions().isMultiphase() ? 1 : 0, checksum);
+	checksum = hashInt(data->getGeneralOptions().isIons() ? 1 : 0, checksum);
+
+	// Propellant
+	thermo::input::Propellant& propellant = data->getPropellant();
+	checksum = hashInt(propellant.getRatioType(), checksum);
+	if (thermo::input::Ratio::fractions!=propellant.getRatioType()) {
+		checksum = hashDouble(propellant.getRatio(), checksum);
+	}
+
+	checksum = hashInt(propellant.getOxidizerListSize(), checksum);
+	for (int i=0, size=propellant.getOxidizerListSize(); i<size; ++i) {
+		checksum = hashComponent(propellant.getOxidizer(i), checksum);
+	}
+	checksum = hashInt(propellant.getFuelListSize(), checksum);
+	for (int i=0, size=propellant.getFuelListSize(); i<size; ++i) {
+		checksum = hashComponent(propellant.getFuel(i), checksum);
+	}
+	checksum = hashInt(propellant.getSpeciesListSize(), checksum);
+	for (int i=0, size=propellant.getSpeciesListSize(); i<size; ++i) {
+		checksum = hashComponent(propellant.getSpecies(i), checksum);
+	}
+
+	// Combustion chamber
+	checksum = hashDouble(data->getCombustionChamberConditions().getPressure(thermo::input::Pressure::Pa), checksum);
+
+	// Nozzle exit
+	checksum = hashInt(flowOptions.isCalculateNozzleFlow() ? 1 : 0, checksum);
+
+	thermo::input::NozzleSectionConditions& exitConditions = flowOptions.getNozzleExitConditions();
+	if (exitConditions.isAreaRatio()) {
+		checksum = hashInt(1, checksum);
+		checksum = hashDouble(exitConditions.getAreaRatio(), checksum);
+	} else if (exitConditions.isPressureRatio()) {
+		checksum = hashInt(2, checksum);
+		checksum = hashDouble(exitConditions.getPressureRatio(), checksum);
+	} else if (exitConditions.isPressure()) {
+		checksum = hashInt(3, checksum);
+		checksum = hashDouble(exitConditions.getPressure(), checksum);
+	} else {
+		checksum = hashInt(0, checksum);
+	}
+
+	key = checksum;
+	return true;
+}
+
+bool solvePerformance(PerformanceCache* cache, thermo::input::ConfigFile* data, PerformanceSnapshot& snapshot) {
+	if (cache) {
+		return cache->solve(data, snapshot);
+	}
+
+	performance::TheoreticalPerformance* performance = new performance::TheoreticalPerformance(data, false);
+	try {
+		performance->solve();
+		getPerformanceSnapshot(performance, NULL, snapshot);
+	} catch (...) {
+		delete performance;
+		throw;
+	}
+	delete performance;
+
+	return false;
+}
+
+void getPerformanceSnapshot(performance::TheoreticalPerformance* performance,
+		performance::equilibrium::NozzleSectionConditions* exitSection, PerformanceSnapshot& snapshot) {
+
+	if (!exitSection) {
+		exitSection = performance->getExitSection();
+	}
+
+	snapshot.r = performance->getPropellant()->getKm();
+
+	// Injector station (0)
+	reaction::Reaction* injector = performance->getChamber()->getReaction(0);
+	snapshot.T_c = injector->getT();
+	snapshot.p_c = injector->getP();
+
+	reaction::Reaction* throat = performance->getChamber()->getReaction(performance::equilibrium::Chamber::THROAT);
+	snapshot.T_t = throat->getT();
+	snapshot.p_t = throat->getP();
+	snapshot.k_t = performance->getChamber()->getDerivatives(performance::equilibrium::Chamber::THROAT)->getK();
+
+	snapshot.Is_v = exitSection->getIs_v();
+	snapshot.Is = exitSection->getIs();
+	snapshot.F = exitSection->getF();
+	snapshot.p_e = exitSection->getP();
+	snapshot.k_e = exitSection->getK();
+	snapshot.M_e = exitSection->getMach();
+	snapshot.rho_e = exitSection->getRho();
+	snapshot.w_e = exitSection->getW();
+}
+
+//*****************************************************************************
+
+PerformanceCache::PerformanceCache(size_t capacity, const char* path) :
+	capacity(capacity), path(path ? path : ""), hits(0), misses(0) {
+
+	if (!this->path.empty() && !makeDirectory(this->path.c_str())) {
+		util::Log::warnf("CACHE", "Could not create directory %s, results will be kept in memory only%s", this->path.c_str(), CR);
+		this->path.clear();
+	}
+}
+
+std::string PerformanceCache::getRecordPath(uint64_t key) const {
+	char buffer[32];
+	sprintf(buffer, "/%016llx.bin", (unsigned long long)key);
+	return path + buffer;
+}
+
+bool PerformanceCache::readRecord(uint64_t key, PerformanceSnapshot& snapshot) const {
+	if (path.empty()) {
+		return false;
+	}
+
+	FILE* f = fopen(getRecordPath(key).c_str(), "rb");
+	if (!f) {
+		return false;
+	}
+
+	PerformanceCacheRecord record;
+	bool ok = 1==fread(&record, sizeof(record), 1, f);
+	fclose(f);
+
+	if (!ok
+			|| 0!=memcmp(record.magic, performanceCacheMagic, sizeof(record.magic))
+			|| PERFORMANCE_CACHE_VERSION!=record.version
+			|| sizeof(PerformanceSnapshot)!=record.size
+			|| key!=record.key
+			|| record.checksum!=fnv1a(&record, offsetof(PerformanceCacheRecord, checksum))) {
+		return false;
+	}
+
+	snapshot = record.snapshot;
+	return true;
+}
+
+void PerformanceCache::writeRecord(uint64_t key, const PerformanceSnapshot& snapshot) const {
+	if (path.empty()) {
+		return;
+	}
+
+	PerformanceCacheRecord record;
+	memset(&record, 0, sizeof(record));
+	memcpy(record.magic, performanceCacheMagic, sizeof(record.magic));
+	record.version = PERFORMANCE_CACHE_VERSION;
+	record.size = sizeof(PerformanceSnapshot);
+	record.key = key;
+	record.snapshot = snapshot;
+	record.checksum = fnv1a(&record, offsetof(PerformanceCacheRecord, checksum));
+
+	// Write the temporary file and rename it, so that other processes never read incomplete record
+	std::string target = getRecordPath(key);
+	char suffix[32];
+#ifdef _WIN32
+	sprintf(suffix, ".%lu", (unsigned long)GetCurrentProcessId());
+#else
+	sprintf(suffix, ".%lu", (unsigned long)getpid());
+#endif
+	std::string temporary = target + suffix;
+
+	FILE* f = fopen(temporary.c_str(), "wb");
+	if (!f) {
+		return;
+	}
+	bool ok = 1==fwrite(&record, sizeof(record), 1, f);
+	ok = 0==fclose(f) && ok;
+
+#ifdef _WIN32
+	// rename() does not replace existing file on Windows
+	if (ok) {
+		remove(target.c_str());
+	}
+#endif
+
+	if (!ok || 0!=rename(temporary.c_str(), target.c_str())) {
+		remove(temporary.c_str());
+	}
+}
+
+void PerformanceCache::insert(uint64_t key, const PerformanceSnapshot& snapshot) {
+	std::map<uint64_t, Entries::iterator>::iterator it = index.find(key);
+	if (it!=index.end()) {
+		it->second->second = snapshot;
+		entries.splice(entries.begin(), entries, it->second);
+		return;
+	}
+
+	entries.push_front(std::make_pair(key, snapshot));
+	index[key] = entries.begin();
+
+	while (entries.size()>capacity) {
+		index.erase(entries.back().first);
+		entries.pop_back();
+	}
+}
+
+bool PerformanceCache::find(uint64_t key, PerformanceSnapshot& snapshot) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::map<uint64_t, Entries::iterator>::iterator it = index.find(key);
+	if (it!=index.end()) {
+		// Most recently used goes first
+		entries.splice(entries.begin(), entries, it->second);
+		snapshot = it->second->second;
+		++hits;
+		return true;
+	}
+
+	if (readRecord(key, snapshot)) {
+		insert(key, snapshot);
+		++hits;
+		return true;
+	}
+
+	++misses;
+	return false;
+}
+
+void PerformanceCache::put(uint64_t key, const PerformanceSnapshot& snapshot) {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	insert(key, snapshot);
+	writeRecord(key, snapshot);
+}
+
+bool PerformanceCache::solve(thermo::input::ConfigFile* data, PerformanceSnapshot& snapshot) {
+	uint64_t key = 0;
+	bool cacheable = getPerformanceCacheKey(data, key);
+
+	if (cacheable && find(key, snapshot)) {
+		return true;
+	}
+
+	solvePerformance(NULL, data, snapshot);
+
+	if (cacheable) {
+		put(key, snapshot);
+	}
+
+	return false;
+}
+
+void PerformanceCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	entries.clear();
+	index.clear();
+}
+
+size_t PerformanceCache::getSize() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return entries.size();
+}
+
+size_t PerformanceCache::getHits() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return hits;
+}
+
+size_t PerformanceCache::getMisses() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return misses;
+}
@@ -0,0 +1,197 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_PERFORMANCE_CACHE_HPP_
+#define EXAMPLES_PERFORMANCE_CACHE_HPP_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "database.hpp"
+
+/**
+ * Default location of the disk cache of performance results.
+ */
+#define PERFORMANCE_CACHE_PATH "resources/cache"
+
+/**
+ * Version of the cache key and of the cache record format.
+ * Records written with any other version are ignored.
+ */
+#define PERFORMANCE_CACHE_VERSION 1
+
+/**
+ * Results of the theoretical performance problem which are used by the design tools.
+ *
+ * The solver objects (NozzleSectionConditions etc.) are created by the performance library only, so the cache
+ * keeps their values rather than the objects themselves. All values are in SI units.
+ */
+struct PerformanceSnapshot {
+	double r;					// O/F weight ratio
+
+	// Injector station (0)
+	double T_c;					// temperature, K
+	double p_c;					// pressure, Pa
+
+	// Nozzle throat
+	double T_t;					// temperature, K
+	double p_t;					// pressure, Pa
+	double k_t;					// isentropic exponent
+
+	// Nozzle exit
+	double Is_v;				// vacuum specific impulse, m/s
+	double Is;					// specific impulse at optimum expansion, m/s
+	double F;					// specific area, m2*s/kg
+	double p_e;					// pressure, Pa
+	double k_e;					// isentropic exponent
+	double M_e;					// Mach number
+	double rho_e;				// density, kg/m3
+	double w_e;					// velocity, m/s
+
+	/**
+	 * Returns specific impulse at given ambient pressure (Pa), assuming the flow is not separated.
+	 */
+	double getIs_H(double pa) const {
+		return Is_v - F*pa;
+	}
+};
+
+/**
+ * Record of the disk cache: one file "<key>.bin" per solved configuration.
+ */
+struct PerformanceCacheRecord {
+	char magic[8];				// "RPAPERF\0"
+	uint32_t version;			// PERFORMANCE_CACHE_VERSION
+	uint32_t size;				// sizeof(PerformanceSnapshot)
+	uint64_t key;
+	PerformanceSnapshot snapshot;
+	uint64_t checksum;			// FNV-1a checksum of all the fields above
+};
+
+/**
+ * Calculates the key of the configuration: the canonical checksum of all the inputs which affect the combustion
+ * and nozzle flow (propellant, mixture ratio, chamber pressure, nozzle exit conditions, species options),
+ * and of the version of the thermodynamics database.
+ *
+ * Values of freezing and nozzle inlet conditions can not be read back from the configuration object, so the
+ * configurations with any of them set can not be cached.
+ *
+ * @param key calculated key
+ * @return false if the configuration can not be cached, i.e. it depends on the settings which could not be
+ * included into the key
+ */
+extern bool getPerformanceCacheKey(thermo::input::ConfigFile* data, uint64_t& key);
+
+/**
+ * Fills the snapshot from the solved problem.
+ *
+ * @param exitSection nozzle exit section to use instead of performance->getExitSection(), or NULL
+ */
+extern void getPerformanceSnapshot(performance::TheoreticalPerformance* performance,
+		performance::equilibrium::NozzleSectionConditions* exitSection, PerformanceSnapshot& snapshot);
+
+/**
+ * Cache of the results of theoretical performance problem, keyed by getPerformanceCacheKey().
+ *
+ * Results are kept in memory (the least recently used are dropped as soon as the capacity is exceeded),
+ * and optionally on disk, so that they are reused by the subsequent runs. Thread-safe.
+ */
+class PerformanceCache {
+private:
+	typedef std::list<std::pair<uint64_t, PerformanceSnapshot> > Entries;
+
+	size_t capacity;
+	std::string path;
+
+	Entries entries;
+	std::map<uint64_t, Entries::iterator> index;
+
+	size_t hits;
+	size_t misses;
+
+	mutable std::mutex mutex;
+
+	void insert(uint64_t key, const PerformanceSnapshot& snapshot);
+
+	std::string getRecordPath(uint64_t key) const;
+	bool readRecord(uint64_t key, PerformanceSnapshot& snapshot) const;
+	void writeRecord(uint64_t key, const PerformanceSnapshot& snapshot) const;
+
+public:
+	/**
+	 * @param capacity maximum number of results kept in memory
+	 * @param path directory of the disk cache; created if does not exist; NULL or empty to keep results in memory only
+	 */
+	PerformanceCache(size_t capacity = 1024, const char* path = PERFORMANCE_CACHE_PATH);
+
+	/**
+	 * Looks up the results in memory, then on disk.
+	 *
+	 * @return false if the results are not found
+	 */
+	bool find(uint64_t key, PerformanceSnapshot& snapshot);
+
+	/**
+	 * Stores the results in memory and on disk.
+	 */
+	void put(uint64_t key, const PerformanceSnapshot& snapshot);
+
+	/**
+	 * Returns the results for given configuration, solving the problem only if they are not cached.
+	 * Configurations which can not be cached (see getPerformanceCacheKey()) are always solved.
+	 *
+	 * Throws an exception if the problem could not be solved.
+	 *
+	 * @return true if the results have been taken from the cache
+	 */
+	bool solve(thermo::input::ConfigFile* data, PerformanceSnapshot& snapshot);
+
+	/**
+	 * Removes all results from memory (but not from disk).
+	 */
+	void clear();
+
+	size_t getSize() const;
+
+	size_t getHits() const;
+
+	size_t getMisses() const;
+};
+
+/**
+ * Solves the theoretical performance problem of given configuration and fills the snapshot.
+ * If the cache is specified, results are taken from the cache or stored there (see PerformanceCache::solve()).
+ *
+ * Throws an exception if the problem could not be solved.
+ *
+ * @param cache cache of results, or NULL
+ * @return true if the results have been taken from the cache
+ */
+extern bool solvePerformance(PerformanceCache* cache, thermo::input::ConfigFile* data, PerformanceSnapshot& snapshot);
+
+#endif /* EXAMPLES_PERFORMANCE_CACHE_HPP_ */
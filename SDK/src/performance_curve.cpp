@@ -0,0 +1,274 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "simd.hpp"
+#include "performance_curve.hpp"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Number of samples evaluated at once; coefficients of the block are kept on the stack.
+ */
+static const size_t PERFORMANCE_CURVE_BLOCK = 256;
+
+/**
+ * Scalar kernel for samples [begin, end): Is = a - f*pa, thrust = Is*m.
+ */
+static void evaluateKernelScalar(const double* pa, const double* a, const double* f, const double* m,
+		size_t begin, size_t end, double* Is, double* thrust) {
+	for (size_t i=begin; i<end; ++i) {
+		double v = a[i] - f[i]*pa[i];
+		Is[i] = v;
+		thrust[i] = v*m[i];
+	}
+}
+
+#ifdef SIMD_SSE2
+static void evaluateKernelSse2(const double* pa, const double* a, const double* f, const double* m,
+		size_t n, double* Is, double* thrust) {
+	size_t i = 0;
+	for (; i+2<=n; i+=2) {
+		__m128d v = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_mul_pd(_mm_loadu_pd(f + i), _mm_loadu_pd(pa + i)));
+		_mm_storeu_pd(Is + i, v);
+		_mm_storeu_pd(thrust + i, _mm_mul_pd(v, _mm_loadu_pd(m + i)));
+	}
+	evaluateKernelScalar(pa, a, f, m, i, n, Is, thrust);
+}
+#endif
+
+#ifdef SIMD_X86
+SIMD_TARGET_AVX2
+static void evaluateKernelAvx2(const double* pa, const double* a, const double* f, const double* m,
+		size_t n, double* Is, double* thrust) {
+	size_t i = 0;
+	for (; i+4<=n; i+=4) {
+		__m256d v = _mm256_fnmadd_pd(_mm256_loadu_pd(f + i), _mm256_loadu_pd(pa + i), _mm256_loadu_pd(a + i));
+		_mm256_storeu_pd(Is + i, v);
+		_mm256_storeu_pd(thrust + i, _mm256_mul_pd(v, _mm256_loadu_pd(m + i)));
+	}
+	evaluateKernelScalar(pa, a, f, m, i, n, Is, thrust);
+}
+#endif
+
+//*****************************************************************************
+
+void PerformanceCurve::getLevel(performance::TheoreticalPerformance* performance, double phi, double mdot, double pa_max, Level& level) {
+	if (phi<=0) {
+		performance::efficiency::CorrectionFactors correctionFactors(performance);
+		phi = correctionFactors.getOverallEfficiency();
+	}
+	level.phi = phi;
+	level.mdot = mdot;
+
+	if (pa_max>0) {
+		FlowSeparationTable table(performance);
+		table.build(pa_max);
+		level.separation = table.getData();
+	} else {
+		// Nozzle without flow separation
+		performance::equilibrium::NozzleSectionConditions* exitSection = performance->getExitSection();
+		level.separation = FlowSeparationData();
+		level.separation.Is_v_e = exitSection->getIs_v();
+		level.separation.F_e = exitSection->getF();
+		level.separation.pa_crit = HUGE_VAL;
+	}
+}
+
+PerformanceCurve::PerformanceCurve(performance::TheoreticalPerformance* performance, double phi, double mdot, double pa_max) :
+	levels(1) {
+
+	levels[0].throttle = 1.0;
+	getLevel(performance, phi, mdot, pa_max, levels[0]);
+}
+
+PerformanceCurve::PerformanceCurve(performance::ThrottlingPerformance* throttlingPerformance, const std::vector<double>& throttles,
+		double currentThrottle, double phi, double nominalMdot, double pa_max) {
+
+	std::vector<double> values(throttles);
+	std::sort(values.begin(), values.end());
+	values.erase(std::unique(values.begin(), values.end()), values.end());
+
+	levels.resize(values.size());
+	for (size_t i=0; i<values.size(); ++i) {
+		throttlingPerformance->throttle(values[i]);
+
+		levels[i].throttle = values[i];
+		getLevel(throttlingPerformance, phi, nominalMdot*values[i], pa_max, levels[i]);
+	}
+
+	// The caller's problem is left in the state it has been passed in
+	if (!values.empty() && values.back()!=currentThrottle) {
+		throttlingPerformance->throttle(currentThrottle);
+	}
+}
+
+void PerformanceCurve::findLevel(double throttle, size_t& k, double& t) const {
+	k = 0;
+	t = 0;
+	if (levels.size()<2 || throttle<=levels.front().throttle) {
+		return;
+	}
+	if (throttle>=levels.back().throttle) {
+		k = levels.size() - 2;
+		t = 1;
+		return;
+	}
+
+	size_t hi = levels.size() - 1;
+	while (hi-k>1) {
+		size_t mid = (k + hi)/2;
+		if (levels[mid].throttle<=throttle) {
+			k = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	t = (throttle - levels[k].throttle)/(levels[hi].throttle - levels[k].throttle);
+}
+
+void PerformanceCurve::getCoefficients(double throttle, double& a, double& f, double& m, double& crit) const {
+	size_t k;
+	double t;
+	findLevel(throttle, k, t);
+
+	const Level& l0 = levels[k];
+	a = l0.separation.Is_v_e*l0.phi;
+	f = l0.separation.F_e;
+	m = l0.mdot;
+	crit = l0.separation.pa_crit;
+
+	if (t>0) {
+		const Level& l1 = levels[k+1];
+		a += t*(l1.separation.Is_v_e*l1.phi - a);
+		f += t*(l1.separation.F_e - f);
+		m += t*(l1.mdot - m);
+		crit = std::min(crit, l1.separation.pa_crit);
+	}
+}
+
+double PerformanceCurve::getIs_H(double pa, double throttle) const {
+	size_t k;
+	double t;
+	findLevel(throttle, k, t);
+
+	const Level& l0 = levels[k];
+	double Is = l0.separation.getIs_H(pa, l0.phi);
+	if (t>0) {
+		const Level& l1 = levels[k+1];
+		Is += t*(l1.separation.getIs_H(pa, l1.phi) - Is);
+	}
+	return Is;
+}
+
+double PerformanceCurve::getThrust(double pa, double throttle) const {
+	size_t k;
+	double t;
+	findLevel(throttle, k, t);
+
+	double mdot = levels[k].mdot;
+	if (t>0) {
+		mdot += t*(levels[k+1].mdot - mdot);
+	}
+	return getIs_H(pa, throttle)*mdot;
+}
+
+void PerformanceCurve::evaluate(const double* pa, const double* throttle, size_t n, double* Is, double* thrust, int level) const {
+	if (levels.empty()) {
+		return;
+	}
+
+	double a[PERFORMANCE_CURVE_BLOCK];				// Is_v*phi
+	double f[PERFORMANCE_CURVE_BLOCK];				// F
+	double m[PERFORMANCE_CURVE_BLOCK];				// mdot
+	double crit[PERFORMANCE_CURVE_BLOCK];			// critical ambient pressure
+	double buffer[PERFORMANCE_CURVE_BLOCK];			// thrust, if not requested
+
+	// Without throttle values all the samples are at throttle value 1, so coefficients are filled once
+	bool constant = NULL==throttle || 1==levels.size();
+	double constantThrottle = 1==levels.size() ? levels[0].throttle : 1.0;
+	if (constant) {
+		getCoefficients(constantThrottle, a[0], f[0], m[0], crit[0]);
+		std::fill(a + 1, a + PERFORMANCE_CURVE_BLOCK, a[0]);
+		std::fill(f + 1, f + PERFORMANCE_CURVE_BLOCK, f[0]);
+		std::fill(m + 1, m + PERFORMANCE_CURVE_BLOCK, m[0]);
+		std::fill(crit + 1, crit + PERFORMANCE_CURVE_BLOCK, crit[0]);
+	}
+
+	for (size_t first=0; first<n; first+=PERFORMANCE_CURVE_BLOCK) {
+		size_t size = std::min(PERFORMANCE_CURVE_BLOCK, n - first);
+		const double* blockPa = pa + first;
+		double* blockIs = Is + first;
+		double* blockThrust = thrust ? thrust + first : buffer;
+
+		if (!constant) {
+			for (size_t i=0; i<size; ++i) {
+				getCoefficients(throttle[first + i], a[i], f[i], m[i], crit[i]);
+			}
+		}
+
+		switch (level) {
+#ifdef SIMD_X86
+		case SIMD_LEVEL_AVX2:
+			evaluateKernelAvx2(blockPa, a, f, m, size, blockIs, blockThrust);
+			break;
+#endif
+#ifdef SIMD_SSE2
+		case SIMD_LEVEL_SSE2:
+			evaluateKernelSse2(blockPa, a, f, m, size, blockIs, blockThrust);
+			break;
+#endif
+		default:
+			evaluateKernelScalar(blockPa, a, f, m, 0, size, blockIs, blockThrust);
+			break;
+		}
+
+		// Samples with flow separation
+		for (size_t i=0; i<size; ++i) {
+			if (blockPa[i]>crit[i]) {
+				blockIs[i] = getIs_H(blockPa[i], constant ? constantThrottle : throttle[first + i]);
+				blockThrust[i] = blockIs[i]*m[i];
+			}
+		}
+	}
+}
+
+void PerformanceCurve::evaluate(const double* pa, size_t n, double* Is, double* thrust) const {
+	evaluate(pa, NULL, n, Is, thrust, getSimdLevel());
+}
+
+void PerformanceCurve::evaluate(const double* pa, const double* throttle, size_t n, double* Is, double* thrust) const {
+	evaluate(pa, throttle, n, Is, thrust, getSimdLevel());
+}
+
+void PerformanceCurve::evaluateScalar(const double* pa, const double* throttle, size_t n, double* Is, double* thrust) const {
+	evaluate(pa, throttle, n, Is, thrust, SIMD_LEVEL_NONE);
+}
@@ -0,0 +1,142 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_PERFORMANCE_CURVE_HPP_
+#define EXAMPLES_PERFORMANCE_CURVE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/dll/Export.hpp"
+
+#include "flow_separation.hpp"
+
+/**
+ * Delivered performance of the solved engine as a function of ambient pressure and throttle value.
+ *
+ * For the attached nozzle flow the delivered specific impulse is linear in ambient pressure: Is = Is_v*phi - F*pa,
+ * so the curve keeps only the coefficients of the nozzle exit for each throttle level, and the separation data
+ * (see FlowSeparationData) for the pressures above the critical one. The object is plain data: it can be copied,
+ * and used after the solver is deleted.
+ *
+ * Samples are evaluated in blocks: coefficients are looked up per sample, the linear part is calculated
+ * by the vectorized kernel (AVX2 or SSE2, depending on the CPU), and only the samples with flow separation
+ * are recalculated by the scalar code.
+ */
+class PerformanceCurve {
+public:
+	struct Level {
+		double throttle;					// throttle value
+		double mdot;						// mass flow rate, kg/s
+		double phi;							// performance correction factor
+		FlowSeparationData separation;		// nozzle exit coefficients, critical pressure and separation table
+	};
+
+private:
+	std::vector<Level> levels;				// in increasing order of throttle value
+
+	/**
+	 * Extracts the level from the solved problem.
+	 */
+	static void getLevel(performance::TheoreticalPerformance* performance, double phi, double mdot, double pa_max, Level& level);
+
+	/**
+	 * Finds the interval of levels and the interpolation weight of the upper level for given throttle value.
+	 * Values out of the range of levels are clamped.
+	 */
+	void findLevel(double throttle, size_t& k, double& t) const;
+
+	/**
+	 * Interpolates the coefficients of the linear part for given throttle value: a = Is_v*phi, f = F, mass flow rate m,
+	 * and the critical ambient pressure crit.
+	 */
+	void getCoefficients(double throttle, double& a, double& f, double& m, double& crit) const;
+
+	void evaluate(const double* pa, const double* throttle, size_t n, double* Is, double* thrust, int level) const;
+
+public:
+	PerformanceCurve() {
+	}
+
+	/**
+	 * Extracts the curve of solved problem.
+	 *
+	 * @param performance solved problem (TheoreticalPerformance or ThrottlingPerformance)
+	 * @param phi performance correction factor; if phi<=0, the factor is calculated by CorrectionFactors
+	 * @param mdot mass flow rate, kg/s; used for thrust only
+	 * @param pa_max maximum ambient pressure of the flow separation table, Pa; if 0, the flow separation is not considered
+	 */
+	explicit PerformanceCurve(performance::TheoreticalPerformance* performance, double phi = 1.0, double mdot = 0, double pa_max = CONST_ATM);
+
+	/**
+	 * Extracts the curve at several throttle values. Samples between the levels are interpolated linearly.
+	 *
+	 * @param throttlingPerformance solved problem, throttled in turn to each of throttle values, and then back
+	 * to the current one
+	 * @param throttles throttle values
+	 * @param currentThrottle throttle value the problem is solved for
+	 * @param phi performance correction factor; if phi<=0, the factor is calculated by CorrectionFactors at each level
+	 * @param nominalMdot mass flow rate at throttle value 1, kg/s; used for thrust only
+	 * @param pa_max maximum ambient pressure of the flow separation table, Pa; if 0, the flow separation is not considered
+	 */
+	PerformanceCurve(performance::ThrottlingPerformance* throttlingPerformance, const std::vector<double>& throttles,
+			double currentThrottle, double phi = 1.0, double nominalMdot = 0, double pa_max = CONST_ATM);
+
+	size_t getLevelsNo() const {
+		return levels.size();
+	}
+
+	const Level& getLevel(size_t i) const {
+		return levels[i];
+	}
+
+	/**
+	 * Returns delivered specific impulse (m/s) at given ambient pressure (Pa) and throttle value.
+	 */
+	double getIs_H(double pa, double throttle = 1.0) const;
+
+	/**
+	 * Returns thrust (N) at given ambient pressure (Pa) and throttle value.
+	 */
+	double getThrust(double pa, double throttle = 1.0) const;
+
+	/**
+	 * Calculates delivered specific impulse (m/s) and thrust (N) at n ambient pressures (Pa) and throttle value 1.
+	 *
+	 * @param thrust array of n values, or NULL
+	 */
+	void evaluate(const double* pa, size_t n, double* Is, double* thrust = NULL) const;
+
+	/**
+	 * Calculates delivered specific impulse (m/s) and thrust (N) at n pairs of ambient pressure (Pa) and throttle value.
+	 *
+	 * @param thrust array of n values, or NULL
+	 */
+	void evaluate(const double* pa, const double* throttle, size_t n, double* Is, double* thrust = NULL) const;
+
+	/**
+	 * Same as evaluate(), using the scalar kernel only. Used for verification of the vectorized kernels.
+	 */
+	void evaluateScalar(const double* pa, const double* throttle, size_t n, double* Is, double* thrust = NULL) const;
+};
+
+#endif /* EXAMPLES_PERFORMANCE_CURVE_HPP_ */
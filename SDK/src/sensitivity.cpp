@@ -0,0 +1,247 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "performance_cache.hpp"
+#include "sensitivity.hpp"
+#include "threadpool.hpp"
+
+SensitivityAnalysis::SensitivityAnalysis(thermo::input::ConfigFile* data, int threads) :
+	data(data),
+	threads(threads),
+	central(true),
+	reuseChamber(true),
+	values(SWEEP_VALUES_NO, std::numeric_limits<double>::quiet_NaN()),
+	solvesNo(0) {
+}
+
+void SensitivityAnalysis::addInput(SweepAxisType type, double step) {
+	Input input;
+	input.type = type;
+	input.step = fabs(step)>0 ? fabs(step) : 1e-3;
+	input.value = 0;
+	input.dx = 0;
+	inputs.push_back(input);
+}
+
+/**
+ * Returns the temperatures (K) of the components changed by the temperature input; empty for other inputs.
+ */
+static void getComponentTemperatures(thermo::input::ConfigFile* config, SweepAxisType type, std::vector<double>& T) {
+	T.clear();
+	thermo::input::Propellant& propellant = config->getPropellant();
+	if (SWEEP_AXIS_OXIDIZER_TEMPERATURE==type) {
+		for (int i=0; i<propellant.getOxidizerListSize(); ++i) {
+			T.push_back(propellant.getOxidizer(i).getT(thermo::input::Temperature::K));
+		}
+	} else if (SWEEP_AXIS_FUEL_TEMPERATURE==type) {
+		for (int i=0; i<propellant.getFuelListSize(); ++i) {
+			T.push_back(propellant.getFuel(i).getT(thermo::input::Temperature::K));
+		}
+	}
+}
+
+static void setComponentTemperatures(thermo::input::ConfigFile* config, SweepAxisType type, const std::vector<double>& T) {
+	thermo::input::Propellant& propellant = config->getPropellant();
+	for (size_t i=0; i<T.size(); ++i) {
+		if (SWEEP_AXIS_OXIDIZER_TEMPERATURE==type) {
+			propellant.getOxidizer((int)i).setT(T[i], thermo::input::Temperature::K);
+		} else {
+			propellant.getFuel((int)i).setT(T[i], thermo::input::Temperature::K);
+		}
+	}
+}
+
+void SensitivityAnalysis::solve(thermo::input::ConfigFile* config, int input, double offset, double* results, char* solved) const {
+	size_t slot = input<0 ? 0 : (offset>0 ? 1 + 2*input : 2 + 2*input);
+
+	// Temperatures of the components are restored exactly, rather than shifted back
+	std::vector<double> temperatures;
+	if (input>=0) {
+		getComponentTemperatures(config, inputs[input].type, temperatures);
+		setSweepAxisValue(config, inputs[input].type, inputs[input].value + offset);
+	}
+
+	bool checkForFreezing = config->getNozzleFlowOptions().isFreezingConditionsSet() && config->getNozzleFlowOptions().getFreezingConditions().isCalculate();
+
+	performance::TheoreticalPerformance* performance = NULL;
+	try {
+		performance = new performance::TheoreticalPerformance(config, false);
+		performance->solve();
+
+		PerformanceSnapshot snapshot;
+		getPerformanceSnapshot(performance, NULL, snapshot);
+		setSweepValues(snapshot, results + slot*SWEEP_VALUES_NO);
+		solved[slot] = 1;
+
+		// Chamber reuse: perturbed area ratios are the nozzle sections of the base solution
+		for (size_t i=0; input<0 && reuseChamber && i<inputs.size(); ++i) {
+			if (SWEEP_AXIS_AREA_RATIO!=inputs[i].type) {
+				continue;
+			}
+			for (int side=0; side<2; ++side) {
+				size_t s = 1 + 2*i + side;
+				double Fr = inputs[i].value + (0==side ? inputs[i].dx : -inputs[i].dx);
+
+				performance::equilibrium::NozzleSectionConditions* section = NULL;
+				try {
+					section = performance->solveNozzleSection(Fr, performance::frozen::NozzleSectionConditions::FR, checkForFreezing, true, 0, false);
+					getPerformanceSnapshot(performance, section, snapshot);
+					setSweepValues(snapshot, results + s*SWEEP_VALUES_NO);
+					solved[s] = 1;
+				} catch (const std::exception& ex) {
+					util::Log::warnf("SENSITIVITY", "Could not solve area ratio %f: %s%s", Fr, ex.what(), CR);
+				}
+				delete section;
+			}
+		}
+
+	} catch (const std::exception& ex) {
+		if (input<0) {
+			util::Log::warnf("SENSITIVITY", "Could not solve base point: %s%s", ex.what(), CR);
+		} else {
+			util::Log::warnf("SENSITIVITY", "Could not solve point with input %d perturbed by %e: %s%s", input, offset, ex.what(), CR);
+		}
+	}
+
+	delete performance;
+
+	// Next task of the thread starts from the base point
+	if (input>=0) {
+		setSweepAxisValue(config, inputs[input].type, inputs[input].value);
+		setComponentTemperatures(config, inputs[input].type, temperatures);
+	}
+}
+
+/**
+ * Task of the worker thread: solves one point (base or perturbed) using the configuration of the thread.
+ */
+struct SensitivityTask {
+	const SensitivityAnalysis* analysis;
+	WorkerConfigs* configs;
+	std::vector<int> inputs;			// perturbed input of each task, -1 for the base point
+	std::vector<double> offsets;
+	double* results;
+	char* solved;
+
+	void operator()(size_t task, int worker) {
+		analysis->solve(configs->get(worker), inputs[task], offsets[task], results, solved);
+	}
+};
+
+bool SensitivityAnalysis::run() {
+	size_t n = inputs.size();
+
+	values.assign(SWEEP_VALUES_NO, std::numeric_limits<double>::quiet_NaN());
+	derivatives.assign(n*SWEEP_VALUES_NO, std::numeric_limits<double>::quiet_NaN());
+	solvesNo = 0;
+
+	for (size_t i=0; i<n; ++i) {
+		if (!getSweepAxisValue(data, inputs[i].type, inputs[i].value)) {
+			util::Log::errorf("SENSITIVITY", "Input %u is not specified in the configuration%s", (unsigned int)i, CR);
+			return false;
+		}
+		inputs[i].dx = inputs[i].step*(0!=inputs[i].value ? fabs(inputs[i].value) : 1.0);
+	}
+
+	// Results of the base point (slot 0), and of the points with the input i increased (slot 1+2*i) and decreased (slot 2+2*i)
+	std::vector<double> results((1 + 2*n)*SWEEP_VALUES_NO, std::numeric_limits<double>::quiet_NaN());
+	std::vector<char> solved(1 + 2*n, 0);
+
+	ThreadPool pool(threads);
+
+	WorkerConfigs configs(data);
+	configs.prepare(pool.getThreads());
+
+	SensitivityTask task;
+	task.analysis = this;
+	task.configs = &configs;
+	task.results = &results[0];
+	task.solved = &solved[0];
+
+	task.inputs.push_back(-1);
+	task.offsets.push_back(0);
+	for (size_t i=0; i<n; ++i) {
+		if (reuseChamber && SWEEP_AXIS_AREA_RATIO==inputs[i].type) {
+			continue;
+		}
+		task.inputs.push_back((int)i);
+		task.offsets.push_back(inputs[i].dx);
+		if (central) {
+			task.inputs.push_back((int)i);
+			task.offsets.push_back(-inputs[i].dx);
+		}
+	}
+
+	pool.run(task.inputs.size(), task);
+	solvesNo = task.inputs.size();
+
+	if (!solved[0]) {
+		return false;
+	}
+
+	const double* base = &results[0];
+	values.assign(base, base + SWEEP_VALUES_NO);
+
+	for (size_t i=0; i<n; ++i) {
+		bool plus = 0!=solved[1 + 2*i];
+		bool minus = 0!=solved[2 + 2*i];
+		const double* rp = &results[(1 + 2*i)*SWEEP_VALUES_NO];
+		const double* rm = &results[(2 + 2*i)*SWEEP_VALUES_NO];
+		double dx = inputs[i].dx;
+
+		for (int v=0; v<SWEEP_VALUES_NO; ++v) {
+			double d = std::numeric_limits<double>::quiet_NaN();
+			if (plus && minus) {
+				d = (rp[v] - rm[v])/(2*dx);
+			} else if (plus) {
+				d = (rp[v] - base[v])/dx;
+			} else if (minus) {
+				d = (base[v] - rm[v])/dx;
+			}
+			derivatives[i*SWEEP_VALUES_NO + v] = d;
+		}
+	}
+
+	return true;
+}
+
+void SensitivityAnalysis::getJacobian(const std::vector<SweepValue>& outputs, std::vector<double>& jacobian) const {
+	size_t n = inputs.size();
+	jacobian.assign(outputs.size()*n, std::numeric_limits<double>::quiet_NaN());
+	if (derivatives.size()!=n*SWEEP_VALUES_NO) {
+		return;
+	}
+	for (size_t o=0; o<outputs.size(); ++o) {
+		for (size_t i=0; i<n; ++i) {
+			jacobian[o*n + i] = get(outputs[o], i);
+		}
+	}
+}
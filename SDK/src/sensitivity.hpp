@@ -0,0 +1,149 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_SENSITIVITY_HPP_
+#define EXAMPLES_SENSITIVITY_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+
+#include "sweep.hpp"
+
+/**
+ * Derivatives of the theoretical performance (see SweepValue) by the parameters of the configuration
+ * (see SweepAxisType), obtained by finite differences.
+ *
+ * The base point and all the perturbed points are solved concurrently on the thread pool, each thread with its own
+ * copy of the configuration. With chamber reuse enabled (default), the derivatives by the nozzle area ratio do not
+ * require any additional solution of the chamber: the perturbed exit sections are obtained from the base solution.
+ */
+class SensitivityAnalysis {
+private:
+	struct Input {
+		SweepAxisType type;
+		double step;				// relative step
+		double value;				// value at the base point
+		double dx;					// absolute step
+	};
+
+	thermo::input::ConfigFile* data;
+	int threads;
+
+	std::vector<Input> inputs;
+	bool central;
+	bool reuseChamber;
+
+	std::vector<double> values;			// SWEEP_VALUES_NO results at the base point
+	std::vector<double> derivatives;	// SWEEP_VALUES_NO derivatives by each input
+	size_t solvesNo;
+
+	friend struct SensitivityTask;
+
+	/**
+	 * Solves the point with the input perturbed by the offset (the base point if input<0). The base point
+	 * solves the perturbed area ratios as well if chamber reuse is enabled.
+	 *
+	 * @param results SWEEP_VALUES_NO results for the base point and each perturbation (see run())
+	 */
+	void solve(thermo::input::ConfigFile* config, int input, double offset, double* results, char* solved) const;
+
+public:
+	/**
+	 * @param data configuration of the engine (the base point); must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	SensitivityAnalysis(thermo::input::ConfigFile* data, int threads = 0);
+
+	/**
+	 * Adds the input; its value at the base point is taken from the configuration (see getSweepAxisValue()).
+	 *
+	 * @param step step relative to the value of the input
+	 */
+	void addInput(SweepAxisType type, double step = 1e-3);
+
+	size_t getInputsNo() const {
+		return inputs.size();
+	}
+
+	SweepAxisType getInputType(size_t input) const {
+		return inputs[input].type;
+	}
+
+	/**
+	 * Returns the value of the input at the base point (valid after run()).
+	 */
+	double getInputValue(size_t input) const {
+		return inputs[input].value;
+	}
+
+	/**
+	 * Specifies whether the central differences are used (default), or the forward ones, which need half
+	 * the number of solutions. Derivatives by the area ratio with chamber reuse are always central.
+	 */
+	void setCentral(bool central) {
+		this->central = central;
+	}
+
+	void setReuseChamber(bool reuseChamber) {
+		this->reuseChamber = reuseChamber;
+	}
+
+	/**
+	 * Solves the base point and the perturbed ones, and calculates the derivatives.
+	 *
+	 * @return false if any input is not specified in the configuration, or the base point could not be solved
+	 */
+	bool run();
+
+	/**
+	 * Returns the result at the base point.
+	 */
+	double getValue(SweepValue value) const {
+		return values[value];
+	}
+
+	/**
+	 * Returns the derivative of the result by the input, in SI units (e.g. m/s per Pa); NaN if the perturbed
+	 * points could not be solved.
+	 */
+	double get(SweepValue value, size_t input) const {
+		return derivatives[input*SWEEP_VALUES_NO + value];
+	}
+
+	/**
+	 * Fills the Jacobian matrix of given results by all the inputs.
+	 *
+	 * @param jacobian matrix outputs.size() x getInputsNo(), row-major
+	 */
+	void getJacobian(const std::vector<SweepValue>& outputs, std::vector<double>& jacobian) const;
+
+	/**
+	 * Returns the number of the chamber solutions of the last run().
+	 */
+	size_t getSolvesNo() const {
+		return solvesNo;
+	}
+};
+
+#endif /* EXAMPLES_SENSITIVITY_HPP_ */
@@ -0,0 +1,88 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_SIMD_HPP_
+#define EXAMPLES_SIMD_HPP_
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SIMD_X86 1
+#define SIMD_TARGET_AVX2
+#include <intrin.h>
+#endif
+
+#if defined(SIMD_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2))
+#define SIMD_SSE2 1
+#endif
+
+/**
+ * Instruction set used by the vectorized kernels.
+ */
+enum SimdLevel {
+	SIMD_LEVEL_NONE = 0,
+	SIMD_LEVEL_SSE2 = 1,
+	SIMD_LEVEL_AVX2 = 2			// AVX2 and FMA
+};
+
+/**
+ * Returns the best instruction set supported both by the build and by the CPU the code is running on.
+ */
+inline SimdLevel detectSimdLevel() {
+#if defined(SIMD_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		return SIMD_LEVEL_AVX2;
+	}
+#elif defined(SIMD_X86) && defined(_MSC_VER) && _MSC_VER>=1600
+	int info[4];
+	__cpuid(info, 1);
+	bool fma = 0!=(info[2] & (1<<12));
+	bool osxsave = 0!=(info[2] & (1<<27));
+	if (fma && osxsave && 6==(_xgetbv(0) & 6)) {
+		__cpuid(info, 0);
+		if (info[0]>=7) {
+			__cpuidex(info, 7, 0);
+			if (0!=(info[1] & (1<<5))) {
+				return SIMD_LEVEL_AVX2;
+			}
+		}
+	}
+#endif
+
+#ifdef SIMD_SSE2
+	return SIMD_LEVEL_SSE2;
+#else
+	return SIMD_LEVEL_NONE;
+#endif
+}
+
+/**
+ * Returns detectSimdLevel(), evaluated once.
+ */
+inline SimdLevel getSimdLevel() {
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+}
+
+#endif /* EXAMPLES_SIMD_HPP_ */
@@ -0,0 +1,175 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "station_table.hpp"
+
+NozzleStationTable::NozzleStationTable(performance::TheoreticalPerformance* performance, bool equilibrium) :
+	performance(performance),
+	checkForFreezing(false) {
+
+	if (!equilibrium) {
+		thermo::input::NozzleFlowOptions& flowOptions = performance->getData()->getNozzleFlowOptions();
+		checkForFreezing = flowOptions.isFreezingConditionsSet() && flowOptions.getFreezingConditions().isCalculate();
+	}
+
+	p_c = performance->getChamber()->getReaction(0)->getP();
+}
+
+void NozzleStationTable::solveStation(double Fr, NozzleStation& station) const {
+	performance::equilibrium::NozzleSectionConditions* section = solve(Fr, performance::frozen::NozzleSectionConditions::FR);
+
+	station.Fr = Fr;
+	station.p = section->getP();
+	station.T = section->getT();
+	station.M = section->getMach();
+	station.rho = section->getRho();
+	station.w = section->getW();
+	station.k = section->getK();
+	station.Is_v = section->getIs_v();
+	station.Is = section->getIs();
+	station.F = section->getF();
+
+	delete section;
+}
+
+void NozzleStationTable::build(double Fr_max, int n, double Fr_min) {
+	stations.clear();
+
+	double u1 = getU(std::max(Fr_min, 1.0));
+	double u2 = getU(Fr_max);
+	n = std::max(n, 2);
+
+	for (int i=0; i<n; ++i) {
+		double t = u1 + (u2 - u1)*(double)i/(double)(n - 1);
+		NozzleStation station;
+		try {
+			solveStation(exp(t*t), station);
+		} catch (const std::exception& ex) {
+			util::Log::warnf("STATIONS", "Could not solve nozzle section A/At=%f: %s%s", exp(t*t), ex.what(), CR);
+			continue;
+		}
+		stations.push_back(station);
+	}
+
+	std::vector<double> x(stations.size()), lnpp(stations.size());
+	std::vector<std::vector<double> > y(VALUES_NO, std::vector<double>(stations.size()));
+	for (size_t i=0; i<stations.size(); ++i) {
+		const NozzleStation& s = stations[i];
+		x[i] = getU(s.Fr);
+		lnpp[i] = log(p_c/s.p);
+
+		y[VALUE_LN_P][i] = log(s.p);
+		y[VALUE_T][i] = s.T;
+		y[VALUE_M][i] = s.M;
+		y[VALUE_LN_RHO][i] = log(s.rho);
+		y[VALUE_W][i] = s.w;
+		y[VALUE_K][i] = s.k;
+		y[VALUE_IS_V][i] = s.Is_v;
+		y[VALUE_IS][i] = s.Is;
+		y[VALUE_LN_F][i] = log(s.F);
+	}
+
+	for (int v=0; v<VALUES_NO; ++v) {
+		values[v].build(x, y[v]);
+	}
+	u.build(lnpp, x);
+
+	util::Log::printf("STATIONS", "Nozzle station table: %u stations, A/At from %f to %f%s",
+		(unsigned int)stations.size(), stations.empty() ? 0.0 : stations.front().Fr, stations.empty() ? 0.0 : stations.back().Fr, CR);
+}
+
+void NozzleStationTable::interpolate(double t, NozzleStation& station) const {
+	station.Fr = exp(t*t);
+	station.p = exp(values[VALUE_LN_P].evaluate(t));
+	station.T = values[VALUE_T].evaluate(t);
+	station.M = values[VALUE_M].evaluate(t);
+	station.rho = exp(values[VALUE_LN_RHO].evaluate(t));
+	station.w = values[VALUE_W].evaluate(t);
+	station.k = values[VALUE_K].evaluate(t);
+	station.Is_v = values[VALUE_IS_V].evaluate(t);
+	station.Is = values[VALUE_IS].evaluate(t);
+	station.F = exp(values[VALUE_LN_F].evaluate(t));
+}
+
+bool NozzleStationTable::get(double condition, performance::frozen::NozzleSectionConditions::CONDITION_TYPE type, NozzleStation& station) const {
+	if (stations.size()<2) {
+		return false;
+	}
+
+	double t = 0;
+	switch (type) {
+	case performance::frozen::NozzleSectionConditions::FR:
+		if (condition<stations.front().Fr || condition>stations.back().Fr) {
+			return false;
+		}
+		t = getU(condition);
+		break;
+	case performance::frozen::NozzleSectionConditions::pp:
+	case performance::frozen::NozzleSectionConditions::P: {
+		double p = performance::frozen::NozzleSectionConditions::pp==type ? p_c/condition : condition;
+		if (p>stations.front().p || p<stations.back().p) {
+			return false;
+		}
+		t = u.evaluate(log(p_c/p));
+		break;
+	}
+	default:
+		return false;
+	}
+
+	interpolate(t, station);
+	return true;
+}
+
+performance::equilibrium::NozzleSectionConditions* NozzleStationTable::solve(double condition, performance::frozen::NozzleSectionConditions::CONDITION_TYPE type, double pa) const {
+	return performance->solveNozzleSection(condition, type, checkForFreezing, true, pa, false);
+}
+
+double NozzleStationTable::check(int n) const {
+	double error = 0;
+	if (stations.size()<2 || n<=0) {
+		return error;
+	}
+
+	for (int i=0; i<n; ++i) {
+		// Midpoint of the interval
+		size_t j = std::min(stations.size() - 2, (size_t)((double)(stations.size() - 1)*((double)i + 0.5)/(double)n));
+		double t = 0.5*(getU(stations[j].Fr) + getU(stations[j+1].Fr));
+
+		NozzleStation exact, interpolated;
+		solveStation(exp(t*t), exact);
+		interpolate(t, interpolated);
+
+		error = std::max(error, fabs(interpolated.Is_v - exact.Is_v)/exact.Is_v);
+		error = std::max(error, fabs(interpolated.p - exact.p)/exact.p);
+	}
+
+	return error;
+}
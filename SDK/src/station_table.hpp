@@ -0,0 +1,144 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_STATION_TABLE_HPP_
+#define EXAMPLES_STATION_TABLE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/dll/Export.hpp"
+
+#include "interpolation.hpp"
+
+/**
+ * Flow parameters at one section of the supersonic part of the nozzle. All values are in SI units.
+ */
+struct NozzleStation {
+	double Fr;					// area ratio A/At
+	double p;					// pressure, Pa
+	double T;					// temperature, K
+	double M;					// Mach number
+	double rho;					// density, kg/m3
+	double w;					// velocity, m/s
+	double k;					// isentropic exponent
+	double Is_v;				// vacuum specific impulse, m/s
+	double Is;					// specific impulse at optimum expansion, m/s
+	double F;					// specific area, m2*s/kg
+
+	/**
+	 * Returns specific impulse at given ambient pressure (Pa), assuming the flow is not separated.
+	 */
+	double getIs_H(double pa) const {
+		return Is_v - F*pa;
+	}
+};
+
+/**
+ * Table of the nozzle sections along the supersonic expansion of one solved problem.
+ *
+ * Stations are solved once at build(), from the throat to the largest area ratio, evenly spaced
+ * in u = sqrt(ln(A/At)): near the throat M-1 ~ sqrt(A/At-1), so the flow parameters are smooth functions of u.
+ * Queries by area ratio, pressure ratio or pressure (the FR, pp and P condition types of
+ * performance::frozen::NozzleSectionConditions) are answered by monotone cubic interpolation between the stations;
+ * solve() re-solves the section exactly on request.
+ *
+ * This replaces the throwaway section used in the scripts to pre-initialize the internal A/At table of the solver.
+ */
+class NozzleStationTable {
+private:
+	enum Value {
+		VALUE_LN_P = 0,
+		VALUE_T,
+		VALUE_M,
+		VALUE_LN_RHO,
+		VALUE_W,
+		VALUE_K,
+		VALUE_IS_V,
+		VALUE_IS,
+		VALUE_LN_F,
+
+		VALUES_NO
+	};
+
+	performance::TheoreticalPerformance* performance;
+	bool checkForFreezing;
+	double p_c;											// injector pressure, Pa
+
+	std::vector<NozzleStation> stations;				// in increasing order of area ratio
+
+	MonotoneCubicInterpolation values[VALUES_NO];		// by u
+	MonotoneCubicInterpolation u;						// by ln(p_c/p)
+
+	static double getU(double Fr) {
+		return Fr>1 ? sqrt(log(Fr)) : 0;
+	}
+
+	void solveStation(double Fr, NozzleStation& station) const;
+
+	void interpolate(double u, NozzleStation& station) const;
+
+public:
+	/**
+	 * @param performance solved problem; must exist as long as this object is used
+	 * @param equilibrium if true, solve shifting equilibrium flow regardless of the freezing conditions of the problem
+	 */
+	explicit NozzleStationTable(performance::TheoreticalPerformance* performance, bool equilibrium = false);
+
+	/**
+	 * Solves the stations from the area ratio Fr_min to Fr_max.
+	 *
+	 * @param stations number of stations
+	 */
+	void build(double Fr_max, int stations = 64, double Fr_min = 1.0);
+
+	size_t getStationsNo() const {
+		return stations.size();
+	}
+
+	const NozzleStation& getStation(size_t i) const {
+		return stations[i];
+	}
+
+	/**
+	 * Interpolates the section at given condition.
+	 *
+	 * @param condition area ratio (FR), pressure ratio p_c/p (pp), p_c being the injector pressure, or pressure in Pa (P)
+	 * @return false if the condition is out of the range of the table; the section is not changed then
+	 */
+	bool get(double condition, performance::frozen::NozzleSectionConditions::CONDITION_TYPE type, NozzleStation& station) const;
+
+	/**
+	 * Solves the section at given condition exactly. The returned object must be deleted by the caller.
+	 *
+	 * @param pa ambient pressure, Pa
+	 */
+	performance::equilibrium::NozzleSectionConditions* solve(double condition, performance::frozen::NozzleSectionConditions::CONDITION_TYPE type, double pa = 0) const;
+
+	/**
+	 * Solves the sections at the midpoints of n intervals evenly distributed over the table, and returns
+	 * the maximum relative error of the interpolated vacuum specific impulse and pressure.
+	 */
+	double check(int n = 8) const;
+};
+
+#endif /* EXAMPLES_STATION_TABLE_HPP_ */
@@ -0,0 +1,582 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "surrogate.hpp"
+#include "threadpool.hpp"
+
+/**
+ * Names of the variables (by SweepAxisType) and of the results (by SweepValue) in the model file.
+ */
+static const char* surrogateVariableNames[] = {"O/F", "alpha", "pc", "A/At", "T_ox", "T_fuel"};
+static const char* surrogateValueNames[SWEEP_VALUES_NO] = {"Is_v", "Is_opt", "Is_SL", "T_c", "O/F", "p_e"};
+
+static const size_t surrogateVariableTypesNo = sizeof(surrogateVariableNames)/sizeof(surrogateVariableNames[0]);
+
+void SurrogateModel::getPowers(const double* x, double p[][SURROGATE_MAX_DEGREE+1]) const {
+	for (size_t v=0; v<types.size(); ++v) {
+		double t = max[v]>min[v] ? 2*(x[v] - min[v])/(max[v] - min[v]) - 1 : 0;
+		p[v][0] = 1;
+		for (int k=1; k<=degree; ++k) {
+			p[v][k] = p[v][k-1]*t;
+		}
+	}
+}
+
+void SurrogateModel::getBasis(const double* x, double* basis) const {
+	size_t n = types.size();
+
+	double p[SURROGATE_MAX_VARIABLES][SURROGATE_MAX_DEGREE+1];
+	getPowers(x, p);
+
+	const unsigned char* e = powers.empty() ? NULL : &powers[0];
+	for (size_t term=0, terms=getTermsNo(); term<terms; ++term, e+=n) {
+		double b = 1;
+		for (size_t v=0; v<n; ++v) {
+			b *= p[v][e[v]];
+		}
+		basis[term] = b;
+	}
+}
+
+void SurrogateModel::evaluate(const double* x, double* values) const {
+	size_t n = types.size();
+
+	double p[SURROGATE_MAX_VARIABLES][SURROGATE_MAX_DEGREE+1];
+	getPowers(x, p);
+
+	for (int i=0; i<SWEEP_VALUES_NO; ++i) {
+		values[i] = 0;
+	}
+
+	const unsigned char* e = powers.empty() ? NULL : &powers[0];
+	const double* c = coefficients.empty() ? NULL : &coefficients[0];
+	for (size_t term=0, terms=getTermsNo(); term<terms; ++term, e+=n, c+=SWEEP_VALUES_NO) {
+		double b = 1;
+		for (size_t v=0; v<n; ++v) {
+			b *= p[v][e[v]];
+		}
+		for (int i=0; i<SWEEP_VALUES_NO; ++i) {
+			values[i] += c[i]*b;
+		}
+	}
+}
+
+static void writeArray(FILE* f, const double* values, size_t n) {
+	fprintf(f, "[");
+	for (size_t i=0; i<n; ++i) {
+		fprintf(f, i>0 ? ", %.17g" : "%.17g", values[i]);
+	}
+	fprintf(f, "]");
+}
+
+bool SurrogateModel::write(const char* path, const char* variable) const {
+	FILE* f = fopen(path, "w");
+	if (!f) {
+		return false;
+	}
+
+	size_t n = types.size();
+	size_t terms = getTermsNo();
+
+	if (variable) {
+		fprintf(f, "var %s = ", variable);
+	}
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"version\": %d,\n", SURROGATE_VERSION);
+
+	fprintf(f, "\t\"variables\": [");
+	for (size_t v=0; v<n; ++v) {
+		fprintf(f, v>0 ? ", \"%s\"" : "\"%s\"", surrogateVariableNames[types[v]]);
+	}
+	fprintf(f, "],\n");
+
+	fprintf(f, "\t\"min\": ");
+	writeArray(f, n>0 ? &min[0] : NULL, n);
+	fprintf(f, ",\n\t\"max\": ");
+	writeArray(f, n>0 ? &max[0] : NULL, n);
+	fprintf(f, ",\n");
+
+	fprintf(f, "\t\"outputs\": [");
+	for (int i=0; i<SWEEP_VALUES_NO; ++i) {
+		fprintf(f, i>0 ? ", \"%s\"" : "\"%s\"", surrogateValueNames[i]);
+	}
+	fprintf(f, "],\n");
+
+	fprintf(f, "\t\"degree\": %d,\n", degree);
+
+	fprintf(f, "\t\"powers\": [");
+	for (size_t term=0; term<terms; ++term) {
+		fprintf(f, term>0 ? ", [" : "[");
+		for (size_t v=0; v<n; ++v) {
+			fprintf(f, v>0 ? ", %d" : "%d", (int)powers[term*n + v]);
+		}
+		fprintf(f, "]");
+	}
+	fprintf(f, "],\n");
+
+	fprintf(f, "\t\"coefficients\": [");
+	for (size_t term=0; term<terms; ++term) {
+		fprintf(f, term>0 ? ",\n\t\t" : "\n\t\t");
+		writeArray(f, &coefficients[term*SWEEP_VALUES_NO], SWEEP_VALUES_NO);
+	}
+	fprintf(f, "\n\t],\n");
+
+	fprintf(f, "\t\"errors\": ");
+	writeArray(f, &errors[0], SWEEP_VALUES_NO);
+	fprintf(f, "\n}%s\n", variable ? ";" : "");
+
+	return 0==fclose(f);
+}
+
+/**
+ * Reads the value of the key of the JSON object written by SurrogateModel::write(): numbers (nested arrays
+ * are flattened) and strings. The parser accepts this format only.
+ *
+ * @return false if the key is not found, or the value is malformed
+ */
+static bool readValue(const std::string& s, const char* key, std::vector<double>* numbers, std::vector<std::string>* strings) {
+	std::string quoted = std::string("\"") + key + "\"";
+	size_t i = s.find(quoted);
+	if (std::string::npos==i) {
+		return false;
+	}
+	i = s.find(':', i + quoted.size());
+	if (std::string::npos==i) {
+		return false;
+	}
+
+	int depth = 0;
+	for (++i; i<s.size(); ++i) {
+		char c = s[i];
+		if ('['==c) {
+			++depth;
+		} else if (']'==c) {
+			if (--depth<=0) {
+				return 0==depth;
+			}
+		} else if ('"'==c) {
+			size_t j = s.find('"', i + 1);
+			if (std::string::npos==j || !strings) {
+				return false;
+			}
+			strings->push_back(s.substr(i + 1, j - i - 1));
+			i = j;
+		} else if ('-'==c || '+'==c || '.'==c || isdigit((unsigned char)c)) {
+			char* end = NULL;
+			double value = strtod(s.c_str() + i, &end);
+			if (!numbers || end==s.c_str() + i) {
+				return false;
+			}
+			numbers->push_back(value);
+			i = end - s.c_str() - 1;
+		} else if ((','==c || '}'==c) && 0==depth) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SurrogateModel::read(const char* path) {
+	FILE* f = fopen(path, "r");
+	if (!f) {
+		return false;
+	}
+	std::string s;
+	char buffer[4096];
+	size_t n;
+	while ((n = fread(buffer, 1, sizeof(buffer), f))>0) {
+		s.append(buffer, n);
+	}
+	fclose(f);
+
+	std::vector<double> version, mins, maxs, degrees, exponents, c, e;
+	std::vector<std::string> variables, outputs;
+	if (!readValue(s, "version", &version, NULL)
+			|| !readValue(s, "variables", NULL, &variables)
+			|| !readValue(s, "min", &mins, NULL)
+			|| !readValue(s, "max", &maxs, NULL)
+			|| !readValue(s, "outputs", NULL, &outputs)
+			|| !readValue(s, "degree", &degrees, NULL)
+			|| !readValue(s, "powers", &exponents, NULL)
+			|| !readValue(s, "coefficients", &c, NULL)
+			|| !readValue(s, "errors", &e, NULL)) {
+		return false;
+	}
+
+	size_t vars = variables.size();
+	if (1!=version.size() || SURROGATE_VERSION!=(int)version[0]
+			|| 0==vars || vars>SURROGATE_MAX_VARIABLES || mins.size()!=vars || maxs.size()!=vars
+			|| 1!=degrees.size() || degrees[0]<0 || degrees[0]>SURROGATE_MAX_DEGREE
+			|| SWEEP_VALUES_NO!=outputs.size() || SWEEP_VALUES_NO!=e.size()
+			|| 0!=exponents.size()%vars || c.size()!=exponents.size()/vars*SWEEP_VALUES_NO) {
+		return false;
+	}
+	for (int i=0; i<SWEEP_VALUES_NO; ++i) {
+		if (outputs[i]!=surrogateValueNames[i]) {
+			return false;
+		}
+	}
+
+	std::vector<SweepAxisType> t(vars);
+	for (size_t v=0; v<vars; ++v) {
+		size_t k = 0;
+		while (k<surrogateVariableTypesNo && variables[v]!=surrogateVariableNames[k]) {
+			++k;
+		}
+		if (k==surrogateVariableTypesNo) {
+			return false;
+		}
+		t[v] = (SweepAxisType)k;
+	}
+
+	std::vector<unsigned char> p(exponents.size());
+	for (size_t i=0; i<exponents.size(); ++i) {
+		if (exponents[i]<0 || exponents[i]>degrees[0]) {
+			return false;
+		}
+		p[i] = (unsigned char)exponents[i];
+	}
+
+	types = t;
+	min = mins;
+	max = maxs;
+	degree = (int)degrees[0];
+	powers = p;
+	coefficients = c;
+	errors = e;
+
+	return true;
+}
+
+/**
+ * Appends the exponents of all the terms of total degree "left" in the variables v..n-1.
+ */
+static void addTerms(size_t v, int left, std::vector<unsigned char>& current, std::vector<unsigned char>& powers) {
+	if (v==current.size()-1) {
+		current[v] = (unsigned char)left;
+		powers.insert(powers.end(), current.begin(), current.end());
+		return;
+	}
+	for (int e=left; e>=0; --e) {
+		current[v] = (unsigned char)e;
+		addTerms(v + 1, left - e, current, powers);
+	}
+}
+
+/**
+ * Returns the number of terms of the polynomial of total degree d in n variables: C(n+d, d).
+ */
+static size_t getTermsNo(size_t n, int d) {
+	size_t terms = 1;
+	for (int k=1; k<=d; ++k) {
+		terms = terms*(n + k)/k;
+	}
+	return terms;
+}
+
+/**
+ * Solves the least squares problem min|A*X-B| by Householder QR.
+ *
+ * @param A matrix m x n, column-major; destroyed
+ * @param B matrix m x k, column-major; destroyed
+ * @param X solution n x k, column-major
+ * @return false if A is rank-deficient
+ */
+static bool solveLeastSquares(std::vector<double>& A, size_t m, size_t n, std::vector<double>& B, size_t k, std::vector<double>& X) {
+	std::vector<double> v(m);
+	for (size_t j=0; j<n; ++j) {
+		double* a = &A[j*m];
+
+		double norm = 0;
+		for (size_t i=j; i<m; ++i) {
+			norm += a[i]*a[i];
+		}
+		norm = sqrt(norm);
+		if (0==norm) {
+			return false;
+		}
+
+		double alpha = a[j]>0 ? -norm : norm;
+		double vnorm = 0;
+		for (size_t i=j; i<m; ++i) {
+			v[i] = a[i];
+		}
+		v[j] -= alpha;
+		for (size_t i=j; i<m; ++i) {
+			vnorm += v[i]*v[i];
+		}
+
+		// Reflect the remaining columns of A and all the columns of B
+		for (size_t c=j; c<n+k; ++c) {
+			double* col = c<n ? &A[c*m] : &B[(c - n)*m];
+			double s = 0;
+			for (size_t i=j; i<m; ++i) {
+				s += v[i]*col[i];
+			}
+			s *= 2/vnorm;
+			for (size_t i=j; i<m; ++i) {
+				col[i] -= s*v[i];
+			}
+		}
+	}
+
+	// Back substitution with R
+	X.assign(n*k, 0);
+	for (size_t c=0; c<k; ++c) {
+		for (size_t j=n; j-->0; ) {
+			double r = A[j*m + j];
+			if (fabs(r)<=1e-12*fabs(A[0])) {
+				return false;
+			}
+			double s = B[c*m + j];
+			for (size_t l=j+1; l<n; ++l) {
+				s -= A[l*m + j]*X[c*n + l];
+			}
+			X[c*n + j] = s/r;
+		}
+	}
+	return true;
+}
+
+SurrogateBuilder::SurrogateBuilder(thermo::input::ConfigFile* data, int threads) :
+	data(data),
+	threads(threads),
+	maxDegree(3),
+	trainingSamples(0),
+	validationSamples(0),
+	seed(1),
+	cache(NULL),
+	solvesNo(0) {
+}
+
+void SurrogateBuilder::addVariable(SweepAxisType type, double min, double max) {
+	if (variables.size()>=SURROGATE_MAX_VARIABLES) {
+		util::Log::errorf("SURROGATE", "Too many variables of surrogate model%s", CR);
+		return;
+	}
+	Variable v;
+	v.type = type;
+	v.min = std::min(min, max);
+	v.max = std::max(min, max);
+	variables.push_back(v);
+}
+
+void SurrogateBuilder::sample(size_t n, unsigned int seed, std::vector<double>& x) const {
+	size_t vars = variables.size();
+	x.resize(n*vars);
+
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+	// Latin hypercube: each variable takes exactly one value in each of n equal intervals of its range
+	std::vector<size_t> strata(n);
+	for (size_t v=0; v<vars; ++v) {
+		for (size_t i=0; i<n; ++i) {
+			strata[i] = i;
+		}
+		std::shuffle(strata.begin(), strata.end(), random);
+		for (size_t i=0; i<n; ++i) {
+			double u = ((double)strata[i] + uniform(random))/(double)n;
+			x[i*vars + v] = variables[v].min + u*(variables[v].max - variables[v].min);
+		}
+	}
+}
+
+bool SurrogateBuilder::solvePoint(thermo::input::ConfigFile* config, const double* x, double* values) const {
+	for (size_t v=0; v<variables.size(); ++v) {
+		setSweepAxisValue(config, variables[v].type, x[v]);
+	}
+
+	PerformanceSnapshot snapshot;
+	try {
+		solvePerformance(cache, config, snapshot);
+	} catch (const std::exception& ex) {
+		util::Log::warnf("SURROGATE", "Could not solve point: %s%s", ex.what(), CR);
+		return false;
+	}
+
+	setSweepValues(snapshot, values);
+	return true;
+}
+
+/**
+ * Task of the worker thread: solves one point using the configuration of the thread.
+ */
+struct SurrogateTask {
+	const SurrogateBuilder* builder;
+	WorkerConfigs* configs;
+	const double* x;
+	double* values;
+
+	void operator()(size_t task, int worker) {
+		builder->solvePoint(configs->get(worker), x + task*builder->getVariablesNo(), values + task*SWEEP_VALUES_NO);
+	}
+};
+
+void SurrogateBuilder::solve(const std::vector<double>& x, std::vector<double>& values) {
+	size_t n = x.size()/variables.size();
+	values.assign(n*SWEEP_VALUES_NO, std::numeric_limits<double>::quiet_NaN());
+
+	ThreadPool pool(threads);
+
+	WorkerConfigs configs(data);
+	configs.prepare(pool.getThreads());
+
+	SurrogateTask task;
+	task.builder = this;
+	task.configs = &configs;
+	task.x = &x[0];
+	task.values = &values[0];
+
+	pool.run(n, task);
+
+	solvesNo += n;
+}
+
+bool SurrogateBuilder::run(SurrogateModel& model) {
+	solvesNo = 0;
+
+	size_t vars = variables.size();
+	int degreeLimit = std::max(1, std::min(maxDegree, SURROGATE_MAX_DEGREE));
+	if (0==vars) {
+		return false;
+	}
+
+	size_t training = trainingSamples>0 ? (size_t)trainingSamples : 3*getTermsNo(vars, degreeLimit);
+	size_t validation = validationSamples>0 ? (size_t)validationSamples : std::max((size_t)10, training/4);
+
+	std::vector<double> x, xv;
+	sample(training, seed, x);
+	sample(validation, seed + 1, xv);
+
+	std::vector<double> y, yv;
+	solve(x, y);
+	solve(xv, yv);
+
+	// Points which could not be solved are dropped
+	std::vector<size_t> train, check;
+	for (size_t i=0; i<training; ++i) {
+		if (!std::isnan(y[i*SWEEP_VALUES_NO])) {
+			train.push_back(i);
+		}
+	}
+	for (size_t i=0; i<validation; ++i) {
+		if (!std::isnan(yv[i*SWEEP_VALUES_NO])) {
+			check.push_back(i);
+		}
+	}
+
+	SurrogateModel candidate;
+	candidate.min.resize(vars);
+	candidate.max.resize(vars);
+	for (size_t v=0; v<vars; ++v) {
+		candidate.types.push_back(variables[v].type);
+		candidate.min[v] = variables[v].min;
+		candidate.max[v] = variables[v].max;
+	}
+
+	// Scale of the errors: maximum absolute value of each result at the validation points
+	double scale[SWEEP_VALUES_NO];
+	for (int r=0; r<SWEEP_VALUES_NO; ++r) {
+		scale[r] = 0;
+		for (size_t i=0; i<check.size(); ++i) {
+			scale[r] = std::max(scale[r], fabs(yv[check[i]*SWEEP_VALUES_NO + r]));
+		}
+	}
+
+	bool fitted = false;
+	for (int d=1; d<=degreeLimit; ++d) {
+		size_t terms = getTermsNo(vars, d);
+		if (train.size()<terms) {
+			break;
+		}
+
+		candidate.degree = d;
+		candidate.powers.clear();
+		std::vector<unsigned char> current(vars);
+		for (int total=0; total<=d; ++total) {
+			addTerms(0, total, current, candidate.powers);
+		}
+
+		// Design matrix: basis functions at the training points
+		size_t m = train.size();
+		std::vector<double> A(m*terms), B(m*SWEEP_VALUES_NO), X, basis(terms);
+		for (size_t i=0; i<m; ++i) {
+			candidate.getBasis(&x[train[i]*vars], &basis[0]);
+			for (size_t term=0; term<terms; ++term) {
+				A[term*m + i] = basis[term];
+			}
+			for (int r=0; r<SWEEP_VALUES_NO; ++r) {
+				B[r*m + i] = y[train[i]*SWEEP_VALUES_NO + r];
+			}
+		}
+
+		if (!solveLeastSquares(A, m, terms, B, SWEEP_VALUES_NO, X)) {
+			util::Log::warnf("SURROGATE", "Polynomial of degree %d is rank-deficient%s", d, CR);
+			break;
+		}
+		candidate.coefficients.resize(terms*SWEEP_VALUES_NO);
+		for (size_t term=0; term<terms; ++term) {
+			for (int r=0; r<SWEEP_VALUES_NO; ++r) {
+				candidate.coefficients[term*SWEEP_VALUES_NO + r] = X[r*terms + term];
+			}
+		}
+
+		// Validation
+		candidate.errors.assign(SWEEP_VALUES_NO, 0);
+		for (size_t i=0; i<check.size(); ++i) {
+			double values[SWEEP_VALUES_NO];
+			candidate.evaluate(&xv[check[i]*vars], values);
+			for (int r=0; r<SWEEP_VALUES_NO; ++r) {
+				double error = fabs(values[r] - yv[check[i]*SWEEP_VALUES_NO + r]);
+				candidate.errors[r] = std::max(candidate.errors[r], scale[r]>0 ? error/scale[r] : error);
+			}
+		}
+
+		util::Log::printf("SURROGATE", "Degree %d: %u terms, validation error of Is_v %g%s",
+			d, (unsigned int)terms, candidate.errors[SWEEP_IS_V], CR);
+
+		if (!fitted || candidate.errors[SWEEP_IS_V]<model.errors[SWEEP_IS_V]) {
+			model = candidate;
+			fitted = true;
+		}
+	}
+
+	if (!fitted) {
+		util::Log::errorf("SURROGATE", "Too few points solved: %u%s", (unsigned int)train.size(), CR);
+	}
+	return fitted;
+}
@@ -0,0 +1,252 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_SURROGATE_HPP_
+#define EXAMPLES_SURROGATE_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+
+#include "performance_cache.hpp"
+#include "sweep.hpp"
+
+/**
+ * Maximum number of variables and maximum degree of the surrogate model.
+ */
+#define SURROGATE_MAX_VARIABLES 8
+#define SURROGATE_MAX_DEGREE 6
+
+/**
+ * Version of the surrogate model file format. Files written with any other version are rejected.
+ */
+#define SURROGATE_VERSION 1
+
+/**
+ * Response surface of the theoretical performance: polynomial of total degree at most "degree" in the variables
+ * scaled to [-1, 1] over the box, for each of the results of the sweep (see SweepValue).
+ *
+ * The model is plain data. Evaluation takes the powers of the scaled variables and one dot product per term;
+ * no problem is solved.
+ *
+ * The model is stored as JSON (see write()), so that it can be evaluated by the scripts as well (see Scripts/surrogate.js).
+ */
+class SurrogateModel {
+private:
+	std::vector<SweepAxisType> types;
+	std::vector<double> min;
+	std::vector<double> max;
+	int degree;
+	std::vector<unsigned char> powers;			// exponents of the variables, for each term
+	std::vector<double> coefficients;			// SWEEP_VALUES_NO coefficients for each term
+	std::vector<double> errors;					// maximum validation errors
+
+	friend class SurrogateBuilder;
+
+	/**
+	 * Calculates the powers 0..degree of the variables scaled to [-1, 1].
+	 */
+	void getPowers(const double* x, double p[][SURROGATE_MAX_DEGREE+1]) const;
+
+	/**
+	 * Calculates the values of the terms at the point.
+	 *
+	 * @param basis array of getTermsNo() values
+	 */
+	void getBasis(const double* x, double* basis) const;
+
+public:
+	SurrogateModel() :
+		degree(0), errors(SWEEP_VALUES_NO, 0) {
+	}
+
+	size_t getVariablesNo() const {
+		return types.size();
+	}
+
+	SweepAxisType getVariableType(size_t i) const {
+		return types[i];
+	}
+
+	double getMin(size_t i) const {
+		return min[i];
+	}
+
+	double getMax(size_t i) const {
+		return max[i];
+	}
+
+	int getDegree() const {
+		return degree;
+	}
+
+	size_t getTermsNo() const {
+		return types.empty() ? 0 : powers.size()/types.size();
+	}
+
+	/**
+	 * Returns the maximum error of the result at the validation points, relative to the maximum absolute value
+	 * of the result at these points.
+	 */
+	double getError(SweepValue value) const {
+		return errors[value];
+	}
+
+	/**
+	 * Evaluates the results at the point.
+	 *
+	 * @param x values of the variables (pressure in Pa, temperature in K); values out of the box are extrapolated
+	 * @param values array of SWEEP_VALUES_NO results
+	 */
+	void evaluate(const double* x, double* values) const;
+
+	double evaluate(const double* x, SweepValue value) const {
+		double values[SWEEP_VALUES_NO];
+		evaluate(x, values);
+		return values[value];
+	}
+
+	/**
+	 * Writes the model as JSON.
+	 *
+	 * @param variable if not NULL, the model is written as JavaScript statement "var <variable> = {...};",
+	 * so that it can be loaded by the scripts
+	 * @return false if the file could not be written
+	 */
+	bool write(const char* path, const char* variable = NULL) const;
+
+	/**
+	 * Reads the model written by write().
+	 *
+	 * @return false if the file could not be read, or it is not a model of supported version; the model is not changed then
+	 */
+	bool read(const char* path);
+};
+
+/**
+ * Fits the surrogate model of the engine over the box of the variables.
+ *
+ * Training and validation points are chosen by independent Latin hypercubes, and all of them are solved
+ * on the thread pool, each thread with its own copy of the configuration. Polynomials of degree 1 to
+ * the maximum one are fitted to the training points by least squares (Householder QR), and the one with
+ * the smallest validation error of vacuum specific impulse is kept.
+ */
+class SurrogateBuilder {
+private:
+	struct Variable {
+		SweepAxisType type;
+		double min;
+		double max;
+	};
+
+	thermo::input::ConfigFile* data;
+	int threads;
+
+	std::vector<Variable> variables;
+	int maxDegree;
+	int trainingSamples;
+	int validationSamples;
+	unsigned int seed;
+
+	PerformanceCache* cache;
+
+	size_t solvesNo;
+
+	void sample(size_t n, unsigned int seed, std::vector<double>& x) const;
+
+	/**
+	 * Solves the points; results of the points which could not be solved are NaN.
+	 */
+	void solve(const std::vector<double>& x, std::vector<double>& values);
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	SurrogateBuilder(thermo::input::ConfigFile* data, int threads = 0);
+
+	/**
+	 * Adds the variable with its range. Pressure is in Pa, temperature is in K.
+	 */
+	void addVariable(SweepAxisType type, double min, double max);
+
+	size_t getVariablesNo() const {
+		return variables.size();
+	}
+
+	/**
+	 * @param maxDegree maximum degree of the polynomial (default 3)
+	 */
+	void setDegree(int maxDegree) {
+		this->maxDegree = maxDegree;
+	}
+
+	/**
+	 * @param training number of training points; if 0 (default), three times the number of terms of the maximum degree
+	 * @param validation number of validation points; if 0 (default), a quarter of training points, but at least 10
+	 */
+	void setSamples(int training, int validation) {
+		trainingSamples = training;
+		validationSamples = validation;
+	}
+
+	/**
+	 * @param seed seed of the random numbers of Latin hypercube
+	 */
+	void setSeed(unsigned int seed) {
+		this->seed = seed;
+	}
+
+	/**
+	 * Sets the cache of results (see ParametricSweep::setCache()).
+	 */
+	void setCache(PerformanceCache* cache) {
+		this->cache = cache;
+	}
+
+	/**
+	 * Solves the points and fits the model.
+	 *
+	 * @return false if too few points could be solved to fit the polynomial of degree 1
+	 */
+	bool run(SurrogateModel& model);
+
+	/**
+	 * Returns the number of the points solved (or taken from the cache) by the last run().
+	 */
+	size_t getSolvesNo() const {
+		return solvesNo;
+	}
+
+	/**
+	 * Solves one point using given configuration. Used by the worker threads.
+	 *
+	 * @param values array of SWEEP_VALUES_NO results
+	 * @return false if the point could not be solved
+	 */
+	bool solvePoint(thermo::input::ConfigFile* config, const double* x, double* values) const;
+};
+
+#endif /* EXAMPLES_SURROGATE_HPP_ */
@@ -0,0 +1,303 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <limits>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "sweep.hpp"
+#include "threadpool.hpp"
+
+void ParametricSweep::addAxis(SweepAxisType type, const std::vector<double>& values) {
+	Axis axis;
+	axis.type = type;
+	axis.values = values;
+	axes.push_back(axis);
+}
+
+size_t ParametricSweep::getPointsNo() const {
+	size_t n = 1;
+	for (size_t a=0; a<axes.size(); ++a) {
+		n *= axes[a].values.size();
+	}
+	return n;
+}
+
+size_t ParametricSweep::getPoint(const std::vector<size_t>& indices) const {
+	size_t point = 0;
+	for (size_t a=0; a<axes.size(); ++a) {
+		point = point*axes[a].values.size() + indices[a];
+	}
+	return point;
+}
+
+size_t ParametricSweep::getIndex(size_t point, size_t axis) const {
+	for (size_t a=axes.size()-1; a>axis; --a) {
+		point /= axes[a].values.size();
+	}
+	return point % axes[axis].values.size();
+}
+
+void setSweepAxisValue(thermo::input::ConfigFile* config, SweepAxisType type, double value) {
+	switch (type) {
+	case SWEEP_AXIS_OF_RATIO:
+		config->getPropellant().setRatio(value, thermo::input::Ratio::km);
+		break;
+	case SWEEP_AXIS_ALPHA:
+		config->getPropellant().setRatio(value, thermo::input::Ratio::alpha);
+		break;
+	case SWEEP_AXIS_CHAMBER_PRESSURE:
+		config->getCombustionChamberConditions().setPressure(value, thermo::input::Pressure::Pa, false);
+		break;
+	case SWEEP_AXIS_AREA_RATIO:
+		config->getNozzleFlowOptions().setNozzleExitConditions().setAreaRatio(value, true);
+		break;
+	case SWEEP_AXIS_OXIDIZER_TEMPERATURE:
+		if (config->getPropellant().getOxidizerListSize()>0) {
+			double dT = value - config->getPropellant().getOxidizer(0).getT(thermo::input::Temperature::K);
+			for (int i=0; i<config->getPropellant().getOxidizerListSize(); ++i) {
+				thermo::input::Component& c = config->getPropellant().getOxidizer(i);
+				c.setT(0==i ? value : c.getT(thermo::input::Temperature::K) + dT, thermo::input::Temperature::K);
+			}
+		}
+		break;
+	case SWEEP_AXIS_FUEL_TEMPERATURE:
+		if (config->getPropellant().getFuelListSize()>0) {
+			double dT = value - config->getPropellant().getFuel(0).getT(thermo::input::Temperature::K);
+			for (int i=0; i<config->getPropellant().getFuelListSize(); ++i) {
+				thermo::input::Component& c = config->getPropellant().getFuel(i);
+				c.setT(0==i ? value : c.getT(thermo::input::Temperature::K) + dT, thermo::input::Temperature::K);
+			}
+		}
+		break;
+	}
+}
+
+bool getSweepAxisValue(thermo::input::ConfigFile* config, SweepAxisType type, double& value) {
+	switch (type) {
+	case SWEEP_AXIS_OF_RATIO:
+	case SWEEP_AXIS_ALPHA:
+		if ((SWEEP_AXIS_OF_RATIO==type ? thermo::input::Ratio::km : thermo::input::Ratio::alpha)!=config->getPropellant().getRatioType()) {
+			return false;
+		}
+		value = config->getPropellant().getRatio();
+		return true;
+	case SWEEP_AXIS_CHAMBER_PRESSURE:
+		value = config->getCombustionChamberConditions().getPressure(thermo::input::Pressure::Pa);
+		return true;
+	case SWEEP_AXIS_AREA_RATIO:
+		if (!config->getNozzleFlowOptions().getNozzleExitConditions().isAreaRatio()) {
+			return false;
+		}
+		value = config->getNozzleFlowOptions().getNozzleExitConditions().getAreaRatio();
+		return true;
+	case SWEEP_AXIS_OXIDIZER_TEMPERATURE:
+		if (0==config->getPropellant().getOxidizerListSize()) {
+			return false;
+		}
+		value = config->getPropellant().getOxidizer(0).getT(thermo::input::Temperature::K);
+		return true;
+	case SWEEP_AXIS_FUEL_TEMPERATURE:
+		if (0==config->getPropellant().getFuelListSize()) {
+			return false;
+		}
+		value = config->getPropellant().getFuel(0).getT(thermo::input::Temperature::K);
+		return true;
+	}
+	return false;
+}
+
+void ParametricSweep::applyPoint(thermo::input::ConfigFile* config, size_t point) const {
+	for (size_t a=0; a<axes.size(); ++a) {
+		setSweepAxisValue(config, axes[a].type, axes[a].values[getIndex(point, a)]);
+	}
+}
+
+int ParametricSweep::getAreaRatioAxis() const {
+	for (int a=(int)axes.size()-1; a>=0; --a) {
+		if (SWEEP_AXIS_AREA_RATIO==axes[a].type) {
+			return a;
+		}
+	}
+	return -1;
+}
+
+void setSweepValues(const PerformanceSnapshot& snapshot, double* values) {
+	values[SWEEP_IS_V] = snapshot.Is_v;
+	values[SWEEP_IS_OPT] = snapshot.Is;
+	values[SWEEP_IS_SL] = snapshot.getIs_H(CONST_ATM);
+	values[SWEEP_P_E] = snapshot.p_e;
+	values[SWEEP_OF_RATIO] = snapshot.r;
+	values[SWEEP_T_C] = snapshot.T_c;
+}
+
+bool ParametricSweep::solvePoint(thermo::input::ConfigFile* config, size_t point, double* values) const {
+	applyPoint(config, point);
+
+	PerformanceSnapshot snapshot;
+
+	try {
+		solvePerformance(cache, config, snapshot);
+	} catch (const std::exception& ex) {
+		util::Log::warnf("SWEEP", "Could not solve point %u: %s%s", (unsigned int)point, ex.what(), CR);
+		return false;
+	}
+
+	setSweepValues(snapshot, values);
+	return true;
+}
+
+void ParametricSweep::solveChamber(thermo::input::ConfigFile* config, size_t point, int areaRatioAxis, double* results, char* solved) const {
+	applyPoint(config, point);
+
+	const std::vector<double>& areaRatios = axes[areaRatioAxis].values;
+
+	// Distance between the points which differ only in the area ratio
+	size_t step = 1;
+	for (size_t a=areaRatioAxis+1; a<axes.size(); ++a) {
+		step *= axes[a].values.size();
+	}
+
+	bool checkForFreezing = config->getNozzleFlowOptions().isFreezingConditionsSet() && config->getNozzleFlowOptions().getFreezingConditions().isCalculate();
+
+	// Keys of the points in the cache; the chamber is not solved if all of them are found
+	std::vector<uint64_t> keys(areaRatios.size(), 0);
+	std::vector<char> cacheable(areaRatios.size(), 0);
+	if (cache) {
+		size_t found = 0;
+		for (size_t j=0; j<areaRatios.size(); ++j) {
+			size_t p = point + j*step;
+			config->getNozzleFlowOptions().setNozzleExitConditions().setAreaRatio(areaRatios[j], true);
+
+			PerformanceSnapshot snapshot;
+			cacheable[j] = getPerformanceCacheKey(config, keys[j]) ? 1 : 0;
+			if (cacheable[j] && cache->find(keys[j], snapshot)) {
+				setSweepValues(snapshot, results + p*SWEEP_VALUES_NO);
+				solved[p] = 1;
+				++found;
+			}
+		}
+		applyPoint(config, point);
+
+		if (found==areaRatios.size()) {
+			return;
+		}
+	}
+
+	performance::TheoreticalPerformance* performance = NULL;
+	try {
+		performance = new performance::TheoreticalPerformance(config, false);
+		performance->solve();
+
+		for (size_t j=0; j<areaRatios.size(); ++j) {
+			size_t p = point + j*step;
+			if (solved[p]) {
+				continue;
+			}
+
+			// Nozzle section of the solved chamber; no ambient pressure, so no flow separation
+			performance::equilibrium::NozzleSectionConditions* section = NULL;
+			try {
+				section = performance->solveNozzleSection(areaRatios[j], performance::frozen::NozzleSectionConditions::FR, checkForFreezing, true, 0, false);
+
+				PerformanceSnapshot snapshot;
+				getPerformanceSnapshot(performance, section, snapshot);
+				if (cacheable[j]) {
+					cache->put(keys[j], snapshot);
+				}
+
+				setSweepValues(snapshot, results + p*SWEEP_VALUES_NO);
+				solved[p] = 1;
+			} catch (const std::exception& ex) {
+				util::Log::warnf("SWEEP", "Could not solve point %u: %s%s", (unsigned int)p, ex.what(), CR);
+			}
+			delete section;
+		}
+
+	} catch (const std::exception& ex) {
+		util::Log::warnf("SWEEP", "Could not solve point %u: %s%s", (unsigned int)point, ex.what(), CR);
+	}
+
+	delete performance;
+}
+
+/**
+ * Task of the worker thread: solves one point using the configuration of the thread.
+ */
+struct ParametricSweepTask {
+	const ParametricSweep* sweep;
+	WorkerConfigs* configs;
+	double* results;
+	char* solved;
+
+	// Chamber reuse: tasks are the chambers, i.e. the points with the first value of the area ratio axis
+	int areaRatioAxis;
+	std::vector<size_t> chambers;
+
+	void operator()(size_t task, int worker) {
+		if (areaRatioAxis>=0) {
+			sweep->solveChamber(configs->get(worker), chambers[task], areaRatioAxis, results, solved);
+		} else {
+			solved[task] = sweep->solvePoint(configs->get(worker), task, results + task*SWEEP_VALUES_NO) ? 1 : 0;
+		}
+	}
+};
+
+void ParametricSweep::run() {
+	size_t n = getPointsNo();
+
+	results.assign(n*SWEEP_VALUES_NO, std::numeric_limits<double>::quiet_NaN());
+	solved.assign(n, 0);
+
+	if (0==n) {
+		return;
+	}
+
+	ThreadPool pool(threads);
+
+	WorkerConfigs configs(data);
+	configs.prepare(pool.getThreads());
+
+	ParametricSweepTask task;
+	task.sweep = this;
+	task.configs = &configs;
+	task.results = &results[0];
+	task.solved = &solved[0];
+	task.areaRatioAxis = reuseChamber ? getAreaRatioAxis() : -1;
+
+	if (task.areaRatioAxis>=0) {
+		for (size_t point=0; point<n; ++point) {
+			if (0==getIndex(point, task.areaRatioAxis)) {
+				task.chambers.push_back(point);
+			}
+		}
+		chamberSolves = task.chambers.size();
+		pool.run(task.chambers.size(), task);
+	} else {
+		chamberSolves = n;
+		pool.run(n, task);
+	}
+}
@@ -0,0 +1,242 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_SWEEP_HPP_
+#define EXAMPLES_SWEEP_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "thermodynamics/input/Input.hpp"
+
+#include "performance_cache.hpp"
+
+/**
+ * Parameter varied along the axis of the sweep.
+ */
+enum SweepAxisType {
+	SWEEP_AXIS_OF_RATIO = 0,				// O/F weight ratio
+	SWEEP_AXIS_ALPHA = 1,					// oxidizer excess coefficient
+	SWEEP_AXIS_CHAMBER_PRESSURE = 2,		// chamber pressure, Pa
+	SWEEP_AXIS_AREA_RATIO = 3,				// nozzle exit area ratio
+	SWEEP_AXIS_OXIDIZER_TEMPERATURE = 4,	// temperature of the first oxidizer component, K
+	SWEEP_AXIS_FUEL_TEMPERATURE = 5			// temperature of the first fuel component, K
+};
+
+/**
+ * Sets the value of the parameter in the configuration. Pressure is in Pa, temperature is in K.
+ *
+ * Temperature of the oxidizer (fuel) is the temperature of its first component; the other components are shifted
+ * by the same difference, so that the components keep their temperatures relative to each other.
+ */
+extern void setSweepAxisValue(thermo::input::ConfigFile* config, SweepAxisType type, double value);
+
+/**
+ * Gets the value of the parameter from the configuration. Pressure is in Pa, temperature is in K
+ * (of the first component).
+ *
+ * @return false if the configuration does not specify the parameter this way (e.g. the ratio is given as
+ * another type, or the nozzle exit is given by the pressure)
+ */
+extern bool getSweepAxisValue(thermo::input::ConfigFile* config, SweepAxisType type, double& value);
+
+/**
+ * Results obtained for each point of the sweep.
+ */
+enum SweepValue {
+	SWEEP_IS_V = 0,						// vacuum specific impulse, m/s
+	SWEEP_IS_OPT = 1,					// specific impulse at optimum expansion, m/s
+	SWEEP_IS_SL = 2,					// specific impulse at sea level, m/s
+	SWEEP_T_C = 3,						// chamber temperature, K
+	SWEEP_OF_RATIO = 4,					// O/F weight ratio
+	SWEEP_P_E = 5,						// nozzle exit pressure, Pa
+
+	SWEEP_VALUES_NO = 6
+};
+
+/**
+ * Fills the array of SWEEP_VALUES_NO results from the snapshot of solved problem.
+ */
+extern void setSweepValues(const PerformanceSnapshot& snapshot, double* values);
+
+/**
+ * Theoretical performance on the grid of O/F ratio, chamber pressure and nozzle area ratio.
+ *
+ * The grid is the Cartesian product of the axes; points are numbered in row-major order, the first added
+ * axis being the outermost one (as in nested loops). Points are solved on the thread pool: each thread has its
+ * own copy of the configuration and its own solver, so the points are solved independently of each other.
+ *
+ * Parameters which are not varied are taken from the configuration.
+ *
+ * With chamber reuse enabled (default), points which differ only in the nozzle area ratio share one solution
+ * of the combustion chamber: the chamber is solved once, and each area ratio is obtained as the nozzle section
+ * of that solution.
+ *
+ * If the cache is set, points which have been solved before (in this or previous runs) are taken from the cache.
+ */
+class ParametricSweep {
+private:
+	struct Axis {
+		SweepAxisType type;
+		std::vector<double> values;
+	};
+
+	thermo::input::ConfigFile* data;
+	std::vector<Axis> axes;
+	int threads;
+	bool reuseChamber;
+	size_t chamberSolves;
+
+	PerformanceCache* cache;
+
+	std::vector<double> results;
+	std::vector<char> solved;
+
+	void applyPoint(thermo::input::ConfigFile* config, size_t point) const;
+
+	/**
+	 * Returns the axis of the nozzle area ratio, or -1 if there is no such axis.
+	 */
+	int getAreaRatioAxis() const;
+
+public:
+	/**
+	 * @param data configuration of the engine; must exist as long as this object is used
+	 * @param threads number of threads; 0 to use all hardware threads
+	 */
+	ParametricSweep(thermo::input::ConfigFile* data, int threads = 0) :
+		data(data), threads(threads), reuseChamber(true), chamberSolves(0), cache(NULL) {
+	}
+
+	/**
+	 * Adds the axis of the grid. Pressure values are in Pa.
+	 */
+	void addAxis(SweepAxisType type, const std::vector<double>& values);
+
+	size_t getAxesNo() const {
+		return axes.size();
+	}
+
+	SweepAxisType getAxisType(size_t axis) const {
+		return axes[axis].type;
+	}
+
+	const std::vector<double>& getAxisValues(size_t axis) const {
+		return axes[axis].values;
+	}
+
+	/**
+	 * Returns the total number of points of the grid.
+	 */
+	size_t getPointsNo() const;
+
+	/**
+	 * Returns the number of point from the indices of the values at each axis.
+	 */
+	size_t getPoint(const std::vector<size_t>& indices) const;
+
+	/**
+	 * Returns the index of the value at given axis for the point.
+	 */
+	size_t getIndex(size_t point, size_t axis) const;
+
+	void setThreads(int threads) {
+		this->threads = threads;
+	}
+
+	void setReuseChamber(bool reuseChamber) {
+		this->reuseChamber = reuseChamber;
+	}
+
+	bool isReuseChamber() const {
+		return reuseChamber;
+	}
+
+	/**
+	 * Sets the cache of results: points found in the cache are not solved, and solved points are stored in the cache.
+	 *
+	 * @param cache cache of results; must exist as long as this object is used; NULL to solve all points
+	 */
+	void setCache(PerformanceCache* cache) {
+		this->cache = cache;
+	}
+
+	/**
+	 * Returns the number of combustion chamber solutions planned by the last run(); points found in the cache
+	 * are not solved at all (see PerformanceCache::getHits()).
+	 */
+	size_t getChamberSolves() const {
+		return chamberSolves;
+	}
+
+	/**
+	 * Returns the number of full solutions avoided by chamber reuse in the last run().
+	 */
+	size_t getSolvesSaved() const {
+		return getPointsNo() - chamberSolves;
+	}
+
+	/**
+	 * Solves all the points of the grid.
+	 */
+	void run();
+
+	/**
+	 * Solves one point using given configuration and returns its results. Used by the worker threads.
+	 *
+	 * @param config configuration which is modified according to the point
+	 * @param values array of SWEEP_VALUES_NO elements
+	 * @return false if the point could not be solved
+	 */
+	bool solvePoint(thermo::input::ConfigFile* config, size_t point, double* values) const;
+
+	/**
+	 * Solves the combustion chamber once for the point, and the nozzle sections for all the values of the area ratio axis.
+	 * Used by the worker threads.
+	 *
+	 * @param point point with the first value of the area ratio axis
+	 * @param results dense result tensor
+	 * @param solved solved flags of all the points
+	 */
+	void solveChamber(thermo::input::ConfigFile* config, size_t point, int areaRatioAxis, double* results, char* solved) const;
+
+	/**
+	 * Returns false if the point could not be solved; its results are undefined then.
+	 */
+	bool isSolved(size_t point) const {
+		return point<solved.size() && 0!=solved[point];
+	}
+
+	double get(size_t point, SweepValue value) const {
+		return results[point*SWEEP_VALUES_NO + value];
+	}
+
+	/**
+	 * Returns the dense result tensor: SWEEP_VALUES_NO values per point, points in row-major order.
+	 */
+	const std::vector<double>& getResults() const {
+		return results;
+	}
+};
+
+#endif /* EXAMPLES_SWEEP_HPP_ */
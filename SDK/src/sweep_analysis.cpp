@@ -0,0 +1,185 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "common.hpp"
+#include "database.hpp"
+#include "design_optimizer.hpp"
+#include "performance_cache.hpp"
+#include "sensitivity.hpp"
+#include "surrogate.hpp"
+#include "sweep.hpp"
+
+/**
+ * This example calculates the performance of rocket engine on the grid of O/F ratio, chamber pressure
+ * and nozzle area ratio (see also Scripts/nested_analysis2.js), solving the grid points in parallel.
+ * The same ranges are then searched by the design optimizer, and approximated by the surrogate model.
+ * Finally, the derivatives of the performance are calculated at the point of the configuration.
+ */
+int main(int argc, char* argv[]) {
+
+	util::Log::createLog("ROOT")->
+		addLogger(new util::FileLogger("", 10*1024));
+
+	// Initialize thermodatabase
+	initThermoDatabase(THERMO_DATABASE_OPTION_LAZY);
+
+	// Initialize configuration file object
+	thermo::input::ConfigFile* data = new thermo::input::ConfigFile("examples/RD-275.cfg");
+
+	// Read configuration file
+	data->read();
+
+	// Array with different values of O/F weight ratio
+	double r[] = {2.4, 2.6, 2.8, 3.0, 3.2, 3.4};
+
+	// Array with different values of combustion chamber pressure (MPa)
+	double pc[] = {5, 10, 15, 20};
+
+	// Array with different values of nozzle exit area ratio
+	double Aexit[] = {20, 26, 40, 60};
+
+	std::vector<double> pcValues;
+	for (size_t j=0; j<sizeof(pc)/sizeof(pc[0]); ++j) {
+		pcValues.push_back(thermo::input::Pressure::convert(pc[j], thermo::input::Pressure::MPa, thermo::input::Pressure::Pa));
+	}
+
+	// Results of the previous runs are kept in resources/cache
+	PerformanceCache cache;
+
+	// Use all hardware threads
+	ParametricSweep sweep(data);
+	sweep.setCache(&cache);
+	sweep.addAxis(SWEEP_AXIS_OF_RATIO, std::vector<double>(r, r + sizeof(r)/sizeof(r[0])));
+	sweep.addAxis(SWEEP_AXIS_CHAMBER_PRESSURE, pcValues);
+	sweep.addAxis(SWEEP_AXIS_AREA_RATIO, std::vector<double>(Aexit, Aexit + sizeof(Aexit)/sizeof(Aexit[0])));
+
+	sweep.run();
+
+	printf("# %u points, %u chamber solutions (%u saved by chamber reuse)\n",
+		(unsigned int)sweep.getPointsNo(), (unsigned int)sweep.getChamberSolves(), (unsigned int)sweep.getSolvesSaved());
+	printf("# %u points found in the cache\n", (unsigned int)cache.getHits());
+
+	// Print out table header
+	printf("#%4s %6s %5s %8s %8s %8s %8s\n", "r", "pc,MPa", "A/At", "Is_v,s", "Is_opt,s", "Is_sl,s", "T_c,K");
+
+	for (size_t point=0; point<sweep.getPointsNo(); ++point) {
+		if (!sweep.isSolved(point)) {
+			continue;
+		}
+		printf(" %4.2f %6.2f %5.1f %8.2f %8.2f %8.2f %8.2f\n",
+			sweep.getAxisValues(0)[sweep.getIndex(point, 0)],
+			pc[sweep.getIndex(point, 1)],
+			sweep.getAxisValues(2)[sweep.getIndex(point, 2)],
+			sweep.get(point, SWEEP_IS_V)/CONST_G,
+			sweep.get(point, SWEEP_IS_OPT)/CONST_G,
+			sweep.get(point, SWEEP_IS_SL)/CONST_G,
+			sweep.get(point, SWEEP_T_C)
+		);
+	}
+
+	// Search the same ranges for the maximum of Isp averaged over the ascent, instead of the full grid
+	DesignOptimizer optimizer(data);
+	optimizer.setCache(&cache);
+	optimizer.addVariable(SWEEP_AXIS_OF_RATIO, r[0], r[sizeof(r)/sizeof(r[0])-1], 2.8);
+	optimizer.addVariable(SWEEP_AXIS_CHAMBER_PRESSURE, pcValues.front(), pcValues.back(), pcValues[1]);
+	optimizer.addVariable(SWEEP_AXIS_AREA_RATIO, Aexit[0], Aexit[sizeof(Aexit)/sizeof(Aexit[0])-1], 26);
+	optimizer.addAltitude(0, 1);
+	optimizer.addAltitude(10e3, 1);
+	optimizer.addAltitude(30e3, 1);
+	optimizer.setVacuumWeight(1);
+
+	double Is = optimizer.run();
+
+	printf("# optimum of averaged Isp: r=%4.2f pc=%6.2f MPa A/At=%5.1f Is=%8.2f s (%d points solved)\n",
+		optimizer.getValue(0),
+		thermo::input::Pressure::convert(optimizer.getValue(1), thermo::input::Pressure::Pa, thermo::input::Pressure::MPa),
+		optimizer.getValue(2),
+		Is/CONST_G,
+		optimizer.getEvaluationsNo()
+	);
+
+	// Fit the response surface over the same box, validated against the points it has not been fitted to
+	SurrogateBuilder builder(data);
+	builder.setCache(&cache);
+	builder.addVariable(SWEEP_AXIS_OF_RATIO, r[0], r[sizeof(r)/sizeof(r[0])-1]);
+	builder.addVariable(SWEEP_AXIS_CHAMBER_PRESSURE, pcValues.front(), pcValues.back());
+	builder.addVariable(SWEEP_AXIS_AREA_RATIO, Aexit[0], Aexit[sizeof(Aexit)/sizeof(Aexit[0])-1]);
+
+	SurrogateModel model;
+	if (builder.run(model)) {
+		printf("# surrogate model: degree %d, %u points solved, validation error of Is_v %.3f%%\n",
+			model.getDegree(), (unsigned int)builder.getSolvesNo(), model.getError(SWEEP_IS_V)*100);
+
+		model.write("RD-275.surrogate.js", "model");
+
+		// Compare with the grid
+		printf("#%4s %6s %5s %8s %8s\n", "r", "pc,MPa", "A/At", "Is_v,s", "model,s");
+		for (size_t point=0; point<sweep.getPointsNo(); point+=7) {
+			if (!sweep.isSolved(point)) {
+				continue;
+			}
+			double x[] = {
+				sweep.getAxisValues(0)[sweep.getIndex(point, 0)],
+				sweep.getAxisValues(1)[sweep.getIndex(point, 1)],
+				sweep.getAxisValues(2)[sweep.getIndex(point, 2)]
+			};
+			printf(" %4.2f %6.2f %5.1f %8.2f %8.2f\n",
+				x[0], pc[sweep.getIndex(point, 1)], x[2],
+				sweep.get(point, SWEEP_IS_V)/CONST_G,
+				model.evaluate(x, SWEEP_IS_V)/CONST_G
+			);
+		}
+	}
+
+	// Derivatives at the point of the configuration, e.g. for the gradient-based optimizers of the vehicle
+	SensitivityAnalysis sensitivity(data);
+	sensitivity.addInput(SWEEP_AXIS_OF_RATIO);
+	sensitivity.addInput(SWEEP_AXIS_CHAMBER_PRESSURE);
+	sensitivity.addInput(SWEEP_AXIS_AREA_RATIO);
+
+	if (sensitivity.run()) {
+		printf("# sensitivity at r=%4.2f pc=%6.2f MPa A/At=%5.1f (%u chamber solutions)\n",
+			sensitivity.getInputValue(0),
+			thermo::input::Pressure::convert(sensitivity.getInputValue(1), thermo::input::Pressure::Pa, thermo::input::Pressure::MPa),
+			sensitivity.getInputValue(2),
+			(unsigned int)sensitivity.getSolvesNo());
+		printf("#%9s %12s %12s %12s\n", "", "d/dr", "d/dpc,1/MPa", "d/d(A/At)");
+		printf(" %9s %12.4f %12.4f %12.4f\n", "Is_v,s",
+			sensitivity.get(SWEEP_IS_V, 0)/CONST_G, sensitivity.get(SWEEP_IS_V, 1)*1e6/CONST_G, sensitivity.get(SWEEP_IS_V, 2)/CONST_G);
+		printf(" %9s %12.4f %12.4f %12.4f\n", "T_c,K",
+			sensitivity.get(SWEEP_T_C, 0), sensitivity.get(SWEEP_T_C, 1)*1e6, sensitivity.get(SWEEP_T_C, 2));
+	}
+
+	delete data;
+
+	util::Log::finalize();
+
+	return 0;
+}
@@ -0,0 +1,356 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include "utils/Util.hpp"
+
+#include "database.hpp"
+#include "simd.hpp"
+#include "thermo_table.hpp"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Polynomials of one species, parsed from thermo.inp record.
+ */
+struct ThermoPolynomials {
+	std::string name;
+	std::vector<double> T;				// bounds of temperature intervals
+	std::vector<double> coefficients;	// [interval][coefficient]
+};
+
+/**
+ * Returns the value of the Fortran-formatted field; exponent may be marked by 'D'.
+ */
+static double parseField(const std::string& line, size_t pos, size_t length) {
+	if (pos>=line.size()) {
+		return 0;
+	}
+	std::string field = line.substr(pos, length);
+	for (size_t i=0; i<field.size(); ++i) {
+		if ('D'==field[i] || 'd'==field[i]) {
+			field[i] = 'E';
+		}
+	}
+	return atof(field.c_str());
+}
+
+/**
+ * Parses thermo.inp record: name line, line with number of intervals, and 3 lines per interval:
+ *  - temperature range (2F11.3), number of coefficients (I1), exponents (8F5.1)
+ *  - a1..a5 (5D16.8)
+ *  - a6, a7 (2D16.8), 16 blanks, b1, b2 (2D16.8)
+ *
+ * @return false if the record could not be parsed, or uses non-standard exponents
+ */
+static bool parseThermoPolynomials(const std::string& record, ThermoPolynomials& p) {
+	std::vector<std::string> lines;
+	for (size_t pos=0; pos<record.size(); ) {
+		size_t end = record.find('\n', pos);
+		if (std::string::npos==end) {
+			end = record.size();
+		}
+		std::string line = record.substr(pos, end - pos);
+		if (!line.empty() && '\r'==line[line.size()-1]) {
+			line.erase(line.size()-1);
+		}
+		lines.push_back(line);
+		pos = end + 1;
+	}
+
+	if (lines.size()<2) {
+		return false;
+	}
+
+	int intervals = atoi(lines[1].substr(0, 2).c_str());
+	if (intervals<=0 || lines.size()<2 + 3*(size_t)intervals) {
+		return false;
+	}
+
+	static const double exponents[7] = {-2, -1, 0, 1, 2, 3, 4};
+
+	p.T.clear();
+	p.coefficients.clear();
+
+	for (int i=0; i<intervals; ++i) {
+		const std::string& range = lines[2 + 3*i];
+		const std::string& a = lines[3 + 3*i];
+		const std::string& b = lines[4 + 3*i];
+
+		double T1 = parseField(range, 0, 11);
+		double T2 = parseField(range, 11, 11);
+
+		if (0==i) {
+			p.T.push_back(T1);
+		} else if (fabs(T1 - p.T.back())>1e-6) {
+			return false;
+		}
+		p.T.push_back(T2);
+
+		if (range.size()<23 || '7'!=range[22]) {
+			return false;
+		}
+		for (int j=0; j<7; ++j) {
+			if (fabs(parseField(range, 23 + 5*j, 5) - exponents[j])>1e-6) {
+				return false;
+			}
+		}
+
+		for (int j=0; j<5; ++j) {
+			p.coefficients.push_back(parseField(a, 16*j, 16));
+		}
+		p.coefficients.push_back(parseField(b, 0, 16));
+		p.coefficients.push_back(parseField(b, 16, 16));
+		p.coefficients.push_back(parseField(b, 48, 16));
+		p.coefficients.push_back(parseField(b, 64, 16));
+	}
+
+	return true;
+}
+
+//*****************************************************************************
+
+/**
+ * Scalar kernel for species [begin, end) of the interval.
+ *
+ * @param c coefficients of the interval: COEFFICIENTS arrays of "stride" elements
+ * @param bcp, bh, bs temperature terms multiplied by each coefficient in Cp/R, H/(R*T) and S/R
+ */
+static void evaluateKernelScalar(const double* c, size_t stride, size_t begin, size_t end,
+		const double* bcp, const double* bh, const double* bs, double* cp, double* h, double* s) {
+	for (size_t i=begin; i<end; ++i) {
+		double vcp = 0, vh = 0, vs = 0;
+		for (int k=0; k<ThermoPolynomialTable::COEFFICIENTS; ++k) {
+			double a = c[k*stride + i];
+			vcp += a*bcp[k];
+			vh += a*bh[k];
+			vs += a*bs[k];
+		}
+		cp[i] = vcp;
+		h[i] = vh;
+		s[i] = vs;
+	}
+}
+
+#ifdef SIMD_SSE2
+static void evaluateKernelSse2(const double* c, size_t stride, size_t n,
+		const double* bcp, const double* bh, const double* bs, double* cp, double* h, double* s) {
+	size_t i = 0;
+	for (; i+2<=n; i+=2) {
+		__m128d vcp = _mm_setzero_pd();
+		__m128d vh = _mm_setzero_pd();
+		__m128d vs = _mm_setzero_pd();
+		for (int k=0; k<ThermoPolynomialTable::COEFFICIENTS; ++k) {
+			__m128d a = _mm_loadu_pd(c + k*stride + i);
+			vcp = _mm_add_pd(vcp, _mm_mul_pd(a, _mm_set1_pd(bcp[k])));
+			vh = _mm_add_pd(vh, _mm_mul_pd(a, _mm_set1_pd(bh[k])));
+			vs = _mm_add_pd(vs, _mm_mul_pd(a, _mm_set1_pd(bs[k])));
+		}
+		_mm_storeu_pd(cp + i, vcp);
+		_mm_storeu_pd(h + i, vh);
+		_mm_storeu_pd(s + i, vs);
+	}
+	evaluateKernelScalar(c, stride, i, n, bcp, bh, bs, cp, h, s);
+}
+#endif
+
+#ifdef SIMD_X86
+SIMD_TARGET_AVX2
+static void evaluateKernelAvx2(const double* c, size_t stride, size_t n,
+		const double* bcp, const double* bh, const double* bs, double* cp, double* h, double* s) {
+	size_t i = 0;
+	for (; i+4<=n; i+=4) {
+		__m256d vcp = _mm256_setzero_pd();
+		__m256d vh = _mm256_setzero_pd();
+		__m256d vs = _mm256_setzero_pd();
+		for (int k=0; k<ThermoPolynomialTable::COEFFICIENTS; ++k) {
+			__m256d a = _mm256_loadu_pd(c + k*stride + i);
+			vcp = _mm256_fmadd_pd(a, _mm256_set1_pd(bcp[k]), vcp);
+			vh = _mm256_fmadd_pd(a, _mm256_set1_pd(bh[k]), vh);
+			vs = _mm256_fmadd_pd(a, _mm256_set1_pd(bs[k]), vs);
+		}
+		_mm256_storeu_pd(cp + i, vcp);
+		_mm256_storeu_pd(h + i, vh);
+		_mm256_storeu_pd(s + i, vs);
+	}
+	evaluateKernelScalar(c, stride, i, n, bcp, bh, bs, cp, h, s);
+}
+#endif
+
+//*****************************************************************************
+
+bool ThermoPolynomialTable::build(const std::vector<std::string>& species) {
+	names.clear();
+	groups.clear();
+	buffer.clear();
+
+	if (!isThermoDatabaseLazy()) {
+		util::Log::warnf("THERMO", "Polynomials table requires thermodynamics database loaded in lazy mode%s", CR);
+		return false;
+	}
+
+	bool result = true;
+
+	// Species grouped by temperature intervals
+	std::map<std::vector<double>, std::vector<ThermoPolynomials> > byIntervals;
+	std::map<std::vector<double>, std::vector<size_t> > positions;
+
+	for (size_t i=0; i<species.size(); ++i) {
+		if (std::find(species.begin(), species.begin() + i, species[i])!=species.begin() + i) {
+			continue;
+		}
+
+		std::string record;
+		if (!getThermoSpeciesRecord(species[i], record)) {
+			util::Log::warnf("THERMO", "Species %s not found in thermodynamics database%s", species[i].c_str(), CR);
+			result = false;
+			continue;
+		}
+
+		ThermoPolynomials p;
+		p.name = species[i];
+
+		if (!parseThermoPolynomials(record, p)) {
+			if (atoi(record.substr(record.find('\n') + 1, 2).c_str())>0) {
+				util::Log::warnf("THERMO", "Could not parse polynomials of species %s%s", species[i].c_str(), CR);
+				result = false;
+			}
+			continue;
+		}
+
+		byIntervals[p.T].push_back(p);
+		positions[p.T].push_back(names.size());
+		names.push_back(p.name);
+	}
+
+	std::map<std::vector<double>, std::vector<ThermoPolynomials> >::const_iterator it = byIntervals.begin();
+	for (; it!=byIntervals.end(); ++it) {
+		Group group;
+		group.T = it->first;
+		group.species = positions[it->first];
+		group.stride = (group.species.size() + 3) & ~(size_t)3;
+
+		size_t intervals = group.T.size() - 1;
+		group.coefficients.assign(intervals*COEFFICIENTS*group.stride, 0.0);
+
+		for (size_t i=0; i<group.species.size(); ++i) {
+			const ThermoPolynomials& p = it->second[i];
+			for (size_t j=0; j<intervals; ++j) {
+				for (int k=0; k<COEFFICIENTS; ++k) {
+					group.coefficients[(j*COEFFICIENTS + k)*group.stride + i] = p.coefficients[j*COEFFICIENTS + k];
+				}
+			}
+		}
+
+		groups.push_back(group);
+		if (buffer.size()<3*group.stride) {
+			buffer.resize(3*group.stride);
+		}
+	}
+
+	return result;
+}
+
+int ThermoPolynomialTable::indexOf(const std::string& name) const {
+	for (size_t i=0; i<names.size(); ++i) {
+		if (names[i]==name) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+void ThermoPolynomialTable::evaluate(double T, double* cp, double* h, double* s, int level) const {
+	// Results of the group are calculated contiguously, and then stored in the order of species
+	size_t stride = buffer.size()/3;
+	double* gcp = buffer.empty() ? NULL : &buffer[0];
+	double* gh = gcp + stride;
+	double* gs = gh + stride;
+
+	double lnT = log(T);
+	double T2 = T*T;
+	double T3 = T2*T;
+	double T4 = T3*T;
+
+	// Terms multiplied by a1..a7, b1, b2
+	const double bcp[COEFFICIENTS] = {1/T2, 1/T, 1, T, T2, T3, T4, 0, 0};
+	const double bh[COEFFICIENTS] = {-1/T2, lnT/T, 1, T/2, T2/3, T3/4, T4/5, 1/T, 0};
+	const double bs[COEFFICIENTS] = {-1/T2/2, -1/T, lnT, T, T2/2, T3/3, T4/4, 0, 1};
+
+	for (size_t g=0; g<groups.size(); ++g) {
+		const Group& group = groups[g];
+
+		// Interval is the same for all the species of the group
+		size_t interval = 0;
+		while (interval+2<group.T.size() && T>=group.T[interval+1]) {
+			++interval;
+		}
+
+		const double* c = &group.coefficients[interval*COEFFICIENTS*group.stride];
+
+		size_t n = group.species.size();
+
+		switch (level) {
+#ifdef SIMD_X86
+		case SIMD_LEVEL_AVX2:
+			evaluateKernelAvx2(c, group.stride, n, bcp, bh, bs, gcp, gh, gs);
+			break;
+#endif
+#ifdef SIMD_SSE2
+		case SIMD_LEVEL_SSE2:
+			evaluateKernelSse2(c, group.stride, n, bcp, bh, bs, gcp, gh, gs);
+			break;
+#endif
+		default:
+			evaluateKernelScalar(c, group.stride, 0, n, bcp, bh, bs, gcp, gh, gs);
+			break;
+		}
+
+		for (size_t i=0; i<n; ++i) {
+			size_t k = group.species[i];
+			if (cp) {
+				cp[k] = gcp[i];
+			}
+			if (h) {
+				h[k] = gh[i];
+			}
+			if (s) {
+				s[k] = gs[i];
+			}
+		}
+	}
+}
+
+void ThermoPolynomialTable::evaluate(double T, double* cp, double* h, double* s) const {
+	evaluate(T, cp, h, s, getSimdLevel());
+}
+
+void ThermoPolynomialTable::evaluateScalar(double T, double* cp, double* h, double* s) const {
+	evaluate(T, cp, h, s, SIMD_LEVEL_NONE);
+}
@@ -0,0 +1,107 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_THERMO_TABLE_HPP_
+#define EXAMPLES_THERMO_TABLE_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * NASA 9-coefficient polynomials of the set of species, stored as structure of arrays.
+ *
+ * Species with the same temperature intervals form one group; within the group, each coefficient of each
+ * interval is a contiguous array over the species. At given temperature the interval is selected once
+ * per group, and all the species of the group are evaluated by the vectorized kernel (AVX2 or SSE2,
+ * selected at runtime, see simd.hpp).
+ *
+ * Results are dimensionless: Cp/R, H/(R*T) and S/R, in the order of getName(i), which is the order of species
+ * passed to build().
+ */
+class ThermoPolynomialTable {
+public:
+	/**
+	 * Number of coefficients of the interval: a1..a7 and integration constants b1, b2.
+	 */
+	static const int COEFFICIENTS = 9;
+
+private:
+	struct Group {
+		std::vector<double> T;				// bounds of temperature intervals, intervals+1 values
+		std::vector<size_t> species;		// index of each species of the group in the table
+		size_t stride;						// number of species rounded up to multiple of 4
+		std::vector<double> coefficients;	// [interval][coefficient][stride]
+	};
+
+	std::vector<std::string> names;
+	std::vector<Group> groups;
+
+	// Results of one group, 3 arrays of the largest stride; allocated by build() so that evaluate() doesn't allocate
+	mutable std::vector<double> buffer;
+
+	void evaluate(double T, double* cp, double* h, double* s, int level) const;
+
+public:
+	ThermoPolynomialTable() {
+	}
+
+	/**
+	 * Builds the table for given species from their thermo.inp records (see getThermoSpeciesRecord()), so
+	 * the database has to be initialized in lazy mode (THERMO_DATABASE_OPTION_LAZY).
+	 * Species without temperature intervals (reactants defined at single temperature) and repeated names are skipped;
+	 * other species keep their order.
+	 *
+	 * @return false if the database is not initialized in lazy mode, or any of the species could not be found or parsed
+	 */
+	bool build(const std::vector<std::string>& species);
+
+	size_t size() const {
+		return names.size();
+	}
+
+	const std::string& getName(size_t i) const {
+		return names[i];
+	}
+
+	/**
+	 * Returns the index of the species in the table, or -1 if the species is not in the table.
+	 */
+	int indexOf(const std::string& name) const;
+
+	/**
+	 * Evaluates Cp/R, H/(R*T) and S/R of all the species at given temperature.
+	 * Outside of the defined range the polynomial of the first or the last interval is used.
+	 *
+	 * Uses the scratch buffer of the table, so the same table must not be evaluated on several threads at once.
+	 *
+	 * @param T temperature, K
+	 * @param cp, h, s output arrays of size() elements; any of them may be NULL
+	 */
+	void evaluate(double T, double* cp, double* h, double* s) const;
+
+	/**
+	 * Same as evaluate(), using the scalar kernel only. Used for verification of the vectorized kernels.
+	 */
+	void evaluateScalar(double T, double* cp, double* h, double* s) const;
+};
+
+#endif /* EXAMPLES_THERMO_TABLE_HPP_ */
@@ -0,0 +1,92 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_THREADPOOL_HPP_
+#define EXAMPLES_THREADPOOL_HPP_
+
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * Executes the set of independent tasks on several threads.
+ *
+ * Tasks are handed out one by one from the shared counter, so that the threads which got fast tasks
+ * take over the remaining ones. Each task is executed with the index of the worker thread, which can be used
+ * to access per-thread state (e.g. solver objects) without locking.
+ */
+class ThreadPool {
+private:
+	int threads;
+
+	template<typename Task>
+	static void work(Task* task, std::atomic<size_t>* next, size_t size, int worker) {
+		for (size_t i=(*next)++; i<size; i=(*next)++) {
+			(*task)(i, worker);
+		}
+	}
+
+public:
+	/**
+	 * @param threads number of worker threads; 0 to use all hardware threads
+	 */
+	explicit ThreadPool(int threads = 0) :
+		threads(threads) {
+		if (this->threads<=0) {
+			this->threads = (int)std::thread::hardware_concurrency();
+		}
+		if (this->threads<=0) {
+			this->threads = 1;
+		}
+	}
+
+	int getThreads() const {
+		return threads;
+	}
+
+	/**
+	 * Executes tasks 0..size-1 and waits until all of them are finished.
+	 * The calling thread is used as worker 0.
+	 *
+	 * @param task object with the method void operator()(size_t i, int worker)
+	 */
+	template<typename Task>
+	void run(size_t size, Task& task) {
+		std::atomic<size_t> next(0);
+
+		int n = (size_t)threads<size ? threads : (int)size;
+
+		std::vector<std::thread> workers;
+		for (int w=1; w<n; ++w) {
+			workers.push_back(std::thread(&ThreadPool::work<Task>, &task, &next, size, w));
+		}
+
+		work(&task, &next, size, 0);
+
+		for (size_t w=0; w<workers.size(); ++w) {
+			workers[w].join();
+		}
+	}
+};
+
+#endif /* EXAMPLES_THREADPOOL_HPP_ */
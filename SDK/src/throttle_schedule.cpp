@@ -0,0 +1,124 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/Util.hpp"
+#include "thermodynamics/input/Input.hpp"
+#include "thermodynamics/thermo/Thermodynamics.hpp"
+#include "thermodynamics/dll/Export.hpp"
+
+#include "throttle_schedule.hpp"
+
+/**
+ * Orders the indices of points by throttle value.
+ */
+struct ThrottleValueLess {
+	const double* values;
+
+	explicit ThrottleValueLess(const double* values) :
+		values(values) {
+	}
+
+	bool operator()(size_t a, size_t b) const {
+		return values[a]<values[b];
+	}
+};
+
+//*****************************************************************************
+
+ThrottleSchedule::ThrottleSchedule(performance::TheoreticalPerformance* nominal) :
+	nominal(nominal), throttlingPerformance(NULL), current(0), solves(0) {
+}
+
+ThrottleSchedule::~ThrottleSchedule() {
+	delete throttlingPerformance;
+}
+
+bool ThrottleSchedule::isNominal(double value) {
+	return fabs(value - 1.0)<1e-12;
+}
+
+performance::TheoreticalPerformance* ThrottleSchedule::throttle(double value) {
+	if (isNominal(value)) {
+		return nominal;
+	}
+
+	if (!throttlingPerformance) {
+		throttlingPerformance = new performance::ThrottlingPerformance(nominal, value);
+		++solves;
+	} else if (value!=current) {
+		throttlingPerformance->throttle(value);
+		++solves;
+	}
+	current = value;
+
+	return throttlingPerformance;
+}
+
+int ThrottleSchedule::solve(const double* values, size_t n, ThrottlePoint* points, bool correctionFactors) {
+	int solved = solves;
+
+	std::vector<size_t> order(n);
+	for (size_t i=0; i<n; ++i) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), ThrottleValueLess(values));
+
+	// Start from the end which is closer to the current state of the solver
+	if (n>1 && current>0 && fabs(values[order[n-1]] - current)<fabs(values[order[0]] - current)) {
+		std::reverse(order.begin(), order.end());
+	}
+
+	for (size_t j=0; j<n; ++j) {
+		ThrottlePoint& point = points[order[j]];
+
+		if (j>0 && values[order[j]]==values[order[j-1]]) {
+			// Same value as the previous point
+			point = points[order[j-1]];
+			continue;
+		}
+
+		performance::TheoreticalPerformance* performance = throttle(values[order[j]]);
+
+		point.throttle = values[order[j]];
+		point.pa_crit = performance->getPaCrit();
+		getPerformanceSnapshot(performance, NULL, point.snapshot);
+
+		point.phi = 1.0;
+		if (correctionFactors) {
+			performance::efficiency::CorrectionFactors factors(performance);
+			point.phi = factors.getOverallEfficiency();
+		}
+	}
+
+	return solves - solved;
+}
+
+int ThrottleSchedule::solve(const std::vector<double>& values, std::vector<ThrottlePoint>& points, bool correctionFactors) {
+	points.resize(values.size());
+	if (values.empty()) {
+		return 0;
+	}
+	return solve(&values[0], values.size(), &points[0], correctionFactors);
+}
@@ -0,0 +1,101 @@
+/*
+ * RPA - Tool for Rocket Propulsion Analysis
+ * RPA Software Development Kit (SDK)
+ *
+ * Copyright 2009,2015 Alexander Ponomarenko.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This software is a commercial product; you can use it under the terms of the
+ * RPA SDK License as published at http://www.propulsion-analysis.com/sdk_eula.htm
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the RPA SDK License for more details (a copy is included
+ * in the sdk_eula.htm file that accompanied this program).
+ *
+ * You should have received a copy of the RPA SDK License along with this program;
+ * if not, write to author <contact@propulsion-analysis.com>
+ *
+ * Please contact author <contact@propulsion-analysis.com> or visit http://www.propulsion-analysis.com
+ * if you need additional information or have any questions.
+ */
+
+#ifndef EXAMPLES_THROTTLE_SCHEDULE_HPP_
+#define EXAMPLES_THROTTLE_SCHEDULE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "thermodynamics/dll/Export.hpp"
+
+#include "performance_cache.hpp"
+
+/**
+ * Results of one point of the throttle schedule.
+ */
+struct ThrottlePoint {
+	double throttle;					// throttle value
+	double phi;							// performance correction factor (1 if not calculated)
+	double pa_crit;						// critical ambient pressure, Pa
+	PerformanceSnapshot snapshot;		// chamber and nozzle exit conditions
+};
+
+/**
+ * Throttled performance of one solved problem at many throttle values.
+ *
+ * All the points share one ThrottlingPerformance object, created from the nominal solution on first use, so
+ * the species set of the nominal problem is loaded and prepared once. throttle() only re-solves the problem
+ * when the value changes, and returns the nominal solution itself for throttle value 1.
+ *
+ * solve() calculates a batch of values in sorted order, starting from the end closest to the current value,
+ * so that each point is solved next to the previous one; repeated values are solved once.
+ */
+class ThrottleSchedule {
+private:
+	performance::TheoreticalPerformance* nominal;
+	performance::ThrottlingPerformance* throttlingPerformance;
+
+	double current;						// value the throttling solver is at, or 0 if it is not created yet
+	int solves;
+
+	static bool isNominal(double value);
+
+public:
+	/**
+	 * @param nominal solved problem; must exist as long as this object is used
+	 */
+	explicit ThrottleSchedule(performance::TheoreticalPerformance* nominal);
+
+	~ThrottleSchedule();
+
+	/**
+	 * Returns the problem solved at given throttle value: the nominal problem for value 1, otherwise
+	 * the throttling solver, re-solved only if it is at other value.
+	 *
+	 * The returned object and its sections are valid until the next call.
+	 */
+	performance::TheoreticalPerformance* throttle(double value);
+
+	/**
+	 * Solves n throttle values.
+	 *
+	 * @param points array of n points, filled in the order of values
+	 * @param correctionFactors if true, calculate the performance correction factor of each point
+	 * @return number of the problems solved
+	 */
+	int solve(const double* values, size_t n, ThrottlePoint* points, bool correctionFactors = false);
+
+	/**
+	 * Same as solve(), for the vector of values.
+	 */
+	int solve(const std::vector<double>& values, std::vector<ThrottlePoint>& points, bool correctionFactors = false);
+
+	/**
+	 * Returns total number of the problems solved by this object.
+	 */
+	int getSolvesNo() const {
+		return solves;
+	}
+};
+
+#endif /* EXAMPLES_THROTTLE_SCHEDULE_HPP_ */
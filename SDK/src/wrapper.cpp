@@ -1,6 +1,7 @@
 #include "wrapper.h"
 
 #include <cstdio>
+#include <cstdlib>
 
 #include "utils/Util.hpp"
 #include "thermodynamics/input/Input.hpp"
@@ -14,6 +15,22 @@
 #include "nozzle/digitized/NozzleContour.hpp"
 
 #include "common.hpp"
+#include "design_optimizer.hpp"
+#include "engine_deck.hpp"
+#include "engine_pipeline.hpp"
+#include "flow_separation.hpp"
+#include "freezing_point.hpp"
+#include "moc_design.hpp"
+#include "monte_carlo.hpp"
+#include "nozzle_contour.hpp"
+#include "nozzle_optimizer.hpp"
+#include "performance_curve.hpp"
+#include "sensitivity.hpp"
+#include "station_table.hpp"
+#include "surrogate.hpp"
+#include "sweep.hpp"
+#include "thermo_table.hpp"
+#include "throttle_schedule.hpp"
 #include "wrapper.h"
 
 #ifdef __cplusplus
@@ -35,6 +52,19 @@ void initialize(bool consoleOutput) {
 	initThermoDatabase();
 }
 
+void initializeWithOptions(bool consoleOutput, unsigned int databaseOptions) {
+	util::Log::createLog("ROOT")->
+		addLogger(new util::FileLogger("", 10*1024));
+
+	if (consoleOutput) {
+		util::Log::getLog("ROOT")->
+			addLogger(new util::ConsoleLogger());
+	}
+
+	// Initialize thermodatabase
+	initThermoDatabase(databaseOptions);
+}
+
 void finalize() {
 	util::Log::finalize();
 }
@@ -871,6 +901,8 @@ void configFileEngineSizeDeleteParabolicExitAngle(void* dataPtr) {
 void* performanceCreate(void* dataPtr, bool solve, bool optimizePropellant) {
 	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
 	if (data) {
+		loadThermoSpecies(data);
+
 		performance::TheoreticalPerformance* performance = new performance::TheoreticalPerformance(data, false);
 		if (solve) {
 			performanceSolve(performance, optimizePropellant);
@@ -899,81 +931,100 @@ void performanceSolve(void* performancePtr, bool optimizePropellant) {
 	}
 }
 
-double performanceGetDeliveredIsp(void* performancePtr, const char* IspUnits, double pa, const char* pressureUnits, double phi) {
-	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
-	if (performance) {
-		double checkFlowSeparation = performance->getData()->getGeneralOptions().isFlowSeparation();
+/**
+ * Returns the factor to convert Isp from m/s to given units: "m/s", "ft/s" or "s"; 0 for unknown units.
+ */
+static double getIspFactor(const char* IspUnits) {
+	if (0==strcmp(IspUnits, "m/s")) {
+		return 1;
+	} else if (0==strcmp(IspUnits, "ft/s")) {
+		return thermo::input::Length::convert(1.0, thermo::input::Length::m, thermo::input::Length::ft);
+	} else if (0==strcmp(IspUnits, "s")) {
+		return 1/CONST_G;
+	}
+	return 0;
+}
 
-		pa = thermo::input::Pressure::convert(pa, thermo::input::Pressure::rawToUnit(pressureUnits), thermo::input::Pressure::Pa);
+double performanceGetDeliveredIsp(void* performancePtr, const char* IspUnits, double pa, const char* pressureUnits, double phi) {
+	double IsH = 0;
+	performanceGetDeliveredIspArray(performancePtr, IspUnits, &pa, 1, pressureUnits, phi, &IsH);
+	return IsH;
+}
 
-		// Get nozzle exit object
-		performance::equilibrium::NozzleSectionConditions* exitSection = performance->getExitSection();
-		performance::equilibrium::NozzleSectionConditions* flowSeparationSection = NULL;
+void performanceGetDeliveredIspArray(void* performancePtr, const char* IspUnits, const double* pa, int n, const char* pressureUnits, double phi, double* out) {
+	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
+	if (!performance) {
+		for (int i=0; i<n; ++i) {
+			out[i] = 0;
+		}
+		return;
+	}
 
-		if (checkFlowSeparation) {
+	// Conversion factors of pressure (to Pa) and of Isp (from m/s)
+	double paFactor = thermo::input::Pressure::convert(1.0, thermo::input::Pressure::rawToUnit(pressureUnits), thermo::input::Pressure::Pa);
+	double IspFactor = getIspFactor(IspUnits);
 
-			// Critical ambient pressure
-			double pa_crit = performance->getPaCrit();
+	if (phi<=0) {
+		// Get performance correction factor
+		performance::efficiency::CorrectionFactors* correctionFactors = new performance::efficiency::CorrectionFactors(performance);
+		phi = correctionFactors->getOverallEfficiency();
+		delete correctionFactors;
+	}
 
-			if (pa>pa_crit) {
-				// If pa>pa_crit, there is a flow separation in the nozzle
-				// Find the location of the flow separation
+	// Get nozzle exit object
+	performance::equilibrium::NozzleSectionConditions* exitSection = performance->getExitSection();
+	double Is_v = exitSection->getIs_v()*phi;
+	double F = exitSection->getF();
 
-				thermo::input::NozzleFlowOptions* pFlowOptions = new thermo::input::NozzleFlowOptions(performance->getData()->getNozzleFlowOptions());
+	bool checkFlowSeparation = performance->getData()->getGeneralOptions().isFlowSeparation();
 
-				bool checkForFreezing = pFlowOptions->isFreezingConditionsSet() && pFlowOptions->getFreezingConditions().isCalculate();
+	// Critical ambient pressure: if pa>pa_crit, there is a flow separation in the nozzle
+	double pa_crit = checkFlowSeparation ? performance->getPaCrit() : 0;
 
-				thermo::input::NozzleSectionConditions& nozzleSectionConditions = pFlowOptions->getNozzleExitConditions();
-				double condition;
-				performance::frozen::NozzleSectionConditions::CONDITION_TYPE conditionType;
-				if (nozzleSectionConditions.isAreaRatio()) {
-					condition = nozzleSectionConditions.getAreaRatio();
-					conditionType = performance::frozen::NozzleSectionConditions::FR;
-				} else if (nozzleSectionConditions.isPressureRatio()) {
-					condition = nozzleSectionConditions.getPressureRatio();
-					conditionType = performance::frozen::NozzleSectionConditions::pp;
-				} else if (nozzleSectionConditions.isPressure()) {
-					condition = nozzleSectionConditions.getPressure();
-					conditionType = performance::frozen::NozzleSectionConditions::P;
-				}
+	// Nozzle exit conditions used to find the location of the flow separation
+	bool checkForFreezing = false;
+	double condition = 0;
+	performance::frozen::NozzleSectionConditions::CONDITION_TYPE conditionType = performance::frozen::NozzleSectionConditions::FR;
+	if (checkFlowSeparation) {
+		thermo::input::NozzleFlowOptions& flowOptions = performance->getData()->getNozzleFlowOptions();
 
-				flowSeparationSection = performance->solveNozzleSection(condition, conditionType, checkForFreezing, true, pa, false);
-			}
+		checkForFreezing = flowOptions.isFreezingConditionsSet() && flowOptions.getFreezingConditions().isCalculate();
 
+		thermo::input::NozzleSectionConditions& nozzleSectionConditions = flowOptions.getNozzleExitConditions();
+		if (nozzleSectionConditions.isAreaRatio()) {
+			condition = nozzleSectionConditions.getAreaRatio();
+			conditionType = performance::frozen::NozzleSectionConditions::FR;
+		} else if (nozzleSectionConditions.isPressureRatio()) {
+			condition = nozzleSectionConditions.getPressureRatio();
+			conditionType = performance::frozen::NozzleSectionConditions::pp;
+		} else if (nozzleSectionConditions.isPressure()) {
+			condition = nozzleSectionConditions.getPressure();
+			conditionType = performance::frozen::NozzleSectionConditions::P;
 		}
+	}
 
-		if (phi<=0) {
-			// Get performance correction factor
-			performance::efficiency::CorrectionFactors* correctionFactors = new performance::efficiency::CorrectionFactors(performance);
-			phi = correctionFactors->getOverallEfficiency();
-			delete correctionFactors;
-		}
+	for (int i=0; i<n; ++i) {
+		double p = pa[i]*paFactor;
 
-		// Specific impulse at defined altitude, m/s
-		double IsH = 0;
+		// Specific impulse at defined ambient pressure, m/s
+		double IsH;
 
-		if (flowSeparationSection) {
+		if (checkFlowSeparation && p>pa_crit) {
 			// Calculate Isp for nozzle with flow separation.
+			performance::equilibrium::NozzleSectionConditions* flowSeparationSection = performance->solveNozzleSection(condition, conditionType, checkForFreezing, true, p, false);
+
 			double p2 = flowSeparationSection->getP();
-			double IsH2 = 0.3*(pa - p2)*(flowSeparationSection->getF() - exitSection->getF());
-			IsH = flowSeparationSection->getIs_v()*phi - flowSeparationSection->getF()*pa + IsH2;
+			double IsH2 = 0.3*(p - p2)*(flowSeparationSection->getF() - F);
+			IsH = flowSeparationSection->getIs_v()*phi - flowSeparationSection->getF()*p + IsH2;
+
+			delete flowSeparationSection;
 		} else {
 			// Calculate Isp for nozzle without flow separation.
-			IsH = exitSection->getIs_v()*phi - exitSection->getF()*pa;
+			IsH = Is_v - F*p;
 		}
 
-		delete flowSeparationSection;
-
-		if (0==strcmp(IspUnits, "m/s")) {
-			return IsH;
-		} else if (0==strcmp(IspUnits, "ft/s")) {
-			return thermo::input::Length::convert(IsH, thermo::input::Length::m, thermo::input::Length::ft);
-		} else if (0==strcmp(IspUnits, "s")) {
-			return IsH/CONST_G;
-		}
+		out[i] = IsH*IspFactor;
 	}
-
-	return 0;
 }
 
 double performanceGetDeliveredIspH(void* performancePtr, const char* IspUnits, double H, const char* altitudeUnits, double phi) {
@@ -982,6 +1033,19 @@ double performanceGetDeliveredIspH(void* performancePtr, const char* IspUnits, d
 	return performanceGetDeliveredIsp(performancePtr, IspUnits, sa.getPressure(), "Pa", phi);
 }
 
+void performanceGetDeliveredIspHArray(void* performancePtr, const char* IspUnits, const double* H, int n, const char* altitudeUnits, double phi, double* out) {
+	double HFactor = thermo::input::Length::convert(1.0, thermo::input::Length::rawToUnit(altitudeUnits), thermo::input::Length::m);
+
+	StandardAtmosphere sa;
+	for (int i=0; i<n; ++i) {
+		sa.setAltitude(H[i]*HFactor);
+		out[i] = sa.getPressure();
+	}
+
+	// Ambient pressures are passed in place of the results
+	performanceGetDeliveredIspArray(performancePtr, IspUnits, out, n, "Pa", phi, out);
+}
+
 double performanceGetIdealIsp(void* performancePtr, const char* IspUnits, double pa, const char* pressureUnits) {
 	return performanceGetDeliveredIsp(performancePtr, IspUnits, pa, pressureUnits, 1.0);
 }
@@ -1013,48 +1077,16 @@ void performancePrint(void* performancePtr) {
 void* chamberCreate(void* performancePtr, bool applyCorrectionFactors) {
 	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
 	if (performance) {
-		thermo::input::ConfigFile* data = performance->getData();
-
-		if (data->getEngineSize().isThrustSet() || data->getEngineSize().isMdotSet() || data->getEngineSize().isThroatDSet()) {
-
-			// Design parameters of combustion chamber
-			double b = data->getEngineSize().getChamberGeometry().getContractionAngle() * M_PI / 180.;
-			double R1 = data->getEngineSize().getChamberGeometry().getR1ToRtRatio();
-			double R2 = data->getEngineSize().getChamberGeometry().getR2ToR2maxRatio();
-			double Lstar = data->getEngineSize().getChamberGeometry().getChamberLength();
-			bool isLstar = data->getEngineSize().getChamberGeometry().isCharacteristicLength();
-
-
-			performance::efficiency::CorrectionFactors* correctionFactors = NULL;
-			if (applyCorrectionFactors) {
-				correctionFactors = new performance::efficiency::CorrectionFactors(performance);
-			}
-
-			design::Chamber* chamber = new design::Chamber(performance, correctionFactors);
-
-			if (data->getEngineSize().isThrustSet()) {
-				chamber->setThrust(data->getEngineSize().getThrust(true) / (double)data->getEngineSize().getChambersNo(), data->getEngineSize().getAmbientPressure(true));
-			} else
-			if (data->getEngineSize().isMdotSet()) {
-				chamber->setMdot(data->getEngineSize().getMdot(true) / (double)data->getEngineSize().getChambersNo());
-			} else
-			if (data->getEngineSize().isThroatDSet()) {
-				chamber->setDt(data->getEngineSize().getThroatD(true));
-			}
-
-			chamber->setB(b);
-			chamber->setR1toRt(R1);
-			chamber->setR2toR2max(R2);
-			if (isLstar) {
-				chamber->setLstar(Lstar);
-			} else {
-				// Lstar is actually L'
-				chamber->setLc(Lstar);
-			}
-			chamber->calcGeometry();
+		performance::efficiency::CorrectionFactors* correctionFactors = NULL;
+		if (applyCorrectionFactors) {
+			correctionFactors = new performance::efficiency::CorrectionFactors(performance);
+		}
 
-			return chamber;
+		design::Chamber* chamber = createChamber(performance, correctionFactors);
+		if (!chamber) {
+			delete correctionFactors;
 		}
+		return chamber;
 	}
 	return NULL;
 }
@@ -1219,6 +1251,1095 @@ double nozzleGetLength(void* nozzlePtr, const char* units) {
 	return 0;
 }
 
+int nozzleGetWallAngles(void* nozzlePtr, const double* t, int n, double* theta, const char* units) {
+	design::MocNozzle* nozzle = dynamic_cast<design::MocNozzle*>(reinterpret_cast<design::Nozzle*>(nozzlePtr));
+	if (!nozzle || !t || !theta || n<=0) {
+		return 0;
+	}
+
+	getMocWallAngles(nozzle, t, (size_t)n, theta);
+	for (int i=0; i<n; ++i) {
+		theta[i] = thermo::input::Angle::convert(theta[i]*180./M_PI, thermo::input::Angle::degrees, thermo::input::Angle::rawToUnit(units));
+	}
+	return n;
+}
+
+double nozzleGetMaxWallAngle(void* nozzlePtr, const char* units) {
+	design::MocNozzle* nozzle = dynamic_cast<design::MocNozzle*>(reinterpret_cast<design::Nozzle*>(nozzlePtr));
+	if (nozzle) {
+		return thermo::input::Angle::convert(findMocMaxWallAngle(nozzle)*180./M_PI, thermo::input::Angle::degrees, thermo::input::Angle::rawToUnit(units));
+	}
+	return 0;
+}
+
+//*****************************************************************************
+
+void* thermoTableCreate(const char** names, int size) {
+	std::vector<std::string> species;
+	for (int i=0; i<size; ++i) {
+		species.push_back(names[i]);
+	}
+
+	ThermoPolynomialTable* table = new ThermoPolynomialTable();
+	if (!table->build(species)) {
+		delete table;
+		return NULL;
+	}
+	return table;
+}
+
+void thermoTableDelete(void* tablePtr) {
+	if (tablePtr) {
+		delete reinterpret_cast<ThermoPolynomialTable*>(tablePtr);
+	}
+}
+
+int thermoTableGetSize(void* tablePtr) {
+	ThermoPolynomialTable* table = reinterpret_cast<ThermoPolynomialTable*>(tablePtr);
+	if (table) {
+		return (int)table->size();
+	}
+	return 0;
+}
+
+const char* thermoTableGetName(void* tablePtr, int i) {
+	ThermoPolynomialTable* table = reinterpret_cast<ThermoPolynomialTable*>(tablePtr);
+	if (table && i>=0 && i<(int)table->size()) {
+		return table->getName(i).c_str();
+	}
+	return NULL;
+}
+
+void thermoTableEvaluate(void* tablePtr, double T, const char* temperatureUnits, double* cp, double* h, double* s) {
+	ThermoPolynomialTable* table = reinterpret_cast<ThermoPolynomialTable*>(tablePtr);
+	if (table) {
+		table->evaluate(thermo::input::Temperature::convert(T, thermo::input::Temperature::rawToUnit(temperatureUnits), thermo::input::Temperature::K), cp, h, s);
+	}
+}
+
+//*****************************************************************************
+
+void* sweepCreate(void* dataPtr) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (data) {
+		return new ParametricSweep(data);
+	}
+	return NULL;
+}
+
+void sweepDelete(void* sweepPtr) {
+	if (sweepPtr) {
+		delete reinterpret_cast<ParametricSweep*>(sweepPtr);
+	}
+}
+
+void sweepAddAxis(void* sweepPtr, const char* type, const double* values, int size, const char* units) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep) {
+		std::vector<double> v(values, values + size);
+		if (0==strcmp(type, "O/F")) {
+			sweep->addAxis(SWEEP_AXIS_OF_RATIO, v);
+		} else if (0==strcmp(type, "alpha")) {
+			sweep->addAxis(SWEEP_AXIS_ALPHA, v);
+		} else if (0==strcmp(type, "pc")) {
+			for (size_t i=0; i<v.size(); ++i) {
+				v[i] = thermo::input::Pressure::convert(v[i], thermo::input::Pressure::rawToUnit(units), thermo::input::Pressure::Pa);
+			}
+			sweep->addAxis(SWEEP_AXIS_CHAMBER_PRESSURE, v);
+		} else if (0==strcmp(type, "A/At")) {
+			sweep->addAxis(SWEEP_AXIS_AREA_RATIO, v);
+		} else {
+			util::Log::errorf("SWEEP", "Unknown type of sweep axis: %s%s", type, CR);
+		}
+	}
+}
+
+void sweepRun(void* sweepPtr, int threads) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep) {
+		sweep->setThreads(threads);
+		sweep->run();
+	}
+}
+
+void sweepSetReuseChamber(void* sweepPtr, bool reuseChamber) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep) {
+		sweep->setReuseChamber(reuseChamber);
+	}
+}
+
+int sweepGetSolvesSaved(void* sweepPtr) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep) {
+		return (int)sweep->getSolvesSaved();
+	}
+	return 0;
+}
+
+int sweepGetPointsNo(void* sweepPtr) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep) {
+		return (int)sweep->getPointsNo();
+	}
+	return 0;
+}
+
+int sweepGetIndex(void* sweepPtr, int point, int axis) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep && axis>=0 && axis<(int)sweep->getAxesNo()) {
+		return (int)sweep->getIndex(point, axis);
+	}
+	return 0;
+}
+
+bool sweepIsSolved(void* sweepPtr, int point) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep) {
+		return sweep->isSolved(point);
+	}
+	return false;
+}
+
+double sweepGetValue(void* sweepPtr, int point, const char* name, const char* units) {
+	ParametricSweep* sweep = reinterpret_cast<ParametricSweep*>(sweepPtr);
+	if (sweep && sweep->isSolved(point)) {
+		if (0==strcmp(name, "Is_v") || 0==strcmp(name, "Is_opt") || 0==strcmp(name, "Is_SL")) {
+			double Is = sweep->get(point, 0==strcmp(name, "Is_v") ? SWEEP_IS_V : (0==strcmp(name, "Is_opt") ? SWEEP_IS_OPT : SWEEP_IS_SL));
+			if (0==strcmp(units, "m/s")) {
+				return Is;
+			} else if (0==strcmp(units, "ft/s")) {
+				return thermo::input::Length::convert(Is, thermo::input::Length::m, thermo::input::Length::ft);
+			} else if (0==strcmp(units, "s")) {
+				return Is/CONST_G;
+			}
+		} else if (0==strcmp(name, "T_c")) {
+			return thermo::input::Temperature::convert(sweep->get(point, SWEEP_T_C), thermo::input::Temperature::K, thermo::input::Temperature::rawToUnit(units));
+		} else if (0==strcmp(name, "O/F")) {
+			return sweep->get(point, SWEEP_OF_RATIO);
+		} else if (0==strcmp(name, "p_e")) {
+			return thermo::input::Pressure::convert(sweep->get(point, SWEEP_P_E), thermo::input::Pressure::Pa, thermo::input::Pressure::rawToUnit(units));
+		}
+	}
+	return 0;
+}
+
+//*****************************************************************************
+
+void* flowSeparationTableCreate(void* performancePtr, double paMax, const char* pressureUnits, double tolerance) {
+	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
+	if (performance) {
+		FlowSeparationTable* table = new FlowSeparationTable(performance);
+		double pa_max = thermo::input::Pressure::convert(paMax, thermo::input::Pressure::rawToUnit(pressureUnits), thermo::input::Pressure::Pa);
+		if (tolerance>0) {
+			table->build(pa_max, tolerance);
+		} else {
+			table->build(pa_max);
+		}
+		return table;
+	}
+	return NULL;
+}
+
+void flowSeparationTableDelete(void* tablePtr) {
+	delete reinterpret_cast<FlowSeparationTable*>(tablePtr);
+}
+
+double flowSeparationTableGetDeliveredIsp(void* tablePtr, const char* IspUnits, double pa, const char* pressureUnits, double phi) {
+	FlowSeparationTable* table = reinterpret_cast<FlowSeparationTable*>(tablePtr);
+	if (table) {
+		if (phi<=0) {
+			// Get performance correction factor
+			performance::efficiency::CorrectionFactors* correctionFactors = new performance::efficiency::CorrectionFactors(table->getPerformance());
+			phi = correctionFactors->getOverallEfficiency();
+			delete correctionFactors;
+		}
+
+		pa = thermo::input::Pressure::convert(pa, thermo::input::Pressure::rawToUnit(pressureUnits), thermo::input::Pressure::Pa);
+
+		return table->getIs_H(pa, phi)*getIspFactor(IspUnits);
+	}
+	return 0;
+}
+
+double flowSeparationTableGetErrorBound(void* tablePtr) {
+	FlowSeparationTable* table = reinterpret_cast<FlowSeparationTable*>(tablePtr);
+	if (table) {
+		return table->getErrorBound();
+	}
+	return 0;
+}
+
+//*****************************************************************************
+
+void* performanceCurveCreate(void* performancePtr, double phi, double mdot, double paMax, const char* pressureUnits) {
+	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
+	if (performance) {
+		double pa_max = paMax>0 ? thermo::input::Pressure::convert(paMax, thermo::input::Pressure::rawToUnit(pressureUnits), thermo::input::Pressure::Pa) : 0;
+		return new PerformanceCurve(performance, phi, mdot, pa_max);
+	}
+	return NULL;
+}
+
+void performanceCurveDelete(void* curvePtr) {
+	delete reinterpret_cast<PerformanceCurve*>(curvePtr);
+}
+
+void performanceCurveEvaluate(void* curvePtr, const char* IspUnits, const double* pa, const double* throttle, int n, const char* pressureUnits, double* Is, double* thrust) {
+	PerformanceCurve* curve = reinterpret_cast<PerformanceCurve*>(curvePtr);
+	if (!curve || n<=0) {
+		return;
+	}
+
+	// Conversion factors of pressure (to Pa) and of Isp (from m/s)
+	double paFactor = thermo::input::Pressure::convert(1.0, thermo::input::Pressure::rawToUnit(pressureUnits), thermo::input::Pressure::Pa);
+	double IspFactor = getIspFactor(IspUnits);
+
+	std::vector<double> p;
+	if (paFactor!=1.0) {
+		p.resize(n);
+		for (int i=0; i<n; ++i) {
+			p[i] = pa[i]*paFactor;
+		}
+		pa = &p[0];
+	}
+
+	curve->evaluate(pa, throttle, n, Is, thrust);
+
+	if (IspFactor!=1.0) {
+		for (int i=0; i<n; ++i) {
+			Is[i] *= IspFactor;
+		}
+	}
+}
+
+//*****************************************************************************
+
+void* throttleScheduleCreate(void* performancePtr) {
+	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
+	if (performance) {
+		return new ThrottleSchedule(performance);
+	}
+	return NULL;
+}
+
+void throttleScheduleDelete(void* schedulePtr) {
+	delete reinterpret_cast<ThrottleSchedule*>(schedulePtr);
+}
+
+void* throttleScheduleThrottle(void* schedulePtr, double value) {
+	ThrottleSchedule* schedule = reinterpret_cast<ThrottleSchedule*>(schedulePtr);
+	if (schedule) {
+		return schedule->throttle(value);
+	}
+	return NULL;
+}
+
+int throttleScheduleGetDeliveredIsp(void* schedulePtr, const double* values, int n, const char* IspUnits, double pa, const char* pressureUnits, bool correctionFactors, double* out) {
+	ThrottleSchedule* schedule = reinterpret_cast<ThrottleSchedule*>(schedulePtr);
+	if (!schedule || n<=0) {
+		return 0;
+	}
+
+	std::vector<ThrottlePoint> points(n);
+	int solved = schedule->solve(values, n, &points[0], correctionFactors);
+
+	pa = thermo::input::Pressure::convert(pa, thermo::input::Pressure::rawToUnit(pressureUnits), thermo::input::Pressure::Pa);
+	double IspFactor = getIspFactor(IspUnits);
+
+	for (int i=0; i<n; ++i) {
+		out[i] = (points[i].snapshot.Is_v*points[i].phi - points[i].snapshot.F*pa)*IspFactor;
+	}
+
+	return solved;
+}
+
+//*****************************************************************************
+
+void* designOptimizerCreate(void* dataPtr) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (data) {
+		return new DesignOptimizer(data);
+	}
+	return NULL;
+}
+
+void designOptimizerDelete(void* optimizerPtr) {
+	delete reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+}
+
+/**
+ * Returns the type of design variable by its name; false for unknown names.
+ */
+static bool getDesignVariableType(const char* type, SweepAxisType& axisType) {
+	if (0==strcmp(type, "O/F")) {
+		axisType = SWEEP_AXIS_OF_RATIO;
+	} else if (0==strcmp(type, "pc")) {
+		axisType = SWEEP_AXIS_CHAMBER_PRESSURE;
+	} else if (0==strcmp(type, "A/At")) {
+		axisType = SWEEP_AXIS_AREA_RATIO;
+	} else {
+		util::Log::errorf("OPTIMIZE", "Unknown type of design variable: %s%s", type, CR);
+		return false;
+	}
+	return true;
+}
+
+void designOptimizerAddVariable(void* optimizerPtr, const char* type, double min, double max, double initial, const char* units) {
+	DesignOptimizer* optimizer = reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+	SweepAxisType axisType;
+	if (optimizer && getDesignVariableType(type, axisType)) {
+		if (SWEEP_AXIS_CHAMBER_PRESSURE==axisType) {
+			double factor = thermo::input::Pressure::convert(1.0, thermo::input::Pressure::rawToUnit(units), thermo::input::Pressure::Pa);
+			min *= factor;
+			max *= factor;
+			initial *= factor;
+		}
+		optimizer->addVariable(axisType, min, max, initial);
+	}
+}
+
+void designOptimizerAddAltitude(void* optimizerPtr, double H, const char* altitudeUnits, double weight) {
+	DesignOptimizer* optimizer = reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+	if (optimizer) {
+		optimizer->addAltitude(thermo::input::Length::convert(H, thermo::input::Length::rawToUnit(altitudeUnits), thermo::input::Length::m), weight);
+	}
+}
+
+void designOptimizerSetVacuumWeight(void* optimizerPtr, double weight) {
+	DesignOptimizer* optimizer = reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+	if (optimizer) {
+		optimizer->setVacuumWeight(weight);
+	}
+}
+
+void designOptimizerSetTolerance(void* optimizerPtr, double tolerance, int maxEvaluations) {
+	DesignOptimizer* optimizer = reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+	if (optimizer) {
+		if (tolerance>0) {
+			optimizer->setTolerance(tolerance);
+		}
+		if (maxEvaluations>0) {
+			optimizer->setMaxEvaluations(maxEvaluations);
+		}
+	}
+}
+
+double designOptimizerRun(void* optimizerPtr, int threads, const char* IspUnits) {
+	DesignOptimizer* optimizer = reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+	if (optimizer) {
+		optimizer->setThreads(threads);
+		try {
+			return optimizer->run()*getIspFactor(IspUnits);
+		} catch (const std::exception& ex) {
+			util::Log::errorf("OPTIMIZE", "Optimization failed: %s%s", ex.what(), CR);
+		}
+	}
+	return 0;
+}
+
+double designOptimizerGetValue(void* optimizerPtr, const char* type, const char* units) {
+	DesignOptimizer* optimizer = reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+	SweepAxisType axisType;
+	if (optimizer && optimizer->getEvaluationsNo()>0 && getDesignVariableType(type, axisType)) {
+		for (size_t i=0; i<optimizer->getVariablesNo(); ++i) {
+			if (axisType==optimizer->getVariableType(i)) {
+				if (SWEEP_AXIS_CHAMBER_PRESSURE==axisType) {
+					return thermo::input::Pressure::convert(optimizer->getValue(i), thermo::input::Pressure::Pa, thermo::input::Pressure::rawToUnit(units));
+				}
+				return optimizer->getValue(i);
+			}
+		}
+	}
+	return 0;
+}
+
+int designOptimizerGetEvaluationsNo(void* optimizerPtr) {
+	DesignOptimizer* optimizer = reinterpret_cast<DesignOptimizer*>(optimizerPtr);
+	if (optimizer) {
+		return optimizer->getEvaluationsNo();
+	}
+	return 0;
+}
+
+//*****************************************************************************
+
+void* stationTableCreate(void* performancePtr, double FrMax, int stations) {
+	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
+	if (performance) {
+		NozzleStationTable* table = new NozzleStationTable(performance);
+		if (stations>0) {
+			table->build(FrMax, stations);
+		} else {
+			table->build(FrMax);
+		}
+		return table;
+	}
+	return NULL;
+}
+
+void stationTableDelete(void* tablePtr) {
+	delete reinterpret_cast<NozzleStationTable*>(tablePtr);
+}
+
+double stationTableGetValue(void* tablePtr, double condition, const char* conditionType, const char* conditionUnits, const char* name, const char* units) {
+	NozzleStationTable* table = reinterpret_cast<NozzleStationTable*>(tablePtr);
+	if (!table) {
+		return 0;
+	}
+
+	performance::frozen::NozzleSectionConditions::CONDITION_TYPE type;
+	if (0==strcmp(conditionType, "A/At")) {
+		type = performance::frozen::NozzleSectionConditions::FR;
+	} else if (0==strcmp(conditionType, "pc/p")) {
+		type = performance::frozen::NozzleSectionConditions::pp;
+	} else if (0==strcmp(conditionType, "p")) {
+		type = performance::frozen::NozzleSectionConditions::P;
+		condition = thermo::input::Pressure::convert(condition, thermo::input::Pressure::rawToUnit(conditionUnits), thermo::input::Pressure::Pa);
+	} else {
+		return 0;
+	}
+
+	NozzleStation station;
+	if (!table->get(condition, type, station)) {
+		return 0;
+	}
+
+	if (0==strcmp(name, "p")) {
+		return thermo::input::Pressure::convert(station.p, thermo::input::Pressure::Pa, thermo::input::Pressure::rawToUnit(units));
+	} else if (0==strcmp(name, "T")) {
+		return thermo::input::Temperature::convert(station.T, thermo::input::Temperature::K, thermo::input::Temperature::rawToUnit(units));
+	} else if (0==strcmp(name, "M")) {
+		return station.M;
+	} else if (0==strcmp(name, "rho")) {
+		return station.rho;
+	} else if (0==strcmp(name, "w")) {
+		return station.w;
+	} else if (0==strcmp(name, "k")) {
+		return station.k;
+	} else if (0==strcmp(name, "Is_v")) {
+		return station.Is_v*getIspFactor(units);
+	} else if (0==strcmp(name, "Is_opt")) {
+		return station.Is*getIspFactor(units);
+	}
+	return 0;
+}
+
+//*****************************************************************************
+
+void* freezingPointSearchCreate(void* performancePtr, double FrMax, int stations) {
+	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
+	if (performance) {
+		FreezingPointSearch* search = new FreezingPointSearch(performance);
+		if (stations>0) {
+			search->build(FrMax, stations);
+		} else {
+			search->build(FrMax);
+		}
+		return search;
+	}
+	return NULL;
+}
+
+void freezingPointSearchDelete(void* searchPtr) {
+	delete reinterpret_cast<FreezingPointSearch*>(searchPtr);
+}
+
+double freezingPointSearchFindByCriterion(void* searchPtr, double A, double n, double rt, const char* lengthUnits, double alpha, const char* angleUnits) {
+	FreezingPointSearch* search = reinterpret_cast<FreezingPointSearch*>(searchPtr);
+	if (search) {
+		rt = thermo::input::Length::convert(rt, thermo::input::Length::rawToUnit(lengthUnits), thermo::input::Length::m);
+		alpha = thermo::input::Angle::convert(alpha, thermo::input::Angle::rawToUnit(angleUnits), thermo::input::Angle::degrees) * M_PI / 180.;
+		return search->find(BrayCriterion(A, n, rt, alpha));
+	}
+	return 0;
+}
+
+double freezingPointSearchFindByIsp(void* searchPtr, double FrExit, double Is_v, const char* IspUnits) {
+	FreezingPointSearch* search = reinterpret_cast<FreezingPointSearch*>(searchPtr);
+	double IspFactor = getIspFactor(IspUnits);
+	if (search && IspFactor>0) {
+		return search->find(FrExit, Is_v/IspFactor);
+	}
+	return 0;
+}
+
+bool freezingPointSearchMarch(void* searchPtr, double FrFreezing, const double* Fr, int n, const char* IspUnits, double* out) {
+	FreezingPointSearch* search = reinterpret_cast<FreezingPointSearch*>(searchPtr);
+	if (!search || n<=0) {
+		return false;
+	}
+
+	std::vector<NozzleStation> stations(n);
+	bool result = search->march(FrFreezing, Fr, n, &stations[0]);
+	if (result) {
+		double IspFactor = getIspFactor(IspUnits);
+		for (int i=0; i<n; ++i) {
+			out[i] = stations[i].Is_v*IspFactor;
+		}
+	}
+	return result;
+}
+
+//*****************************************************************************
+
+int engineDeckBuild(void* dataPtr, const double* r, int nr, const double* pc, int npc, const char* pcUnits,
+		const double* throttle, int nthrottle, const double* pa, int npa, const char* paUnits, int threads, const char* path) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (!data || !path) {
+		return -1;
+	}
+
+	EngineDeckBuilder builder(data, threads);
+	if (r && nr>0) {
+		builder.setAxis(ENGINE_DECK_OF_RATIO, std::vector<double>(r, r + nr));
+	}
+	if (pc && npc>0) {
+		std::vector<double> values(npc);
+		for (int i=0; i<npc; ++i) {
+			values[i] = thermo::input::Pressure::convert(pc[i], thermo::input::Pressure::rawToUnit(pcUnits), thermo::input::Pressure::Pa);
+		}
+		builder.setAxis(ENGINE_DECK_CHAMBER_PRESSURE, values);
+	}
+	if (throttle && nthrottle>0) {
+		builder.setAxis(ENGINE_DECK_THROTTLE, std::vector<double>(throttle, throttle + nthrottle));
+	}
+	if (pa && npa>0) {
+		std::vector<double> values(npa);
+		for (int i=0; i<npa; ++i) {
+			values[i] = thermo::input::Pressure::convert(pa[i], thermo::input::Pressure::rawToUnit(paUnits), thermo::input::Pressure::Pa);
+		}
+		builder.setAxis(ENGINE_DECK_AMBIENT_PRESSURE, values);
+	}
+
+	builder.run();
+
+	return builder.write(path) ? (int)builder.getSolvedNo() : -1;
+}
+
+//*****************************************************************************
+
+void* surrogateBuilderCreate(void* dataPtr, int threads) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (data) {
+		return new SurrogateBuilder(data, threads);
+	}
+	return NULL;
+}
+
+void surrogateBuilderDelete(void* builderPtr) {
+	delete reinterpret_cast<SurrogateBuilder*>(builderPtr);
+}
+
+void surrogateBuilderAddVariable(void* builderPtr, const char* type, double min, double max, const char* units) {
+	SurrogateBuilder* builder = reinterpret_cast<SurrogateBuilder*>(builderPtr);
+	if (!builder) {
+		return;
+	}
+
+	if (0==strcmp(type, "O/F")) {
+		builder->addVariable(SWEEP_AXIS_OF_RATIO, min, max);
+	} else if (0==strcmp(type, "alpha")) {
+		builder->addVariable(SWEEP_AXIS_ALPHA, min, max);
+	} else if (0==strcmp(type, "pc")) {
+		builder->addVariable(SWEEP_AXIS_CHAMBER_PRESSURE,
+			thermo::input::Pressure::convert(min, thermo::input::Pressure::rawToUnit(units), thermo::input::Pressure::Pa),
+			thermo::input::Pressure::convert(max, thermo::input::Pressure::rawToUnit(units), thermo::input::Pressure::Pa));
+	} else if (0==strcmp(type, "A/At")) {
+		builder->addVariable(SWEEP_AXIS_AREA_RATIO, min, max);
+	} else if (0==strcmp(type, "T_ox") || 0==strcmp(type, "T_fuel")) {
+		builder->addVariable(0==strcmp(type, "T_ox") ? SWEEP_AXIS_OXIDIZER_TEMPERATURE : SWEEP_AXIS_FUEL_TEMPERATURE,
+			thermo::input::Temperature::convert(min, thermo::input::Temperature::rawToUnit(units), thermo::input::Temperature::K),
+			thermo::input::Temperature::convert(max, thermo::input::Temperature::rawToUnit(units), thermo::input::Temperature::K));
+	} else {
+		util::Log::errorf("SURROGATE", "Unknown type of surrogate variable: %s%s", type, CR);
+	}
+}
+
+void surrogateBuilderSetSamples(void* builderPtr, int training, int validation, int degree) {
+	SurrogateBuilder* builder = reinterpret_cast<SurrogateBuilder*>(builderPtr);
+	if (builder) {
+		builder->setSamples(training, validation);
+		if (degree>0) {
+			builder->setDegree(degree);
+		}
+	}
+}
+
+void* surrogateBuilderRun(void* builderPtr) {
+	SurrogateBuilder* builder = reinterpret_cast<SurrogateBuilder*>(builderPtr);
+	if (builder) {
+		SurrogateModel* model = new SurrogateModel();
+		if (builder->run(*model)) {
+			return model;
+		}
+		delete model;
+	}
+	return NULL;
+}
+
+void* surrogateRead(const char* path) {
+	SurrogateModel* model = new SurrogateModel();
+	if (path && model->read(path)) {
+		return model;
+	}
+	delete model;
+	return NULL;
+}
+
+bool surrogateWrite(void* modelPtr, const char* path, const char* variable) {
+	SurrogateModel* model = reinterpret_cast<SurrogateModel*>(modelPtr);
+	if (model && path) {
+		return model->write(path, variable);
+	}
+	return false;
+}
+
+void surrogateDelete(void* modelPtr) {
+	delete reinterpret_cast<SurrogateModel*>(modelPtr);
+}
+
+/**
+ * Returns the result of the sweep by its name; false for unknown names.
+ */
+static bool getSweepValue(const char* name, SweepValue& value) {
+	if (0==strcmp(name, "Is_v")) {
+		value = SWEEP_IS_V;
+	} else if (0==strcmp(name, "Is_opt")) {
+		value = SWEEP_IS_OPT;
+	} else if (0==strcmp(name, "Is_SL")) {
+		value = SWEEP_IS_SL;
+	} else if (0==strcmp(name, "T_c")) {
+		value = SWEEP_T_C;
+	} else if (0==strcmp(name, "O/F")) {
+		value = SWEEP_OF_RATIO;
+	} else if (0==strcmp(name, "p_e")) {
+		value = SWEEP_P_E;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+double surrogateEvaluate(void* modelPtr, const double* x, const char* name, const char* units) {
+	SurrogateModel* model = reinterpret_cast<SurrogateModel*>(modelPtr);
+	SweepValue value;
+	if (!model || !x || !getSweepValue(name, value)) {
+		return 0;
+	}
+
+	double result = model->evaluate(x, value);
+	switch (value) {
+	case SWEEP_IS_V:
+	case SWEEP_IS_OPT:
+	case SWEEP_IS_SL:
+		return result*getIspFactor(units);
+	case SWEEP_T_C:
+		return thermo::input::Temperature::convert(result, thermo::input::Temperature::K, thermo::input::Temperature::rawToUnit(units));
+	case SWEEP_P_E:
+		return thermo::input::Pressure::convert(result, thermo::input::Pressure::Pa, thermo::input::Pressure::rawToUnit(units));
+	default:
+		return result;
+	}
+}
+
+double surrogateGetError(void* modelPtr, const char* name) {
+	SurrogateModel* model = reinterpret_cast<SurrogateModel*>(modelPtr);
+	SweepValue value;
+	if (model && getSweepValue(name, value)) {
+		return model->getError(value);
+	}
+	return 0;
+}
+
+//*****************************************************************************
+
+void* monteCarloCreate(void* dataPtr, int threads) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (data) {
+		return new MonteCarloAnalysis(data, threads);
+	}
+	return NULL;
+}
+
+void monteCarloDelete(void* analysisPtr) {
+	delete reinterpret_cast<MonteCarloAnalysis*>(analysisPtr);
+}
+
+void monteCarloAddVariable(void* analysisPtr, const char* type, const char* distribution, double a, double b, double c, const char* units) {
+	MonteCarloAnalysis* analysis = reinterpret_cast<MonteCarloAnalysis*>(analysisPtr);
+	if (!analysis) {
+		return;
+	}
+
+	MonteCarloParameter parameter;
+	if (0==strcmp(type, "O/F")) {
+		parameter = MONTE_CARLO_OF_RATIO;
+	} else if (0==strcmp(type, "alpha")) {
+		parameter = MONTE_CARLO_ALPHA;
+	} else if (0==strcmp(type, "pc")) {
+		parameter = MONTE_CARLO_CHAMBER_PRESSURE;
+	} else if (0==strcmp(type, "A/At")) {
+		parameter = MONTE_CARLO_AREA_RATIO;
+	} else if (0==strcmp(type, "T_ox")) {
+		parameter = MONTE_CARLO_OXIDIZER_TEMPERATURE;
+	} else if (0==strcmp(type, "T_fuel")) {
+		parameter = MONTE_CARLO_FUEL_TEMPERATURE;
+	} else if (0==strcmp(type, "eta_reaction")) {
+		parameter = MONTE_CARLO_REACTION_EFFICIENCY;
+	} else if (0==strcmp(type, "eta_nozzle")) {
+		parameter = MONTE_CARLO_NOZZLE_EFFICIENCY;
+	} else if (0==strcmp(type, "eta_cycle")) {
+		parameter = MONTE_CARLO_CYCLE_EFFICIENCY;
+	} else {
+		util::Log::errorf("MONTE_CARLO", "Unknown type of Monte Carlo variable: %s%s", type, CR);
+		return;
+	}
+
+	// Values of normal distribution are the mean and the deviation, which is converted as the difference
+	bool normal = 0==strcmp(distribution, "normal");
+	double values[] = {a, normal ? a + b : b, c};
+	int converted = normal ? 2 : 3;
+	for (int i=0; i<converted; ++i) {
+		if (MONTE_CARLO_CHAMBER_PRESSURE==parameter) {
+			values[i] = thermo::input::Pressure::convert(values[i], thermo::input::Pressure::rawToUnit(units), thermo::input::Pressure::Pa);
+		} else
+		if (MONTE_CARLO_OXIDIZER_TEMPERATURE==parameter || MONTE_CARLO_FUEL_TEMPERATURE==parameter) {
+			values[i] = thermo::input::Temperature::convert(values[i], thermo::input::Temperature::rawToUnit(units), thermo::input::Temperature::K);
+		}
+	}
+
+	if (normal) {
+		analysis->addNormal(parameter, values[0], values[1] - values[0], c);
+	} else if (0==strcmp(distribution, "uniform")) {
+		analysis->addUniform(parameter, values[0], values[1]);
+	} else if (0==strcmp(distribution, "triangular")) {
+		analysis->addTriangular(parameter, values[0], values[1], values[2]);
+	} else {
+		util::Log::errorf("MONTE_CARLO", "Unknown distribution of Monte Carlo variable: %s%s", distribution, CR);
+	}
+}
+
+void monteCarloSetOptions(void* analysisPtr, double pa, const char* paUnits, unsigned int seed) {
+	MonteCarloAnalysis* analysis = reinterpret_cast<MonteCarloAnalysis*>(analysisPtr);
+	if (analysis) {
+		analysis->setAmbientPressure(thermo::input::Pressure::convert(pa, thermo::input::Pressure::rawToUnit(paUnits), thermo::input::Pressure::Pa));
+		analysis->setSeed(seed);
+	}
+}
+
+int monteCarloRun(void* analysisPtr, int samples) {
+	MonteCarloAnalysis* analysis = reinterpret_cast<MonteCarloAnalysis*>(analysisPtr);
+	if (analysis && samples>0) {
+		return (int)analysis->run((size_t)samples);
+	}
+	return 0;
+}
+
+static bool getMonteCarloOutput(const char* name, MonteCarloOutput& output) {
+	if (0==strcmp(name, "Is")) {
+		output = MONTE_CARLO_IS;
+	} else if (0==strcmp(name, "T_c")) {
+		output = MONTE_CARLO_T_C;
+	} else if (0==strcmp(name, "mdot")) {
+		output = MONTE_CARLO_MDOT;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static double convertMonteCarloOutput(MonteCarloOutput output, double value, const char* units) {
+	switch (output) {
+	case MONTE_CARLO_IS:
+		return value*getIspFactor(units);
+	case MONTE_CARLO_T_C:
+		return thermo::input::Temperature::convert(value, thermo::input::Temperature::K, thermo::input::Temperature::rawToUnit(units));
+	case MONTE_CARLO_MDOT:
+		return thermo::input::MassFlowRate::convert(value, thermo::input::MassFlowRate::kg_over_s, thermo::input::MassFlowRate::rawToUnit(units));
+	default:
+		return value;
+	}
+}
+
+double monteCarloGetStatistic(void* analysisPtr, const char* name, const char* statistic, const char* units) {
+	MonteCarloAnalysis* analysis = reinterpret_cast<MonteCarloAnalysis*>(analysisPtr);
+	MonteCarloOutput output;
+	if (!analysis || !getMonteCarloOutput(name, output)) {
+		return 0;
+	}
+
+	const StreamingStatistics& statistics = analysis->getStatistics(output);
+	if (0==strcmp(statistic, "mean")) {
+		return convertMonteCarloOutput(output, statistics.getMean(), units);
+	} else if (0==strcmp(statistic, "stddev")) {
+		// Deviation is converted as the difference
+		return convertMonteCarloOutput(output, statistics.getMean() + statistics.getStdDev(), units) - convertMonteCarloOutput(output, statistics.getMean(), units);
+	} else if (0==strcmp(statistic, "min")) {
+		return convertMonteCarloOutput(output, statistics.getMin(), units);
+	} else if (0==strcmp(statistic, "max")) {
+		return convertMonteCarloOutput(output, statistics.getMax(), units);
+	} else if ('p'==statistic[0]) {
+		return convertMonteCarloOutput(output, statistics.getPercentileAt(atof(statistic + 1)/100), units);
+	}
+
+	util::Log::errorf("MONTE_CARLO", "Unknown statistic: %s%s", statistic, CR);
+	return 0;
+}
+
+int monteCarloGetHistogram(void* analysisPtr, const char* name, const char* units, double* edges, int* counts, int size) {
+	MonteCarloAnalysis* analysis = reinterpret_cast<MonteCarloAnalysis*>(analysisPtr);
+	MonteCarloOutput output;
+	if (!analysis || !getMonteCarloOutput(name, output)) {
+		return 0;
+	}
+
+	const StreamingStatistics& statistics = analysis->getStatistics(output);
+	int n = size<(int)statistics.getBinsNo() ? size : (int)statistics.getBinsNo();
+	for (int i=0; i<n; ++i) {
+		if (edges) {
+			edges[i] = convertMonteCarloOutput(output, statistics.getBinEdge(i), units);
+		}
+		if (counts) {
+			counts[i] = (int)statistics.getBin(i);
+		}
+	}
+	if (edges && n>0) {
+		edges[n] = convertMonteCarloOutput(output, statistics.getBinEdge(n), units);
+	}
+	return (int)statistics.getBinsNo();
+}
+
+//*****************************************************************************
+
+void* sensitivityCreate(void* dataPtr, int threads) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (data) {
+		return new SensitivityAnalysis(data, threads);
+	}
+	return NULL;
+}
+
+void sensitivityDelete(void* analysisPtr) {
+	delete reinterpret_cast<SensitivityAnalysis*>(analysisPtr);
+}
+
+void sensitivityAddInput(void* analysisPtr, const char* type, double step) {
+	SensitivityAnalysis* analysis = reinterpret_cast<SensitivityAnalysis*>(analysisPtr);
+	if (!analysis) {
+		return;
+	}
+
+	SweepAxisType input;
+	if (0==strcmp(type, "O/F")) {
+		input = SWEEP_AXIS_OF_RATIO;
+	} else if (0==strcmp(type, "alpha")) {
+		input = SWEEP_AXIS_ALPHA;
+	} else if (0==strcmp(type, "pc")) {
+		input = SWEEP_AXIS_CHAMBER_PRESSURE;
+	} else if (0==strcmp(type, "A/At")) {
+		input = SWEEP_AXIS_AREA_RATIO;
+	} else if (0==strcmp(type, "T_ox")) {
+		input = SWEEP_AXIS_OXIDIZER_TEMPERATURE;
+	} else if (0==strcmp(type, "T_fuel")) {
+		input = SWEEP_AXIS_FUEL_TEMPERATURE;
+	} else {
+		util::Log::errorf("SENSITIVITY", "Unknown type of sensitivity input: %s%s", type, CR);
+		return;
+	}
+
+	if (step>0) {
+		analysis->addInput(input, step);
+	} else {
+		analysis->addInput(input);
+	}
+}
+
+bool sensitivityRun(void* analysisPtr) {
+	SensitivityAnalysis* analysis = reinterpret_cast<SensitivityAnalysis*>(analysisPtr);
+	if (analysis) {
+		return analysis->run();
+	}
+	return false;
+}
+
+double sensitivityGetDerivative(void* analysisPtr, const char* name, int input) {
+	SensitivityAnalysis* analysis = reinterpret_cast<SensitivityAnalysis*>(analysisPtr);
+	SweepValue value;
+	if (!analysis || input<0 || input>=(int)analysis->getInputsNo() || !getSweepValue(name, value)) {
+		return 0;
+	}
+	return analysis->get(value, (size_t)input);
+}
+
+bool sensitivityGetJacobian(void* analysisPtr, const char** names, int n, double* jacobian) {
+	SensitivityAnalysis* analysis = reinterpret_cast<SensitivityAnalysis*>(analysisPtr);
+	if (!analysis || !names || !jacobian) {
+		return false;
+	}
+
+	std::vector<SweepValue> outputs(n>0 ? n : 0);
+	for (int i=0; i<n; ++i) {
+		if (!getSweepValue(names[i], outputs[i])) {
+			util::Log::errorf("SENSITIVITY", "Unknown result: %s%s", names[i], CR);
+			return false;
+		}
+	}
+
+	std::vector<double> values;
+	analysis->getJacobian(outputs, values);
+	for (size_t i=0; i<values.size(); ++i) {
+		jacobian[i] = values[i];
+	}
+	return true;
+}
+
+//*****************************************************************************
+
+int mocDesignSweepRun(void* dataPtr, int n, const int* modes, const double* Fr, const double* Le_bar, const double* R1, const double* Rn,
+		const double* Tw_bar, int threads, double* Le, double* Te, double* Tn_max, const char* lengthUnits, const char* angleUnits) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (!data || n<=0 || !modes || !R1 || !Rn) {
+		return 0;
+	}
+
+	MocDesignSweep sweep(data, threads);
+	for (int i=0; i<n; ++i) {
+		MocDesignCandidate candidate;
+		candidate.mode = (MocDesignMode)modes[i];
+		candidate.Fr = Fr ? Fr[i] : 0;
+		candidate.Le_bar = Le_bar ? Le_bar[i] : 0;
+		candidate.R1 = R1[i];
+		candidate.Rn = Rn[i];
+		candidate.Tw_bar = Tw_bar ? Tw_bar[i] : 0.2;
+		sweep.addCandidate(candidate);
+	}
+
+	int designed = (int)sweep.run();
+
+	for (int i=0; i<n; ++i) {
+		if (Le) {
+			Le[i] = thermo::input::Length::convert(sweep.getLe(i), thermo::input::Length::m, thermo::input::Length::rawToUnit(lengthUnits));
+		}
+		if (Te) {
+			Te[i] = thermo::input::Angle::convert(sweep.getTe(i)*180./M_PI, thermo::input::Angle::degrees, thermo::input::Angle::rawToUnit(angleUnits));
+		}
+		if (Tn_max) {
+			Tn_max[i] = thermo::input::Angle::convert(sweep.getTn_max(i)*180./M_PI, thermo::input::Angle::degrees, thermo::input::Angle::rawToUnit(angleUnits));
+		}
+	}
+
+	return designed;
+}
+
+//*****************************************************************************
+
+void* pipelineCreate(void* dataPtr, bool applyCorrectionFactors) {
+	thermo::input::ConfigFile* data = reinterpret_cast<thermo::input::ConfigFile*>(dataPtr);
+	if (data) {
+		return new EnginePipeline(data, applyCorrectionFactors);
+	}
+	return NULL;
+}
+
+void pipelineDelete(void* pipelinePtr) {
+	delete reinterpret_cast<EnginePipeline*>(pipelinePtr);
+}
+
+void pipelineInvalidate(void* pipelinePtr, const char* stage) {
+	EnginePipeline* pipeline = reinterpret_cast<EnginePipeline*>(pipelinePtr);
+	if (!pipeline) {
+		return;
+	}
+
+	if (0==strcmp(stage, "performance")) {
+		pipeline->invalidate(PIPELINE_PERFORMANCE);
+	} else if (0==strcmp(stage, "correction_factors")) {
+		pipeline->invalidate(PIPELINE_CORRECTION_FACTORS);
+	} else if (0==strcmp(stage, "chamber")) {
+		pipeline->invalidate(PIPELINE_CHAMBER);
+	} else if (0==strcmp(stage, "nozzle")) {
+		pipeline->invalidate(PIPELINE_NOZZLE);
+	} else {
+		util::Log::errorf("PIPELINE", "Unknown pipeline stage: %s%s", stage, CR);
+	}
+}
+
+int pipelineUpdate(void* pipelinePtr, bool optimizePropellant) {
+	EnginePipeline* pipeline = reinterpret_cast<EnginePipeline*>(pipelinePtr);
+	if (!pipeline) {
+		return -1;
+	}
+
+	try {
+		pipeline->setOptimizePropellant(optimizePropellant);
+		return pipeline->update();
+	} catch (const std::exception& e) {
+		util::Log::errorf("PIPELINE", "Could not update the pipeline: %s%s", e.what(), CR);
+	}
+	return -1;
+}
+
+void* pipelineGetPerformance(void* pipelinePtr) {
+	EnginePipeline* pipeline = reinterpret_cast<EnginePipeline*>(pipelinePtr);
+	return pipeline ? pipeline->getPerformance() : NULL;
+}
+
+void* pipelineGetChamber(void* pipelinePtr) {
+	EnginePipeline* pipeline = reinterpret_cast<EnginePipeline*>(pipelinePtr);
+	return pipeline ? pipeline->getChamber() : NULL;
+}
+
+void* pipelineGetNozzle(void* pipelinePtr) {
+	EnginePipeline* pipeline = reinterpret_cast<EnginePipeline*>(pipelinePtr);
+	return pipeline ? pipeline->getNozzle() : NULL;
+}
+
+//*****************************************************************************
+
+int nozzleOptimizeContour(void* performancePtr, bool applyCorrectionFactors, int n, const int* types,
+		const double* l, const double* tn, const double* te, const double* Le_bar, const double* H, int altitudesNo,
+		int threads, double* Le, double* objective, int* front, const char* lengthUnits, const char* angleUnits, const char* IspUnits) {
+
+	performance::TheoreticalPerformance* performance = reinterpret_cast<performance::TheoreticalPerformance*>(performancePtr);
+	if (!performance || n<=0 || !types || !Le || !objective || !front) {
+		return -1;
+	}
+
+	NozzleContourOptimizer optimizer(performance->getData(), threads);
+	optimizer.setCorrectionFactors(applyCorrectionFactors);
+	for (int i=0; i<altitudesNo && H; ++i) {
+		optimizer.addAltitude(H[i], 1.);
+	}
+
+	for (int i=0; i<n; ++i) {
+		NozzleContourCandidate c;
+		c.type = NOZZLE_CONTOUR_MOC==types[i] ? NOZZLE_CONTOUR_MOC : NOZZLE_CONTOUR_PARABOLIC;
+		c.l = l ? l[i] : 0.8;
+		c.tn = tn ? thermo::input::Angle::convert(tn[i], thermo::input::Angle::rawToUnit(angleUnits), thermo::input::Angle::degrees) : 0;
+		c.te = te ? thermo::input::Angle::convert(te[i], thermo::input::Angle::rawToUnit(angleUnits), thermo::input::Angle::degrees) : 0;
+		c.Le_bar = Le_bar ? Le_bar[i] : 0;
+		optimizer.addCandidate(c);
+	}
+
+	optimizer.run();
+
+	double IspFactor = getIspFactor(IspUnits);
+
+	for (int i=0; i<n; ++i) {
+		const NozzleContourResult& r = optimizer.getResult(i);
+		Le[i] = r.solved ? thermo::input::Length::convert(r.Le, thermo::input::Length::m, thermo::input::Length::rawToUnit(lengthUnits)) : r.Le;
+		objective[i] = r.objective*IspFactor;
+	}
+
+	std::vector<size_t> pareto;
+	optimizer.getParetoFront(pareto);
+	for (size_t i=0; i<pareto.size(); ++i) {
+		front[i] = (int)pareto[i];
+	}
+
+	return (int)pareto.size();
+}
 
 //*****************************************************************************
 
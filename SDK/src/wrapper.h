@@ -11,6 +11,16 @@ extern "C" {
 __declspec(dllexport)
 	void initialize(bool consoleOutput);
 
+/**
+ * Same as initialize(), with options of thermodynamics database initialization:
+ *  1 - load species on demand (see THERMO_DATABASE_OPTION_LAZY)
+ *
+ * With species loaded on demand, performanceCreate() may reload the thermodynamics database,
+ * so it must not be called while performance is being solved on other threads.
+ */
+__declspec(dllexport)
+	void initializeWithOptions(bool consoleOutput, unsigned int databaseOptions);
+
 __declspec(dllexport)
 	void finalize();
 
@@ -412,6 +422,28 @@ __declspec(dllexport)
 __declspec(dllexport)
 	double performanceGetDeliveredIspH(void* performancePtr, const char* IspUnits, double H, const char* altitudeUnits, double phi);
 
+/**
+ * Calculates delivered Isp at each of given ambient pressures.
+ * Units, correction factor and nozzle exit conditions are evaluated once for the whole array;
+ * nozzle section with flow separation is solved only for the pressures above the critical one.
+ *
+ * @param performancePtr pointer to performance object
+ * @param IspUnits return Isp using given units: "m/s", "ft/s" or "s"
+ * @param pa array of ambient pressures in defined units
+ * @param n size of arrays pa and out
+ * @param pressureUnits units of ambient pressure
+ * @param phi correction factor; if phi==0, use correction factors defined in configuration file, or estimated factor, if not defined in configuration file.
+ * @param out array to receive Isp values
+ */
+__declspec(dllexport)
+	void performanceGetDeliveredIspArray(void* performancePtr, const char* IspUnits, const double* pa, int n, const char* pressureUnits, double phi, double* out);
+
+/**
+ * Same as performanceGetDeliveredIspArray(), for the array of altitudes of the standard atmosphere.
+ */
+__declspec(dllexport)
+	void performanceGetDeliveredIspHArray(void* performancePtr, const char* IspUnits, const double* H, int n, const char* altitudeUnits, double phi, double* out);
+
 __declspec(dllexport)
 	double performanceGetIdealIsp(void* performancePtr, const char* IspUnits, double pa, const char* units);
 
@@ -458,6 +490,620 @@ __declspec(dllexport)
 __declspec(dllexport)
 	double nozzleGetLength(void* nozzlePtr, const char* units);
 
+/**
+ * Fills the wall angles of the MOC nozzle at n values of the contour parameter (0 - throat, 1 - exit).
+ *
+ * @param theta array of n wall angles
+ * @return number of the angles filled; 0 if the nozzle is not MOC one
+ */
+__declspec(dllexport)
+	int nozzleGetWallAngles(void* nozzlePtr, const double* t, int n, double* theta, const char* units);
+
+/**
+ * Returns the maximum wall angle of the MOC nozzle (see findMocMaxWallAngle()); 0 if the nozzle is not MOC one.
+ */
+__declspec(dllexport)
+	double nozzleGetMaxWallAngle(void* nozzlePtr, const char* units);
+
+//*****************************************************************************
+
+/**
+ * Creates the table of NASA polynomials of given species (see ThermoPolynomialTable).
+ * Requires the database initialized with option 1 (see initializeWithOptions()); returns NULL otherwise.
+ *
+ * Results of thermoTableEvaluate() are in the order of given names, excluding repeated names and species without
+ * temperature intervals (see thermoTableGetName()).
+ *
+ * @param names array of species names
+ * @param size number of species
+ * @return pointer to the table, or NULL if any of the species could not be found
+ */
+__declspec(dllexport)
+	void* thermoTableCreate(const char** names, int size);
+
+__declspec(dllexport)
+	void thermoTableDelete(void* tablePtr);
+
+__declspec(dllexport)
+	int thermoTableGetSize(void* tablePtr);
+
+/**
+ * @return name of the species in the order of results of thermoTableEvaluate()
+ */
+__declspec(dllexport)
+	const char* thermoTableGetName(void* tablePtr, int i);
+
+/**
+ * Evaluates dimensionless Cp/R, H/(R*T) and S/R of all the species of the table.
+ * The same table must not be evaluated on several threads at once.
+ *
+ * @param T temperature in defined units
+ * @param cp, h, s arrays of thermoTableGetSize() elements; any of them may be NULL
+ */
+__declspec(dllexport)
+	void thermoTableEvaluate(void* tablePtr, double T, const char* temperatureUnits, double* cp, double* h, double* s);
+
+//*****************************************************************************
+
+/**
+ * Creates the parametric sweep over the configuration (see ParametricSweep).
+ *
+ * @param dataPtr pointer to configuration file object; must exist as long as the sweep is used
+ */
+__declspec(dllexport)
+	void* sweepCreate(void* dataPtr);
+
+__declspec(dllexport)
+	void sweepDelete(void* sweepPtr);
+
+/**
+ * Adds the axis of the grid.
+ *
+ * @param type "O/F", "alpha", "pc" (chamber pressure) or "A/At" (nozzle exit area ratio)
+ * @param values array of values
+ * @param size number of values
+ * @param units units of pressure values; ignored for other axes
+ */
+__declspec(dllexport)
+	void sweepAddAxis(void* sweepPtr, const char* type, const double* values, int size, const char* units);
+
+/**
+ * Solves all the points of the grid.
+ *
+ * @param threads number of threads; 0 to use all hardware threads
+ */
+__declspec(dllexport)
+	void sweepRun(void* sweepPtr, int threads);
+
+/**
+ * Enables or disables reuse of the combustion chamber solution for the points which differ only in area ratio.
+ * Enabled by default.
+ */
+__declspec(dllexport)
+	void sweepSetReuseChamber(void* sweepPtr, bool reuseChamber);
+
+/**
+ * @return number of full solutions avoided by chamber reuse in the last sweepRun()
+ */
+__declspec(dllexport)
+	int sweepGetSolvesSaved(void* sweepPtr);
+
+__declspec(dllexport)
+	int sweepGetPointsNo(void* sweepPtr);
+
+/**
+ * @return index of the value at given axis for the point
+ */
+__declspec(dllexport)
+	int sweepGetIndex(void* sweepPtr, int point, int axis);
+
+__declspec(dllexport)
+	bool sweepIsSolved(void* sweepPtr, int point);
+
+/**
+ * @param name "Is_v", "Is_opt", "Is_SL" (units "m/s", "ft/s" or "s"), "T_c" (temperature units), "O/F", "p_e" (pressure units)
+ * @return result for the point
+ */
+__declspec(dllexport)
+	double sweepGetValue(void* sweepPtr, int point, const char* name, const char* units);
+
+//*****************************************************************************
+
+/**
+ * Creates the table of nozzle flow separation (see FlowSeparationTable): solves the flow separation once
+ * for ambient pressures from the critical one to paMax, so that delivered Isp is interpolated afterwards.
+ *
+ * @param performancePtr pointer to solved performance object; must exist as long as the table is used
+ * @param paMax maximum ambient pressure
+ * @param pressureUnits units of maximum ambient pressure
+ * @param tolerance maximum relative error of interpolated Isp; if tolerance<=0, use default value
+ */
+__declspec(dllexport)
+	void* flowSeparationTableCreate(void* performancePtr, double paMax, const char* pressureUnits, double tolerance);
+
+__declspec(dllexport)
+	void flowSeparationTableDelete(void* tablePtr);
+
+/**
+ * Same as performanceGetDeliveredIsp(), with flow separation interpolated from the table.
+ */
+__declspec(dllexport)
+	double flowSeparationTableGetDeliveredIsp(void* tablePtr, const char* IspUnits, double pa, const char* pressureUnits, double phi);
+
+/**
+ * @return estimated maximum relative error of interpolated Isp
+ */
+__declspec(dllexport)
+	double flowSeparationTableGetErrorBound(void* tablePtr);
+
+//*****************************************************************************
+
+/**
+ * Creates the performance curve (see PerformanceCurve) of solved problem: a copy of the nozzle exit coefficients
+ * and of the flow separation table, which doesn't need the performance object to be evaluated.
+ *
+ * @param performancePtr pointer to solved performance object
+ * @param phi performance correction factor; if phi<=0, use CorrectionFactors
+ * @param mdot mass flow rate, kg/s; used for thrust only
+ * @param paMax maximum ambient pressure of the flow separation table; if paMax<=0, the flow separation is not considered
+ * @param pressureUnits units of maximum ambient pressure
+ */
+__declspec(dllexport)
+	void* performanceCurveCreate(void* performancePtr, double phi, double mdot, double paMax, const char* pressureUnits);
+
+__declspec(dllexport)
+	void performanceCurveDelete(void* curvePtr);
+
+/**
+ * Calculates delivered Isp and thrust (N) at n ambient pressures.
+ *
+ * @param throttle array of n throttle values, or NULL for throttle value 1
+ * @param Is array of n values of delivered Isp in given units
+ * @param thrust array of n values, or NULL
+ */
+__declspec(dllexport)
+	void performanceCurveEvaluate(void* curvePtr, const char* IspUnits, const double* pa, const double* throttle, int n, const char* pressureUnits, double* Is, double* thrust);
+
+//*****************************************************************************
+
+/**
+ * Creates the throttle schedule (see ThrottleSchedule) of solved problem.
+ *
+ * @param performancePtr pointer to solved performance object; must exist as long as the schedule is used
+ */
+__declspec(dllexport)
+	void* throttleScheduleCreate(void* performancePtr);
+
+__declspec(dllexport)
+	void throttleScheduleDelete(void* schedulePtr);
+
+/**
+ * Returns pointer to the performance object solved at given throttle value, which can be used with performance* functions
+ * until the next call. The problem is re-solved only if the value has changed.
+ */
+__declspec(dllexport)
+	void* throttleScheduleThrottle(void* schedulePtr, double value);
+
+/**
+ * Calculates delivered Isp (without flow separation) at n throttle values.
+ *
+ * @param correctionFactors if true, apply performance correction factor of each point
+ * @param out array of n values of delivered Isp in given units
+ * @return number of the problems solved
+ */
+__declspec(dllexport)
+	int throttleScheduleGetDeliveredIsp(void* schedulePtr, const double* values, int n, const char* IspUnits, double pa, const char* pressureUnits, bool correctionFactors, double* out);
+
+//*****************************************************************************
+
+/**
+ * Creates the optimizer of design parameters (see DesignOptimizer) of the engine.
+ *
+ * @param dataPtr pointer to configuration; must exist as long as the optimizer is used
+ */
+__declspec(dllexport)
+	void* designOptimizerCreate(void* dataPtr);
+
+__declspec(dllexport)
+	void designOptimizerDelete(void* optimizerPtr);
+
+/**
+ * Adds the variable.
+ *
+ * @param type "O/F", "pc" or "A/At"
+ * @param units units of chamber pressure
+ */
+__declspec(dllexport)
+	void designOptimizerAddVariable(void* optimizerPtr, const char* type, double min, double max, double initial, const char* units);
+
+/**
+ * Adds the altitude of the mission with the weight of its Isp in the objective.
+ */
+__declspec(dllexport)
+	void designOptimizerAddAltitude(void* optimizerPtr, double H, const char* altitudeUnits, double weight);
+
+__declspec(dllexport)
+	void designOptimizerSetVacuumWeight(void* optimizerPtr, double weight);
+
+/**
+ * @param tolerance size of the simplex relative to the ranges of the variables at which the search is finished
+ * @param maxEvaluations maximum number of solved points
+ */
+__declspec(dllexport)
+	void designOptimizerSetTolerance(void* optimizerPtr, double tolerance, int maxEvaluations);
+
+/**
+ * Finds the optimal values of the variables and sets them in the configuration.
+ *
+ * @param threads number of threads; 0 to use all hardware threads
+ * @return maximum weighted Isp in given units, or 0 if the optimization failed
+ */
+__declspec(dllexport)
+	double designOptimizerRun(void* optimizerPtr, int threads, const char* IspUnits);
+
+/**
+ * Returns the optimal value of the variable of given type ("O/F", "pc" or "A/At").
+ */
+__declspec(dllexport)
+	double designOptimizerGetValue(void* optimizerPtr, const char* type, const char* units);
+
+__declspec(dllexport)
+	int designOptimizerGetEvaluationsNo(void* optimizerPtr);
+
+//*****************************************************************************
+
+/**
+ * Creates the table of nozzle stations (see NozzleStationTable): solves the sections of the supersonic part
+ * of the nozzle once, so that the sections are interpolated afterwards.
+ *
+ * @param performancePtr pointer to solved performance object; must exist as long as the table is used
+ * @param FrMax maximum area ratio A/At
+ * @param stations number of stations; if stations<=0, use default value
+ */
+__declspec(dllexport)
+	void* stationTableCreate(void* performancePtr, double FrMax, int stations);
+
+__declspec(dllexport)
+	void stationTableDelete(void* tablePtr);
+
+/**
+ * Returns interpolated parameter of the nozzle section.
+ *
+ * @param condition value of the condition
+ * @param conditionType "A/At", "pc/p" or "p"
+ * @param conditionUnits units of pressure if conditionType is "p"
+ * @param name "p" (pressure units), "T" (temperature units), "M", "rho" (kg/m3), "w" (m/s), "k", "Is_v" or "Is_opt" (units "m/s", "ft/s" or "s")
+ * @return value, or 0 if the condition is out of the range of the table
+ */
+__declspec(dllexport)
+	double stationTableGetValue(void* tablePtr, double condition, const char* conditionType, const char* conditionUnits, const char* name, const char* units);
+
+//*****************************************************************************
+
+/**
+ * Creates the search of the freezing point (see FreezingPointSearch) of solved problem: solves the table
+ * of shifting equilibrium stations once, so that the freezing point is found without further solutions.
+ * The found area ratio can be set with configFileNozzleFlowOptionsSetFreezingConditions() (type 0).
+ *
+ * @param performancePtr pointer to solved performance object; must exist as long as the search is used
+ * @param FrMax maximum area ratio A/At
+ * @param stations number of stations; if stations<=0, use default value
+ */
+__declspec(dllexport)
+	void* freezingPointSearchCreate(void* performancePtr, double FrMax, int stations);
+
+__declspec(dllexport)
+	void freezingPointSearchDelete(void* searchPtr);
+
+/**
+ * Finds the area ratio where the flow freezes by the Bray-type criterion for the conical nozzle.
+ *
+ * @param A rate constant of three-body recombination k_r=A*T^-n, m6/(kg2*s)*K^n
+ * @param n temperature exponent of the rate constant
+ * @param rt throat radius
+ * @param alpha half-angle of the nozzle
+ * @return area ratio, or 0 if the flow doesn't freeze within the table
+ */
+__declspec(dllexport)
+	double freezingPointSearchFindByCriterion(void* searchPtr, double A, double n, double rt, const char* lengthUnits, double alpha, const char* angleUnits);
+
+/**
+ * Finds the area ratio where the flow has to freeze to get target vacuum Isp at given exit area ratio.
+ *
+ * @return area ratio, or 0 if the target can't be reached
+ */
+__declspec(dllexport)
+	double freezingPointSearchFindByIsp(void* searchPtr, double FrExit, double Is_v, const char* IspUnits);
+
+/**
+ * Calculates vacuum Isp at n exit area ratios with the flow frozen at FrFreezing.
+ *
+ * @param out array of n values of vacuum Isp in given units
+ * @return false if the freezing point is out of the range of the table
+ */
+__declspec(dllexport)
+	bool freezingPointSearchMarch(void* searchPtr, double FrFreezing, const double* Fr, int n, const char* IspUnits, double* out);
+
+//*****************************************************************************
+
+/**
+ * Builds the engine deck (see EngineDeckBuilder) on the grid of O/F ratio, chamber pressure, throttle value
+ * and ambient pressure, and writes it to the file read by EngineDeck (engine_deck_reader.hpp).
+ * The axes with no values (NULL or n==0) get the single value of the configuration (O/F ratio, chamber pressure),
+ * 1 (throttle value) or 0 (ambient pressure).
+ *
+ * @param dataPtr pointer to configuration
+ * @param threads number of threads; 0 to use all hardware threads
+ * @return number of the pairs of O/F ratio and chamber pressure solved, or -1 if the file could not be written
+ */
+__declspec(dllexport)
+	int engineDeckBuild(void* dataPtr, const double* r, int nr, const double* pc, int npc, const char* pcUnits,
+			const double* throttle, int nthrottle, const double* pa, int npa, const char* paUnits, int threads, const char* path);
+
+//*****************************************************************************
+
+/**
+ * Creates the builder of the surrogate model (see SurrogateBuilder) of the engine.
+ *
+ * @param dataPtr pointer to configuration; must exist as long as the builder is used
+ * @param threads number of threads; 0 to use all hardware threads
+ */
+__declspec(dllexport)
+	void* surrogateBuilderCreate(void* dataPtr, int threads);
+
+__declspec(dllexport)
+	void surrogateBuilderDelete(void* builderPtr);
+
+/**
+ * Adds the variable with its range.
+ *
+ * @param type "O/F", "alpha", "pc", "A/At", "T_ox" (oxidizer temperature) or "T_fuel" (fuel temperature)
+ * @param units units of pressure or temperature
+ */
+__declspec(dllexport)
+	void surrogateBuilderAddVariable(void* builderPtr, const char* type, double min, double max, const char* units);
+
+/**
+ * @param training number of training points; if 0, use default value
+ * @param validation number of validation points; if 0, use default value
+ * @param degree maximum degree of the polynomial; if 0, use default value
+ */
+__declspec(dllexport)
+	void surrogateBuilderSetSamples(void* builderPtr, int training, int validation, int degree);
+
+/**
+ * Solves the points and fits the model.
+ *
+ * @return pointer to the model, which must be deleted by surrogateDelete(), or NULL if the model could not be fitted
+ */
+__declspec(dllexport)
+	void* surrogateBuilderRun(void* builderPtr);
+
+/**
+ * Reads the model written by surrogateWrite().
+ *
+ * @return pointer to the model, or NULL if the file could not be read
+ */
+__declspec(dllexport)
+	void* surrogateRead(const char* path);
+
+/**
+ * Writes the model as JSON.
+ *
+ * @param variable if not NULL, the model is written as JavaScript variable, which can be loaded by the scripts (see Scripts/surrogate.js)
+ */
+__declspec(dllexport)
+	bool surrogateWrite(void* modelPtr, const char* path, const char* variable);
+
+__declspec(dllexport)
+	void surrogateDelete(void* modelPtr);
+
+/**
+ * Evaluates the result of the model.
+ *
+ * @param x array of the values of the variables in the order they have been added; pressure in Pa, temperature in K
+ * @param name "Is_v", "Is_opt", "Is_SL" (units "m/s", "ft/s" or "s"), "T_c" (temperature units), "O/F", "p_e" (pressure units)
+ */
+__declspec(dllexport)
+	double surrogateEvaluate(void* modelPtr, const double* x, const char* name, const char* units);
+
+/**
+ * Returns maximum validation error of the result (see surrogateEvaluate()), relative to its maximum absolute value.
+ */
+__declspec(dllexport)
+	double surrogateGetError(void* modelPtr, const char* name);
+
+//*****************************************************************************
+
+/**
+ * Creates the Monte Carlo analysis (see MonteCarloAnalysis) of the engine.
+ *
+ * @param dataPtr pointer to configuration; must exist as long as the analysis is used
+ * @param threads number of threads; 0 to use all hardware threads
+ */
+__declspec(dllexport)
+	void* monteCarloCreate(void* dataPtr, int threads);
+
+__declspec(dllexport)
+	void monteCarloDelete(void* analysisPtr);
+
+/**
+ * Adds the uncertain parameter.
+ *
+ * @param type "O/F", "alpha", "pc", "A/At", "T_ox" (oxidizer temperature), "T_fuel" (fuel temperature),
+ * "eta_reaction", "eta_nozzle" or "eta_cycle" (efficiency factors)
+ * @param distribution "normal" (a - mean, b - standard deviation, c - truncation in standard deviations),
+ * "uniform" (a - min, b - max) or "triangular" (a - min, b - mode, c - max)
+ * @param units units of pressure or temperature
+ */
+__declspec(dllexport)
+	void monteCarloAddVariable(void* analysisPtr, const char* type, const char* distribution, double a, double b, double c, const char* units);
+
+/**
+ * Sets the ambient pressure of the delivered specific impulse, and the seed of the samples.
+ */
+__declspec(dllexport)
+	void monteCarloSetOptions(void* analysisPtr, double pa, const char* paUnits, unsigned int seed);
+
+/**
+ * Solves the samples and collects the statistics.
+ *
+ * @return number of the samples solved
+ */
+__declspec(dllexport)
+	int monteCarloRun(void* analysisPtr, int samples);
+
+/**
+ * Returns the statistic of the result.
+ *
+ * @param name "Is" (units "m/s", "ft/s" or "s"), "T_c" (temperature units) or "mdot" (mass flow rate units)
+ * @param statistic "mean", "stddev", "min", "max", or the percentile "p<NN>" (e.g. "p5", "p50", "p99")
+ */
+__declspec(dllexport)
+	double monteCarloGetStatistic(void* analysisPtr, const char* name, const char* statistic, const char* units);
+
+/**
+ * Copies the histogram of the result (see monteCarloGetStatistic()).
+ *
+ * @param edges array of size+1 bounds of the bins, or NULL
+ * @param counts array of size numbers of the values in the bins, or NULL
+ * @return number of the bins of the histogram
+ */
+__declspec(dllexport)
+	int monteCarloGetHistogram(void* analysisPtr, const char* name, const char* units, double* edges, int* counts, int size);
+
+//*****************************************************************************
+
+/**
+ * Creates the sensitivity analysis (see SensitivityAnalysis) of the engine around the point given by the configuration.
+ *
+ * @param dataPtr pointer to configuration; must exist as long as the analysis is used
+ * @param threads number of threads; 0 to use all hardware threads
+ */
+__declspec(dllexport)
+	void* sensitivityCreate(void* dataPtr, int threads);
+
+__declspec(dllexport)
+	void sensitivityDelete(void* analysisPtr);
+
+/**
+ * Adds the input; its value is taken from the configuration.
+ *
+ * @param type "O/F", "alpha", "pc", "A/At", "T_ox" (oxidizer temperature) or "T_fuel" (fuel temperature)
+ * @param step step relative to the value of the input; if 0, use default value
+ */
+__declspec(dllexport)
+	void sensitivityAddInput(void* analysisPtr, const char* type, double step);
+
+/**
+ * Solves the base and the perturbed points concurrently, and calculates the derivatives.
+ */
+__declspec(dllexport)
+	bool sensitivityRun(void* analysisPtr);
+
+/**
+ * Returns the derivative of the result by the input (in the order the inputs have been added), in SI units
+ * (specific impulse in m/s, temperature in K, pressure in Pa).
+ *
+ * @param name "Is_v", "Is_opt", "Is_SL", "T_c", "O/F" or "p_e"
+ */
+__declspec(dllexport)
+	double sensitivityGetDerivative(void* analysisPtr, const char* name, int input);
+
+/**
+ * Copies the Jacobian matrix of the results by all the inputs, in SI units.
+ *
+ * @param names array of n names of the results (see sensitivityGetDerivative())
+ * @param jacobian array of n x (number of inputs) derivatives, row-major
+ * @return false if any name is unknown
+ */
+__declspec(dllexport)
+	bool sensitivityGetJacobian(void* analysisPtr, const char** names, int n, double* jacobian);
+
+//*****************************************************************************
+
+/**
+ * Designs n MOC nozzles (see MocDesignSweep) for the chamber of the configuration concurrently, e.g. the candidates
+ * of the outer optimization loop. Parameters of the candidate i are taken from the i-th elements of the arrays;
+ * the arrays of parameters not used by the design modes can be NULL.
+ *
+ * @param modes design modes: 0 - fixed area (Fr, Tw_bar), 1 - fixed length (Le_bar, Tw_bar),
+ * 2 - fixed area and length (Fr, Le_bar), 3 - maximum thrust (Tw_bar); R1 and Rn are used by all the modes
+ * @param Le, Te, Tn_max arrays of n results (length, exit and maximum wall angles); NaN if the candidate could not be designed
+ * @return number of the candidates designed
+ */
+__declspec(dllexport)
+	int mocDesignSweepRun(void* dataPtr, int n, const int* modes, const double* Fr, const double* Le_bar, const double* R1, const double* Rn,
+			const double* Tw_bar, int threads, double* Le, double* Te, double* Tn_max, const char* lengthUnits, const char* angleUnits);
+
+//*****************************************************************************
+
+/**
+ * Creates the engine design pipeline (see EnginePipeline) which re-runs only the stages whose inputs have been changed.
+ *
+ * @param dataPtr pointer to configuration; must exist as long as the pipeline is used
+ * @param applyCorrectionFactors apply performance correction factors
+ */
+__declspec(dllexport)
+	void* pipelineCreate(void* dataPtr, bool applyCorrectionFactors);
+
+__declspec(dllexport)
+	void pipelineDelete(void* pipelinePtr);
+
+/**
+ * Marks the stage and all the downstream stages as changed.
+ *
+ * @param stage "performance", "correction_factors", "chamber" or "nozzle"
+ */
+__declspec(dllexport)
+	void pipelineInvalidate(void* pipelinePtr, const char* stage);
+
+/**
+ * Re-runs the changed stages.
+ *
+ * @return number of the first re-run stage (0 - performance, 1 - correction factors, 2 - chamber, 3 - nozzle),
+ * 4 if nothing has been changed, or -1 in case of error
+ */
+__declspec(dllexport)
+	int pipelineUpdate(void* pipelinePtr, bool optimizePropellant);
+
+/**
+ * Returns the results of the last update; the objects are owned by the pipeline, so they must not be deleted,
+ * and they are not valid after the next update which re-runs the stage.
+ */
+__declspec(dllexport)
+	void* pipelineGetPerformance(void* pipelinePtr);
+
+__declspec(dllexport)
+	void* pipelineGetChamber(void* pipelinePtr);
+
+__declspec(dllexport)
+	void* pipelineGetNozzle(void* pipelinePtr);
+
+//*****************************************************************************
+
+/**
+ * Evaluates the nozzle contours in parallel (see NozzleContourOptimizer) for the exit area ratio of the chamber
+ * of the problem, and finds the Pareto front of nozzle length vs. delivered specific impulse. The delivered specific
+ * impulse is calculated with the correction factors for each contour; the problem is solved again by each thread
+ * from a copy of its configuration.
+ *
+ * @param applyCorrectionFactors if true, apply all the correction factors and size the chamber with them;
+ * otherwise apply the nozzle efficiency only
+ * @param types array of n types of the contours: 0 - parabolic, 1 - MOC
+ * @param l, tn, te arrays of n parameters of parabolic contours: length relative to 15 deg conical nozzle,
+ * initial and exit wall angles (in angleUnits); ignored for MOC contours
+ * @param Le_bar array of n lengths of MOC contours relative to the throat radius; ignored for parabolic contours
+ * @param H array of altitudesNo altitudes (m) averaged with vacuum in the objective, or NULL
+ * @param Le, objective arrays of n results, in lengthUnits and IspUnits; NaN if the contour is not evaluated
+ * @param front array of n, receives the indices of the contours of the Pareto front in the order of increasing length
+ * @return number of the contours of the Pareto front, or -1 in case of error
+ */
+__declspec(dllexport)
+	int nozzleOptimizeContour(void* performancePtr, bool applyCorrectionFactors, int n, const int* types,
+			const double* l, const double* tn, const double* te, const double* Le_bar, const double* H, int altitudesNo,
+			int threads, double* Le, double* objective, int* front, const char* lengthUnits, const char* angleUnits, const char* IspUnits);
+
 //*****************************************************************************
 
 
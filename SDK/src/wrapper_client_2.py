@@ -11,6 +11,7 @@ rpa.performanceGetDeliveredIspH.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ct
 rpa.performanceGetDeliveredIspH.restype = ctypes.c_double;
 rpa.performanceGetDeliveredIsp.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_double, ctypes.c_char_p, ctypes.c_double];
 rpa.performanceGetDeliveredIsp.restype = ctypes.c_double;
+rpa.performanceGetDeliveredIspHArray.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.POINTER(ctypes.c_double), ctypes.c_int, ctypes.c_char_p, ctypes.c_double, ctypes.POINTER(ctypes.c_double)];
 rpa.chamberGetThroatDiameter.argtypes = [ctypes.c_void_p, ctypes.c_char_p];
 rpa.chamberGetThroatDiameter.restype = ctypes.c_double;
 rpa.nozzleGetExitDiameter.restype = ctypes.c_double;
@@ -30,11 +31,14 @@ Isp_vac = rpa.performanceGetDeliveredIsp(performance, "s", 0, "atm", 0);
 
 print "Isp(SL)=%3.2f s, Isp(vac)=%3.2f s" % (Isp_SL, Isp_vac);
 
-# Calculate Isp at given altitudes (m)
+# Calculate Isp at given altitudes (m) in one call
 altitude_list = [0, 3e3, 5e3, 10e3, 20e3, 50e3];
-for H in altitude_list : 
-	Isp = rpa.performanceGetDeliveredIspH(performance, "s", H, "m", 0);
-	print "H=%3.0f km: Isp=%3.2f s" % (H/1000, Isp);
+n = len(altitude_list);
+H_array = (ctypes.c_double * n)(*altitude_list);
+Isp_array = (ctypes.c_double * n)();
+rpa.performanceGetDeliveredIspHArray(performance, "s", H_array, n, "m", 0, Isp_array);
+for i in range(n) : 
+	print "H=%3.0f km: Isp=%3.2f s" % (altitude_list[i]/1000, Isp_array[i]);
 
 # Release created objects
 rpa.performanceDelete(performance);
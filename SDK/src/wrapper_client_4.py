@@ -0,0 +1,60 @@
+import ctypes
+
+# Load CDLL
+rpa = ctypes.CDLL("wrapper.dll");
+
+# Declare used functions
+rpa.configFileLoad.restype = ctypes.c_void_p;
+rpa.sweepCreate.argtypes = [ctypes.c_void_p];
+rpa.sweepCreate.restype = ctypes.c_void_p;
+rpa.sweepAddAxis.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.POINTER(ctypes.c_double), ctypes.c_int, ctypes.c_char_p];
+rpa.sweepRun.argtypes = [ctypes.c_void_p, ctypes.c_int];
+rpa.sweepGetPointsNo.argtypes = [ctypes.c_void_p];
+rpa.sweepGetIndex.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int];
+rpa.sweepIsSolved.argtypes = [ctypes.c_void_p, ctypes.c_int];
+rpa.sweepIsSolved.restype = ctypes.c_bool;
+rpa.sweepGetValue.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_char_p, ctypes.c_char_p];
+rpa.sweepGetValue.restype = ctypes.c_double;
+rpa.sweepDelete.argtypes = [ctypes.c_void_p];
+rpa.configFileDelete.argtypes = [ctypes.c_void_p];
+
+def axis(values):
+	return (ctypes.c_double * len(values))(*values);
+
+# Initialize RPA
+rpa.initialize(1);
+
+conf = rpa.configFileLoad("examples\\RD-275.cfg");
+
+# Grid of O/F ratio, chamber pressure and nozzle exit area ratio
+r = [2.4, 2.6, 2.8, 3.0, 3.2, 3.4];
+pc = [5, 10, 15, 20];
+Aexit = [20, 26, 40, 60];
+
+sweep = rpa.sweepCreate(conf);
+rpa.sweepAddAxis(sweep, "O/F", axis(r), len(r), "");
+rpa.sweepAddAxis(sweep, "pc", axis(pc), len(pc), "MPa");
+rpa.sweepAddAxis(sweep, "A/At", axis(Aexit), len(Aexit), "");
+
+# Solve all the points, using all hardware threads
+rpa.sweepRun(sweep, 0);
+
+print "#%4s %6s %5s %8s %8s %8s" % ("r", "pc,MPa", "A/At", "Is_v,s", "Is_opt,s", "Is_sl,s");
+
+for point in range(rpa.sweepGetPointsNo(sweep)):
+	if not rpa.sweepIsSolved(sweep, point):
+		continue;
+	print " %4.2f %6.2f %5.1f %8.2f %8.2f %8.2f" % (
+		r[rpa.sweepGetIndex(sweep, point, 0)],
+		pc[rpa.sweepGetIndex(sweep, point, 1)],
+		Aexit[rpa.sweepGetIndex(sweep, point, 2)],
+		rpa.sweepGetValue(sweep, point, "Is_v", "s"),
+		rpa.sweepGetValue(sweep, point, "Is_opt", "s"),
+		rpa.sweepGetValue(sweep, point, "Is_SL", "s"));
+
+# Release created objects
+rpa.sweepDelete(sweep);
+rpa.configFileDelete(conf);
+
+# Finalize RPA
+rpa.finalize();
\ No newline at end of file
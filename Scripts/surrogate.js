@@ -0,0 +1,78 @@
+/***************************************************
+ RPA - Tool for Rocket Propulsion Analysis
+ Copyright 2009-2014 Alexander Ponomarenko
+ Please contact author <contact@propulsion-analysis.com> 
+ or visit http://www.propulsion-analysis.com
+ if you need additional information or have any questions.
+ 
+ surrogate.js
+ 
+ Evaluation of the surrogate model fitted by SurrogateBuilder (SDK/src/surrogate.hpp)
+ or by surrogateBuilderRun() of the wrapper, and written with the variable name, e.g.
+ surrogateWrite(model, "RD-275.surrogate.js", "model"):
+ 
+   load("resources/scripts/surrogate.js");
+   load("RD-275.surrogate.js");
+   
+   s = Surrogate(model);
+   // Variables in the order of model.variables; pressure in Pa, temperature in K
+   Is_v = s.get([2.6, 15e6, 30], "Is_v");	// m/s
+ 
+****************************************************/
+
+Surrogate = function (model) {
+	return {
+		model : model,
+
+		// Returns object with all the results (model.outputs) at the point x
+		evaluate : function (x) {
+			var m = this.model;
+			var n = m.variables.length;
+
+			// Powers of the variables scaled to [-1, 1]
+			var p = [];
+			for (var v=0; v<n; ++v) {
+				var t = m.max[v]>m.min[v] ? 2*(x[v] - m.min[v])/(m.max[v] - m.min[v]) - 1 : 0;
+				p[v] = [1];
+				for (var k=1; k<=m.degree; ++k) {
+					p[v][k] = p[v][k-1]*t;
+				}
+			}
+
+			var values = [];
+			for (var i=0; i<m.outputs.length; ++i) {
+				values[i] = 0;
+			}
+			for (var term=0; term<m.powers.length; ++term) {
+				var b = 1;
+				for (var v=0; v<n; ++v) {
+					b *= p[v][m.powers[term][v]];
+				}
+				for (var i=0; i<m.outputs.length; ++i) {
+					values[i] += m.coefficients[term][i]*b;
+				}
+			}
+
+			var result = {};
+			for (var i=0; i<m.outputs.length; ++i) {
+				result[m.outputs[i]] = values[i];
+			}
+			return result;
+		},
+
+		// Returns one result ("Is_v", "Is_opt", "Is_SL", "T_c", "O/F" or "p_e") at the point x
+		get : function (x, name) {
+			return this.evaluate(x)[name];
+		},
+
+		// Returns maximum validation error of the result, relative to its maximum absolute value
+		getError : function (name) {
+			for (var i=0; i<this.model.outputs.length; ++i) {
+				if (this.model.outputs[i]==name) {
+					return this.model.errors[i];
+				}
+			}
+			return undefined;
+		}
+	};
+};
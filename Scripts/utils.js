@@ -35,7 +35,7 @@ Utils = {
 			if (con.x.length<2) {
 			  print("Increase number of points");
 			} else {
-			  print(con1.x.length);
+			  print(con.x.length);
 			}
 		}	
 	},
@@ -158,6 +158,109 @@ Utils = {
 		}
 
 		return solver;
+	},
+
+	/**
+	 * Solves the performance problem on the grid of parameters, in the same way as nested_analysis2.js.
+	 *
+	 * conf - loaded configuration file
+	 * axes - array of axes, each one {type: "O/F" | "pc" | "A/At", values: [...], unit: "MPa"}
+	 *
+	 * Returns array of points in row-major order (the first axis is the outermost one);
+	 * each point is {x: [values of axes], Is_v, Is_opt, Is_SL} with specific impulse in seconds.
+	 * Property "solves" of the returned array is the number of solved combustion chamber problems.
+	 *
+	 * The area ratio axis is iterated innermost, so that the chamber is solved once for all the area ratios,
+	 * and only nozzle sections are solved for them.
+	 *
+	 * This is the serial version of the sweep; for large grids use the parallel sweep of the SDK (sweep.hpp).
+	 */
+	sweep : function (conf, axes) {
+		var p = Performance(conf);
+		var points = [];
+		var x = [];
+		var ix = [];
+		var solves = 0;
+
+		// Axes in the order of iteration: area ratio axis last
+		var order = [];
+		for (var a=0; a<axes.length; ++a) {
+			if ("A/At"!=axes[a].type) {
+				order.push(a);
+			}
+		}
+		for (var a=0; a<axes.length; ++a) {
+			if ("A/At"==axes[a].type) {
+				order.push(a);
+			}
+		}
+
+		var chamberSolved = false;
+
+		var solvePoint = function () {
+			var Aexit = null;
+			for (var a=0; a<axes.length; ++a) {
+				if ("A/At"==axes[a].type) {
+					Aexit = x[a];
+				}
+			}
+
+			if (!chamberSolved) {
+				for (var a=0; a<axes.length; ++a) {
+					if ("O/F"==axes[a].type) {
+						p.getData().getPropellant().setRatio(x[a], "O/F");
+					} else if ("pc"==axes[a].type) {
+						p.getData().getCombustionChamberConditions().setPressure(x[a], axes[a].unit ? axes[a].unit : "MPa");
+					}
+				}
+
+				// Prepare the solver for restart.
+				if (solves>0) {
+					p.clearForRestart();
+				}
+
+				p.solve();
+				++solves;
+				chamberSolved = true;
+			}
+
+			var s = Aexit ? p.solveNozzleSection(Aexit, "A/At") : p.getNozzleExitSection();
+
+			// Row-major index of the point
+			var index = 0;
+			for (var a=0; a<axes.length; ++a) {
+				index = index*axes[a].values.length + ix[a];
+			}
+
+			points[index] = {
+				x: x.slice(0),
+				Is_v: s.getIs_v("s"),
+				Is_opt: s.getIs("s"),
+				Is_SL: s.getIs_H(1, "atm", "s")
+			};
+		};
+
+		var loop = function (k) {
+			if (k==order.length) {
+				solvePoint();
+				return;
+			}
+			var a = order[k];
+			for (var i=0; i<axes[a].values.length; ++i) {
+				x[a] = axes[a].values[i];
+				ix[a] = i;
+				if ("A/At"!=axes[a].type) {
+					chamberSolved = false;
+				}
+				loop(k + 1);
+			}
+		};
+
+		loop(0);
+
+		points.solves = solves;
+
+		return points;
 	}
-	
+
 };